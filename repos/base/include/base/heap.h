@@ -89,12 +89,41 @@ class Genode::Heap : public Allocator
 					ram_alloc = ram, region_map = rm; }
 		};
 
-		Lock                           _lock { };
-		Reconstructible<Allocator_avl> _alloc;        /* local allocator    */
-		Dataspace_pool                 _ds_pool;      /* list of dataspaces */
-		size_t                         _quota_limit { 0 };
-		size_t                         _quota_used  { 0 };
-		size_t                         _chunk_size  { 0 };
+		/**
+		 * AVL allocator that is able to reveal the block of an address
+		 */
+		struct Local_allocator : Allocator_avl
+		{
+			Local_allocator(Allocator *md_alloc) : Allocator_avl(md_alloc) { }
+
+			/**
+			 * Return start of the used block containing 'addr', or 0
+			 */
+			addr_t used_block_addr(void const *addr) const
+			{
+				Allocator_avl_base::Block const *b = _find_by_address((addr_t)addr);
+				return (b && b->used()) ? b->addr() : 0;
+			}
+		};
+
+		/*
+		 * Size-class front end, defined in 'heap.cc'
+		 */
+		class Size_classes;
+
+		Lock                             _lock { };
+		Reconstructible<Local_allocator> _alloc;        /* local allocator    */
+		Dataspace_pool                   _ds_pool;      /* list of dataspaces */
+		size_t                           _quota_limit { 0 };
+		size_t                           _quota_used  { 0 };
+		size_t                           _chunk_size  { 0 };
+		Size_classes                    *_size_classes { nullptr };
+
+		/*
+		 * Noncopyable
+		 */
+		Heap(Heap const &);
+		Heap &operator = (Heap const &);
 
 		/**
 		 * Allocate a new dataspace of the specified size
@@ -151,6 +180,25 @@ class Genode::Heap : public Allocator
 		void reassign_resources(Ram_allocator *ram, Region_map *rm) {
 			_ds_pool.reassign_resources(ram, rm); }
 
+		/**
+		 * Serve small allocations from per-size-class slabs
+		 *
+		 * Once enabled, allocations of up to 'MAX_SIZE_CLASS' bytes are
+		 * taken from free lists of fixed-size slab entries instead of
+		 * searching the AVL tree of the heap. This lowers the costs and the
+		 * fragmentation for components that allocate many small and
+		 * short-lived objects. The slab blocks are allocated from the heap
+		 * and are thereby accounted as consumed quota.
+		 *
+		 * Blocks served by the size classes are 16-byte aligned like all
+		 * other heap blocks. The front end cannot be disabled once enabled.
+		 *
+		 * \return  false if the front end could not be allocated
+		 */
+		bool enable_size_classes();
+
+		enum { MAX_SIZE_CLASS = 512 };
+
 
 		/*************************
 		 ** Allocator interface **
@@ -0,0 +1,116 @@
+/*
+ * \brief  Shared-memory ring of LOG output
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__LOG_SESSION__LOG_RING_H_
+#define _INCLUDE__LOG_SESSION__LOG_RING_H_
+
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
+#include <util/string.h>
+
+namespace Genode { struct Log_ring; }
+
+
+/**
+ * Ring of characters written by the client and consumed by the server
+ *
+ * The ring is located at the start of the dataspace obtained via
+ * 'Log_session::ring_dataspace' and fills exactly one page. The client is
+ * the only writer of 'head', the server is the only writer of 'tail'. Both
+ * are offsets into 'data'. One character always stays unused, which
+ * distinguishes a full ring from an empty one. The client adds whole
+ * strings only. If there is not enough space left, it falls back to the
+ * 'write' RPC function, which makes the server consume the ring before
+ * printing the string.
+ *
+ * The client notifies the server only if the ring has not been notified
+ * since the server started consuming it. The 'wakeup' flag is changed by
+ * both sides via 'cmpxchg', which is a full memory barrier. Hence, either
+ * the client notifies the server or the server sees the new head.
+ */
+struct Genode::Log_ring
+{
+	enum { CAPACITY = 4096 - 3*sizeof(unsigned) };
+
+	unsigned volatile head;
+	unsigned volatile tail;
+	int      volatile wakeup;
+
+	char data[CAPACITY];
+
+	/**
+	 * Add string, called by the client
+	 *
+	 * \return false if the ring has not enough space left
+	 */
+	bool write(char const *s, size_t len)
+	{
+		unsigned const h = head, t = tail;
+
+		size_t const used = (h + CAPACITY - t) % CAPACITY;
+
+		if (h >= CAPACITY || t >= CAPACITY || len > CAPACITY - 1 - used)
+			return false;
+
+		size_t const n = min(len, (size_t)(CAPACITY - h));
+
+		memcpy(data + h, s, n);
+		memcpy(data, s + n, len - n);
+
+		/* make the characters visible before the new head */
+		memory_barrier();
+		head = (unsigned)((h + len) % CAPACITY);
+		return true;
+	}
+
+	/**
+	 * Return true if the client must notify the server, called after 'write'
+	 */
+	bool wakeup_needed() { return cmpxchg(&wakeup, 0, 1); }
+
+	/**
+	 * Consume characters, called by the server
+	 *
+	 * The functor is called with a pointer and length of each contiguous
+	 * chunk, which are at most two per call. An out-of-range head, which
+	 * only a misbehaving client can cause, leaves the ring untouched.
+	 */
+	template <typename FN>
+	void consume(FN const &fn)
+	{
+		/* request a notification for characters added from now on */
+		cmpxchg(&wakeup, 1, 0);
+
+		unsigned const h = head;
+		memory_barrier();
+
+		if (h >= CAPACITY)
+			return;
+
+		unsigned t = tail % CAPACITY;
+
+		if (t > h) {
+			fn(data + t, CAPACITY - t);
+			t = 0;
+		}
+
+		if (t < h)
+			fn(data + t, h - t);
+
+		/* release the characters only after reading them */
+		memory_barrier();
+		tail = h;
+	}
+};
+
+#endif /* _INCLUDE__LOG_SESSION__LOG_RING_H_ */
@@ -17,6 +17,8 @@
 #include <base/capability.h>
 #include <base/stdint.h>
 #include <base/rpc_args.h>
+#include <base/signal.h>
+#include <dataspace/capability.h>
 #include <session/session.h>
 
 namespace Genode {
@@ -39,6 +41,13 @@ struct Genode::Log_session : Session
 	 */
 	enum { CAP_QUOTA = 2 };
 
+	/*
+	 * The ring consumes a dataspace capability and a signal-context
+	 * capability. A client donates them via a session upgrade before
+	 * requesting the ring.
+	 */
+	enum { RING_CAP_QUOTA = 2 };
+
 	typedef Log_session_client Client;
 
 	virtual ~Log_session() { }
@@ -55,13 +64,36 @@ struct Genode::Log_session : Session
 	 */
 	virtual size_t write(String const &string) = 0;
 
+	/**
+	 * Request dataspace containing the ring of LOG output
+	 *
+	 * The dataspace starts with a 'Log_ring'. Instead of calling 'write'
+	 * for each string, the client adds the strings to the ring and notifies
+	 * the server via the signal handler returned by 'ring_sigh'. The server
+	 * consumes the ring before executing a 'write' call, which preserves
+	 * the order of the output if the client falls back to 'write'.
+	 *
+	 * \return invalid capability if the server does not provide a ring or
+	 *         the session quota lacks 'RING_CAP_QUOTA'
+	 */
+	virtual Dataspace_capability ring_dataspace() {
+		return Dataspace_capability(); }
+
+	/**
+	 * Request signal handler for notifying the server about new output
+	 */
+	virtual Signal_context_capability ring_sigh() {
+		return Signal_context_capability(); }
+
 
 	/*********************
 	 ** RPC declaration **
 	 *********************/
 
 	GENODE_RPC(Rpc_write, size_t, write, String const &);
-	GENODE_RPC_INTERFACE(Rpc_write);
+	GENODE_RPC(Rpc_ring_dataspace, Dataspace_capability, ring_dataspace);
+	GENODE_RPC(Rpc_ring_sigh, Signal_context_capability, ring_sigh);
+	GENODE_RPC_INTERFACE(Rpc_write, Rpc_ring_dataspace, Rpc_ring_sigh);
 };
 
 #endif /* _INCLUDE__LOG_SESSION__LOG_SESSION_H_ */
@@ -17,6 +17,7 @@
 #include <util/string.h>
 #include <util/print_lines.h>
 #include <base/snprintf.h>
+#include <base/allocator.h>
 
 namespace Genode { class Xml_generator; }
 
@@ -30,6 +31,56 @@ class Genode::Xml_generator
 		 */
 		class Buffer_exceeded { };
 
+		/**
+		 * Backing store for generating XML into a growing buffer
+		 *
+		 * The backing store outlives the generators using it. So a buffer
+		 * that was once enlarged is reused by subsequent generators.
+		 */
+		class Backing_store
+		{
+			private:
+
+				friend class Xml_generator;
+
+				/*
+				 * Noncopyable
+				 */
+				Backing_store(Backing_store const &);
+				Backing_store &operator = (Backing_store const &);
+
+				Allocator &_alloc;
+				char      *_base     = nullptr;
+				size_t     _capacity = 0;
+
+				/**
+				 * Replace buffer by a larger one, preserving 'used' bytes
+				 *
+				 * \throw Out_of_memory  the current buffer stays intact
+				 */
+				void _grow(size_t capacity, size_t used)
+				{
+					char * const base = (char *)_alloc.alloc(capacity);
+					memcpy(base, _base, used);
+
+					if (_base)
+						_alloc.free(_base, _capacity);
+
+					_base     = base;
+					_capacity = capacity;
+				}
+
+			public:
+
+				Backing_store(Allocator &alloc) : _alloc(alloc) { }
+
+				~Backing_store()
+				{
+					if (_base)
+						_alloc.free(_base, _capacity);
+				}
+		};
+
 	private:
 
 		/**
@@ -145,6 +196,25 @@ class Genode::Xml_generator
 				 */
 				size_t used() const { return _used; }
 
+				/**
+				 * Return number of bytes that can still be appended
+				 */
+				size_t avail() const { return _capacity - _used; }
+
+				/**
+				 * Move buffer to a new backing store
+				 *
+				 * All buffers of a generator end at the end of the backing
+				 * store. Hence, the capacity follows from the buffer's offset
+				 * within the backing store.
+				 */
+				void rebase(char const *old_base, char *new_base, size_t size)
+				{
+					size_t const offset = _dst - old_base;
+					_dst      = new_base + offset;
+					_capacity = size - offset;
+				}
+
 				void discard_trailing_whitespace()
 				{
 					for (; _used > 0 && is_whitespace(_dst[_used - 1]); _used--);
@@ -207,6 +277,17 @@ class Genode::Xml_generator
 
 			public:
 
+				size_t avail() const { return _out_buffer.avail(); }
+
+				/**
+				 * Move buffers of node and its parents to new backing store
+				 */
+				void rebase(char const *old_base, char *new_base, size_t size)
+				{
+					for (Node *n = this; n; n = n->_parent_node)
+						n->_out_buffer.rebase(old_base, new_base, size);
+				}
+
 				void insert_attribute(char const *name, char const *value)
 				{
 					/* ' ' + name + '=' + '"' + value + '"' */
@@ -257,6 +338,9 @@ class Genode::Xml_generator
 					 */
 					func();
 
+					/* '\n' + indent + '</' + name + '>' + '\0' */
+					xml._ensure(1 + _indent_level + 2 + strlen(name) + 2);
+
 					xml._curr_node = _parent_node;
 					xml._curr_indent--;
 
@@ -281,53 +365,148 @@ class Genode::Xml_generator
 				}
 		};
 
+		/*
+		 * Backing store, provided by '_store' in growable mode
+		 */
+		Backing_store *_store    = nullptr;
+		char          *_base     = nullptr;
+		size_t         _capacity = 0;
+
 		Out_buffer _out_buffer;
 		Node      *_curr_node   = 0;
 		unsigned   _curr_indent = 0;
 
+		/*
+		 * Noncopyable
+		 */
+		Xml_generator(Xml_generator const &);
+		Xml_generator &operator = (Xml_generator const &);
+
+		/**
+		 * Make sure that 'len' bytes can be appended to the current node
+		 *
+		 * In growable mode, the backing store is replaced by a larger one
+		 * and the buffers of all nodes that are currently under
+		 * construction are moved to the new backing store. Otherwise, an
+		 * insufficient capacity is detected when appending to the buffer.
+		 */
+		void _ensure(size_t len)
+		{
+			size_t const avail = _curr_node ? _curr_node->avail()
+			                                : _out_buffer.avail();
+			if (!_store || avail >= len)
+				return;
+
+			size_t capacity = 2*_capacity;
+			while (capacity - _capacity + avail < len)
+				capacity *= 2;
+
+			char const * const old_base = _base;
+			_store->_grow(capacity, _capacity);
+
+			_base     = _store->_base;
+			_capacity = _store->_capacity;
+
+			_out_buffer.rebase(old_base, _base, _capacity);
+			if (_curr_node)
+				_curr_node->rebase(old_base, _base, _capacity);
+		}
+
+		static char *_prepared(Backing_store &store, size_t capacity)
+		{
+			capacity = max(capacity, (size_t)64);
+			if (store._capacity < capacity)
+				store._grow(capacity, 0);
+
+			return store._base;
+		}
+
+		template <typename FUNC>
+		void _generate(char const *name, FUNC const &func)
+		{
+			node(name, func);
+			_ensure(1);
+			_out_buffer.append('\n');
+		}
+
 	public:
 
+		/**
+		 * Constructor for generating XML into a fixed-size buffer
+		 *
+		 * \throw Buffer_exceeded
+		 */
 		template <typename FUNC>
 		Xml_generator(char *dst, size_t dst_len,
 		              char const *name, FUNC const &func)
 		:
-			_out_buffer(dst, dst_len)
+			_base(dst), _capacity(dst_len), _out_buffer(dst, dst_len)
 		{
-			if (dst) {
-				node(name, func);
-				_out_buffer.append('\n');
-			}
+			if (dst)
+				_generate(name, func);
+		}
+
+		/**
+		 * Constructor for generating XML into a growing buffer
+		 *
+		 * \param store     backing store
+		 * \param capacity  minimum initial size of the backing store
+		 *
+		 * The backing store is enlarged whenever the generated content
+		 * would exceed it. So the content is generated in a single pass
+		 * and 'Buffer_exceeded' is never thrown. The result can be
+		 * obtained via 'content' until the backing store is used by
+		 * another generator.
+		 *
+		 * \throw Out_of_memory  backing store could not be enlarged
+		 */
+		template <typename FUNC>
+		Xml_generator(Backing_store &store, size_t capacity,
+		              char const *name, FUNC const &func)
+		:
+			_store(&store),
+			_base(_prepared(store, capacity)),
+			_capacity(store._capacity),
+			_out_buffer(_base, _capacity)
+		{
+			_generate(name, func);
 		}
 
 		template <typename FUNC>
 		void node(char const *name, FUNC const &func = [] () { } )
 		{
+			/* indent + '<' + name + '/>', parent content '>' + '\n' */
+			_ensure(_curr_indent + 1 + strlen(name) + 2 + 2);
+
 			Node(*this, name, func);
 		}
 
-		void node(char const *name) { Node(*this, name, [] () { }); }
+		void node(char const *name) { node(name, [] () { }); }
 
 		void attribute(char const *name, char const *str)
 		{
+			/* ' ' + name + '=' + '"' + value + '"' */
+			_ensure(1 + strlen(name) + 2 + strlen(str) + 1);
+
 			_curr_node->insert_attribute(name, str);
 		}
 
 		template <size_t N>
 		void attribute(char const *name, String<N> const &str)
 		{
-			_curr_node->insert_attribute(name, str.string());
+			attribute(name, str.string());
 		}
 
 		void attribute(char const *name, bool value)
 		{
-			_curr_node->insert_attribute(name, value ? "true" : "false");
+			attribute(name, value ? "true" : "false");
 		}
 
 		void attribute(char const *name, long long value)
 		{
 			char buf[64];
 			Genode::snprintf(buf, sizeof(buf), "%lld", value);
-			_curr_node->insert_attribute(name, buf);
+			attribute(name, buf);
 		}
 
 		void attribute(char const *name, long value)
@@ -344,7 +523,7 @@ class Genode::Xml_generator
 		{
 			char buf[64];
 			Genode::snprintf(buf, sizeof(buf), "%llu", value);
-			_curr_node->insert_attribute(name, buf);
+			attribute(name, buf);
 		}
 
 		void attribute(char const *name, unsigned long value)
@@ -360,7 +539,7 @@ class Genode::Xml_generator
 		void attribute(char const *name, double value)
 		{
 			String<64> buf(value);
-			_curr_node->insert_attribute(name, buf.string());
+			attribute(name, buf.string());
 		}
 
 		/**
@@ -370,7 +549,12 @@ class Genode::Xml_generator
 		 */
 		void append(char const *str, size_t str_len = ~0UL)
 		{
-			_curr_node->append(str, str_len == ~0UL ? strlen(str) : str_len);
+			size_t const len = (str_len == ~0UL) ? strlen(str) : str_len;
+
+			/* content may be preceded by '>' */
+			_ensure(len + 1);
+
+			_curr_node->append(str, len);
 		}
 
 		/**
@@ -380,10 +564,20 @@ class Genode::Xml_generator
 		 */
 		void append_sanitized(char const *str, size_t str_len = ~0UL)
 		{
-			_curr_node->append_sanitized(str, str_len == ~0UL ? strlen(str) : str_len);
+			size_t const len = (str_len == ~0UL) ? strlen(str) : str_len;
+
+			/* a sanitized character takes up to 6 bytes, e.g., '&#x00;' */
+			_ensure(6*len + 1);
+
+			_curr_node->append_sanitized(str, len);
 		}
 
 		size_t used() const { return _out_buffer.used(); }
+
+		/**
+		 * Return pointer to the generated content
+		 */
+		char const *content() const { return _base; }
 };
 
 #endif /* _INCLUDE__UTIL__XML_GENERATOR_H_ */
@@ -0,0 +1,452 @@
+/*
+ * \brief  Pre-indexed representation of XML data
+ * \author agent
+ * \date   2026-10-19
+ *
+ * In contrast to 'Xml_node', which re-tokenizes the XML data on each access,
+ * an 'Xml_index' parses the data once and records the positions of all nodes
+ * and attributes in a single allocation. The nodes of the index are accessed
+ * via 'Indexed_xml_node', which provides the read API of 'Xml_node'. Indexed
+ * access to sub nodes and the lookup of attributes thereby become independent
+ * of the size of the XML data, which pays off for large documents like
+ * state reports.
+ *
+ * The index is stricter than 'Xml_node' in that the whole document must be
+ * well-formed. Each end tag must match the start tag of its node. Unlike for
+ * 'Xml_node', the 'addr()' of a node always refers to its start tag, not to
+ * preceding whitespace or comments.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__UTIL__XML_INDEX_H_
+#define _INCLUDE__UTIL__XML_INDEX_H_
+
+#include <util/xml_node.h>
+#include <base/allocator.h>
+
+namespace Genode {
+	class Xml_index;
+	class Indexed_xml_node;
+}
+
+
+class Genode::Xml_index
+{
+	private:
+
+		friend class Indexed_xml_node;
+
+		typedef Xml_node::Tag     Tag;
+		typedef Xml_node::Comment Comment;
+		typedef Xml_node::Token   Token;
+
+		enum { INVALID = ~0U };
+
+		/*
+		 * Positions are stored as offsets relative to '_base'
+		 */
+		struct Node
+		{
+			unsigned start;          /* start of start tag             */
+			unsigned content;        /* first character of content     */
+			unsigned content_end;    /* start of end tag               */
+			unsigned end;            /* character after end tag        */
+			unsigned name, name_len; /* node type                      */
+			unsigned parent;
+			unsigned first_child;    /* index into '_children' array   */
+			unsigned num_sub_nodes;
+			unsigned index;          /* position within parent         */
+			unsigned first_attr;
+			unsigned num_attrs;
+		};
+
+		struct Attr { unsigned name, name_len; };
+
+		Allocator &_alloc;
+
+		char const * const _base;
+		size_t       const _len;
+
+		/*
+		 * Upper bounds of the number of nodes and attributes, used for
+		 * dimensioning the arena
+		 */
+		unsigned const _max_nodes = _count('<');
+		unsigned const _max_attrs = _count('=');
+
+		size_t const _arena_size = _max_nodes*(sizeof(Node) + sizeof(unsigned))
+		                         + _max_attrs*sizeof(Attr);
+
+		void * const _arena = _alloc.alloc(_arena_size);
+
+		Node     * const _nodes    = (Node *)_arena;
+		Attr     * const _attrs    = (Attr *)(_nodes + _max_nodes);
+		unsigned * const _children = (unsigned *)(_attrs + _max_attrs);
+
+		unsigned _num_nodes = 0;
+		unsigned _num_attrs = 0;
+
+		unsigned _count(char c) const
+		{
+			unsigned n = 0;
+			for (size_t i = 0; i < _len && _base[i]; i++)
+				n += (_base[i] == c);
+			return n;
+		}
+
+		unsigned _offset(char const *s) const { return (unsigned)(s - _base); }
+
+		unsigned _add_node(Tag const &tag, unsigned parent)
+		{
+			if (_num_nodes == _max_nodes)
+				throw Xml_node::Invalid_syntax();
+
+			unsigned const idx = _num_nodes++;
+			Node &node = _nodes[idx];
+
+			node.start         = _offset(tag.token().start());
+			node.content       = _offset(tag.next_token().start());
+			node.content_end   = node.content;
+			node.end           = node.content;
+			node.name          = _offset(tag.name().start());
+			node.name_len      = (unsigned)tag.name().len();
+			node.parent        = parent;
+			node.first_child   = 0;
+			node.num_sub_nodes = 0;
+			node.index         = 0;
+			node.first_attr    = _num_attrs;
+			node.num_attrs     = 0;
+
+			if (parent != INVALID)
+				node.index = _nodes[parent].num_sub_nodes++;
+
+			try {
+				for (Xml_attribute a = tag.attribute(); ; a = a._next()) {
+					if (_num_attrs == _max_attrs)
+						throw Xml_node::Invalid_syntax();
+
+					_attrs[_num_attrs++] = Attr { _offset(a._name.start()),
+					                              (unsigned)a._name.len() };
+					node.num_attrs++;
+				}
+			} catch (Xml_attribute::Nonexistent_attribute) { }
+
+			return idx;
+		}
+
+		/**
+		 * Parse XML data in one pass
+		 *
+		 * \throw Xml_node::Invalid_syntax
+		 */
+		void _parse()
+		{
+			Token token = Xml_node::skip_non_tag_characters(Token(_base, _len));
+
+			Tag const root_tag(token);
+			if (!root_tag.node())
+				throw Xml_node::Invalid_syntax();
+
+			unsigned curr = _add_node(root_tag, INVALID);
+			token = root_tag.next_token();
+
+			if (root_tag.type() == Tag::EMPTY)
+				curr = INVALID;
+
+			while (curr != INVALID) {
+
+				if (token.type() == Token::END)
+					throw Xml_node::Invalid_syntax();
+
+				Comment const comment(token);
+				if (comment.valid()) {
+					token = comment.next_token();
+					continue;
+				}
+
+				Tag const tag(token);
+				if (tag.type() == Tag::INVALID) {
+					token = token.next();
+					continue;
+				}
+
+				if (tag.node()) {
+					unsigned const idx = _add_node(tag, curr);
+					if (tag.type() == Tag::START)
+						curr = idx;
+					token = tag.next_token();
+					continue;
+				}
+
+				/* end tag must match the start tag of the current node */
+				Node &node = _nodes[curr];
+				if (node.name_len != tag.name().len()
+				 || strcmp(_base + node.name, tag.name().start(), node.name_len))
+					throw Xml_node::Invalid_syntax();
+
+				node.content_end = _offset(tag.token().start());
+				node.end         = _offset(tag.next_token().start());
+
+				curr  = node.parent;
+				token = tag.next_token();
+			}
+
+			/* arrange the sub nodes of each node contiguously */
+			unsigned slot = 0;
+			for (unsigned i = 0; i < _num_nodes; i++) {
+				_nodes[i].first_child = slot;
+				slot += _nodes[i].num_sub_nodes;
+			}
+			for (unsigned i = 1; i < _num_nodes; i++) {
+				Node const &node = _nodes[i];
+				_children[_nodes[node.parent].first_child + node.index] = i;
+			}
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Xml_index(Xml_index const &);
+		Xml_index &operator = (Xml_index const &);
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param alloc  allocator used for the index
+		 * \param base   XML data, must outlive the index
+		 * \param len    maximum length of the XML data
+		 *
+		 * \throw Xml_node::Invalid_syntax
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 */
+		Xml_index(Allocator &alloc, char const *base, size_t len)
+		:
+			_alloc(alloc), _base(base), _len(len)
+		{
+			try { _parse(); }
+			catch (...) {
+				_alloc.free(_arena, _arena_size);
+				throw;
+			}
+		}
+
+		~Xml_index() { _alloc.free(_arena, _arena_size); }
+
+		/**
+		 * Return top-level node of the document
+		 */
+		inline Indexed_xml_node node() const;
+
+		/**
+		 * Return number of bytes consumed by the index
+		 */
+		size_t size() const { return _arena_size; }
+};
+
+
+class Genode::Indexed_xml_node
+{
+	private:
+
+		friend class Xml_index;
+
+		typedef Xml_index::Node Node;
+		typedef Xml_index::Attr Attr;
+
+		Xml_index const *_index;
+		unsigned         _idx;
+
+		Node const &_node() const { return _index->_nodes[_idx]; }
+
+		char const *_at(unsigned offset) const { return _index->_base + offset; }
+
+		Indexed_xml_node(Xml_index const &index, unsigned idx)
+		: _index(&index), _idx(idx) { }
+
+		Xml_attribute _attribute(Attr const &attr) const
+		{
+			size_t const max_len = _index->_len - attr.name;
+			return Xml_attribute(Xml_attribute::Token(_at(attr.name), max_len));
+		}
+
+	public:
+
+		typedef Xml_node::Nonexistent_sub_node  Nonexistent_sub_node;
+		typedef Xml_node::Nonexistent_attribute Nonexistent_attribute;
+		typedef Xml_node::Type                  Type;
+
+		/**
+		 * Return node as 'Xml_node', e.g., for passing it to existing code
+		 */
+		Xml_node xml_node() const { return Xml_node(addr(), size()); }
+
+		void type_name(char *dst, size_t max_len) const {
+			strncpy(dst, _at(_node().name), min(max_len, (size_t)_node().name_len + 1)); }
+
+		Type type() const {
+			return Type(Cstring(_at(_node().name), _node().name_len)); }
+
+		bool has_type(char const *type) const {
+			return strlen(type) == _node().name_len
+			    && !strcmp(type, _at(_node().name), _node().name_len); }
+
+		char const *addr() const { return _at(_node().start); }
+
+		size_t size() const { return _node().end - _node().start; }
+
+		char const *content_base() const { return _at(_node().content); }
+
+		size_t content_size() const { return _node().content_end - _node().content; }
+
+		void value(char *dst, size_t max_len) const {
+			strncpy(dst, content_base(), min(content_size() + 1, max_len)); }
+
+		template <typename T>
+		bool value(T *out) const {
+			return ascii_to(content_base(), *out) == content_size(); }
+
+		size_t decoded_content(char *dst, size_t dst_len) const {
+			return xml_node().decoded_content(dst, dst_len); }
+
+		template <typename STRING>
+		STRING decoded_content() const {
+			return xml_node().decoded_content<STRING>(); }
+
+		size_t num_sub_nodes() const { return _node().num_sub_nodes; }
+
+		/**
+		 * Return sub node with specified index
+		 *
+		 * \throw Nonexistent_sub_node
+		 */
+		Indexed_xml_node sub_node(unsigned idx = 0U) const
+		{
+			if (idx >= _node().num_sub_nodes)
+				throw Nonexistent_sub_node();
+
+			return Indexed_xml_node(*_index,
+			                        _index->_children[_node().first_child + idx]);
+		}
+
+		/**
+		 * Return first sub node that matches the specified type
+		 *
+		 * \throw Nonexistent_sub_node
+		 */
+		Indexed_xml_node sub_node(char const *type) const
+		{
+			for (unsigned i = 0; i < _node().num_sub_nodes; i++) {
+				Indexed_xml_node const node = sub_node(i);
+				if (node.has_type(type))
+					return node;
+			}
+			throw Nonexistent_sub_node();
+		}
+
+		bool has_sub_node(char const *type) const
+		{
+			try { sub_node(type); return true; } catch (...) { }
+			return false;
+		}
+
+		/**
+		 * Return node following the current one
+		 *
+		 * \throw Nonexistent_sub_node
+		 */
+		Indexed_xml_node next() const
+		{
+			if (_node().parent == Xml_index::INVALID)
+				throw Nonexistent_sub_node();
+
+			return Indexed_xml_node(*_index, _node().parent).sub_node(_node().index + 1);
+		}
+
+		Indexed_xml_node next(char const *type) const
+		{
+			Indexed_xml_node node = next();
+			for (; type && !node.has_type(type); node = node.next());
+			return node;
+		}
+
+		bool last(char const *type = 0) const
+		{
+			try { next(type); return false; }
+			catch (Nonexistent_sub_node) { return true; }
+		}
+
+		template <typename FN>
+		void for_each_sub_node(char const *type, FN const &fn) const
+		{
+			for (unsigned i = 0; i < _node().num_sub_nodes; i++) {
+				Indexed_xml_node const node = sub_node(i);
+				if (!type || node.has_type(type))
+					fn(node);
+			}
+		}
+
+		template <typename FN>
+		void for_each_sub_node(FN const &fn) const {
+			for_each_sub_node(nullptr, fn); }
+
+		/**
+		 * Return Nth attribute of the node
+		 *
+		 * \throw Nonexistent_attribute
+		 */
+		Xml_attribute attribute(unsigned idx) const
+		{
+			if (idx >= _node().num_attrs)
+				throw Nonexistent_attribute();
+
+			return _attribute(_index->_attrs[_node().first_attr + idx]);
+		}
+
+		/**
+		 * Return attribute of specified type
+		 *
+		 * \throw Nonexistent_attribute
+		 */
+		Xml_attribute attribute(char const *type) const
+		{
+			size_t const len = strlen(type);
+
+			for (unsigned i = 0; i < _node().num_attrs; i++) {
+				Attr const &attr = _index->_attrs[_node().first_attr + i];
+				if (attr.name_len == len && !strcmp(type, _at(attr.name), len))
+					return _attribute(attr);
+			}
+			throw Nonexistent_attribute();
+		}
+
+		template <typename T>
+		T attribute_value(char const *type, T default_value) const
+		{
+			T result = default_value;
+			try { attribute(type).value(&result); } catch (...) { }
+			return result;
+		}
+
+		bool has_attribute(char const *type) const
+		{
+			try { attribute(type); return true; } catch (...) { }
+			return false;
+		}
+
+		void print(Output &output) const { output.out_string(addr(), size()); }
+};
+
+
+Genode::Indexed_xml_node Genode::Xml_index::node() const {
+	return Indexed_xml_node(*this, 0); }
+
+#endif /* _INCLUDE__UTIL__XML_INDEX_H_ */
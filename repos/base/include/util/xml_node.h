@@ -20,6 +20,8 @@
 namespace Genode {
 	class Xml_attribute;
 	class Xml_node;
+	class Xml_index;
+	class Indexed_xml_node;
 }
 
 
@@ -58,6 +60,9 @@ class Genode::Xml_attribute
 		 */
 		friend class Tag;
 
+		friend class Xml_index;
+		friend class Indexed_xml_node;
+
 		/**
 		 * Constructor
 		 *
@@ -195,6 +200,11 @@ class Genode::Xml_node
 		 */
 		class Tag;
 
+		/*
+		 * The index uses the tokenizer of 'Xml_node' to parse the XML data
+		 */
+		friend class Xml_index;
+
 	public:
 
 		/*********************
@@ -42,3 +42,7 @@ Genode::Log &Genode::Log::log()
 
 
 void Genode::init_log() { };
+
+
+/* core's LOG output does not use a LOG session */
+void Genode::init_log_ring() { }
@@ -283,6 +283,9 @@ namespace {
 			Genode::call_global_static_constructors();
 			Genode::init_signal_transmitter(env);
 
+			/* LOG output may use signals from now on */
+			Genode::init_log_ring();
+
 			/*
 			 * Now, as signaling is available, initialize the asynchronous
 			 * parent resource mechanism
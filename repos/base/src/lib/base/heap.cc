@@ -36,6 +36,226 @@ namespace {
 }
 
 
+/**
+ * Slabs for small allocations in front of the AVL allocator
+ *
+ * Each slab block is an AVL block that starts with a header referring to
+ * the size class of the block. When a slot is freed, the header is found
+ * via the used AVL block that contains the address. Regular allocations
+ * always start at the beginning of their AVL block whereas slots never do.
+ *
+ * The AVL blocks, the header, and the slot sizes are multiples of 16 bytes.
+ * So each slot has the same alignment as a regular heap allocation.
+ */
+class Heap::Size_classes
+{
+	private:
+
+		enum { NUM_CLASSES = 10, GRANULARITY = 16 };
+
+		static size_t _class_size(unsigned i)
+		{
+			static size_t const sizes[NUM_CLASSES] =
+				{ 16, 32, 48, 64, 96, 128, 192, 256, 384, (size_t)MAX_SIZE_CLASS };
+
+			return sizes[i];
+		}
+
+		class Size_class;
+
+		/*
+		 * Unused slot, linked in the free list of its block
+		 */
+		struct Slot { Slot *next; };
+
+		struct Block
+		{
+			Size_class &size_class;
+
+			Slot    *free_slots = nullptr;
+			unsigned used       = 0;
+
+			/* list of blocks with or without unused slots */
+			Block *prev = nullptr;
+			Block *next = nullptr;
+
+			Block(Size_class &size_class) : size_class(size_class) { }
+		};
+
+		enum { HEADER_SIZE = (sizeof(Block) + GRANULARITY - 1) & ~(GRANULARITY - 1) };
+
+		/**
+		 * Slab of one size class, backed by the heap's local allocator
+		 */
+		class Size_class
+		{
+			private:
+
+				/*
+				 * Noncopyable
+				 */
+				Size_class(Size_class const &);
+				Size_class &operator = (Size_class const &);
+
+				Heap &_heap;
+
+				size_t const _size;
+
+				/* blocks of large slots are doubled to hold enough slots */
+				size_t const _block_size = _size <= 128 ? 4096 : 8192;
+
+				Block *_partial = nullptr;  /* blocks with unused slots */
+				Block *_full    = nullptr;
+
+				static void _insert(Block *&list, Block &b)
+				{
+					b.prev = nullptr;
+					b.next = list;
+					if (list) list->prev = &b;
+					list = &b;
+				}
+
+				static void _remove(Block *&list, Block &b)
+				{
+					if (b.prev) b.prev->next = b.next;
+					else        list         = b.next;
+					if (b.next) b.next->prev = b.prev;
+					b.prev = b.next = nullptr;
+				}
+
+				void _free_block(Block &b)
+				{
+					_heap._alloc->free(&b, _block_size);
+					_heap._quota_used -= _block_size;
+				}
+
+				Block *_alloc_block()
+				{
+					if (_block_size + _heap._quota_used > _heap._quota_limit)
+						return nullptr;
+
+					void *addr = nullptr;
+					if (!_heap._unsynchronized_alloc(_block_size, &addr))
+						return nullptr;
+
+					Block &b = *construct_at<Block>(addr, *this);
+
+					/* link the slots in the order of their addresses */
+					size_t const num_slots = (_block_size - HEADER_SIZE)/_size;
+					for (size_t i = num_slots; i--; ) {
+						Slot *s = (Slot *)((addr_t)addr + HEADER_SIZE + i*_size);
+						s->next      = b.free_slots;
+						b.free_slots = s;
+					}
+					return &b;
+				}
+
+			public:
+
+				Size_class(Heap &heap, size_t size) : _heap(heap), _size(size) { }
+
+				~Size_class()
+				{
+					while (Block *b = _partial) {
+						_remove(_partial, *b);
+						_free_block(*b);
+					}
+					while (Block *b = _full) {
+						_remove(_full, *b);
+						_free_block(*b);
+					}
+				}
+
+				bool alloc(void **out_addr)
+				{
+					if (!_partial) {
+						Block *b = _alloc_block();
+						if (!b)
+							return false;
+						_insert(_partial, *b);
+					}
+
+					Block &b = *_partial;
+					Slot  &s = *b.free_slots;
+
+					b.free_slots = s.next;
+					b.used++;
+
+					if (!b.free_slots) {
+						_remove(_partial, b);
+						_insert(_full, b);
+					}
+
+					*out_addr = &s;
+					return true;
+				}
+
+				void free(Block &b, void *addr)
+				{
+					bool const full = !b.free_slots;
+
+					Slot &s = *(Slot *)addr;
+					s.next       = b.free_slots;
+					b.free_slots = &s;
+					b.used--;
+
+					if (full) {
+						_remove(_full, b);
+						_insert(_partial, b);
+					}
+
+					/* keep one empty block to avoid thrashing */
+					if (b.used || (_partial == &b && !b.next))
+						return;
+
+					_remove(_partial, b);
+					_free_block(b);
+				}
+		};
+
+		Constructible<Size_class> _classes[NUM_CLASSES];
+
+		/* size class for each multiple of 'GRANULARITY' */
+		unsigned char _class_of[MAX_SIZE_CLASS/GRANULARITY + 1];
+
+	public:
+
+		Size_classes(Heap &heap)
+		{
+			for (unsigned i = 0; i < NUM_CLASSES; i++)
+				_classes[i].construct(heap, _class_size(i));
+
+			unsigned c = 0;
+			for (unsigned i = 0; i <= MAX_SIZE_CLASS/GRANULARITY; i++) {
+				while (_class_size(c) < i*GRANULARITY) c++;
+				_class_of[i] = (unsigned char)c;
+			}
+		}
+
+		bool alloc(size_t size, void **out_addr)
+		{
+			unsigned const c = _class_of[(size + GRANULARITY - 1)/GRANULARITY];
+			return _classes[c]->alloc(out_addr);
+		}
+
+		/**
+		 * Free 'addr' if it refers to a slot
+		 *
+		 * \return  false if 'addr' is not a slot
+		 */
+		bool free(Local_allocator const &alloc, void *addr)
+		{
+			addr_t const block = alloc.used_block_addr(addr);
+			if (!block || block == (addr_t)addr)
+				return false;
+
+			Block &b = *(Block *)block;
+			b.size_class.free(b, addr);
+			return true;
+		}
+};
+
+
 void Heap::Dataspace_pool::remove_and_free(Dataspace &ds)
 {
 	/*
@@ -213,6 +433,23 @@ bool Heap::_unsynchronized_alloc(size_t size, void **out_addr)
 }
 
 
+bool Heap::enable_size_classes()
+{
+	/* serialize access of heap functions */
+	Lock::Guard lock_guard(_lock);
+
+	if (_size_classes)
+		return true;
+
+	void *addr = nullptr;
+	if (!_unsynchronized_alloc(sizeof(Size_classes), &addr))
+		return false;
+
+	_size_classes = construct_at<Size_classes>(addr, *this);
+	return true;
+}
+
+
 bool Heap::alloc(size_t size, void **out_addr)
 {
 	/* serialize access of heap functions */
@@ -222,6 +459,9 @@ bool Heap::alloc(size_t size, void **out_addr)
 	if (size + _quota_used > _quota_limit)
 		return false;
 
+	if (_size_classes && size && size <= MAX_SIZE_CLASS)
+		return _size_classes->alloc(size, out_addr);
+
 	return _unsynchronized_alloc(size, out_addr);
 }
 
@@ -231,6 +471,9 @@ void Heap::free(void *addr, size_t)
 	/* serialize access of heap functions */
 	Lock::Guard lock_guard(_lock);
 
+	if (_size_classes && _size_classes->free(*_alloc, addr))
+		return;
+
 	/* try to find the size in our local allocator */
 	size_t const size = _alloc->size_at(addr);
 
@@ -296,6 +539,16 @@ Heap::~Heap()
 	for (Heap::Dataspace *ds = _ds_pool.first(); ds; ds = ds->next())
 		_alloc->free(ds, sizeof(Dataspace));
 
+	/*
+	 * Release the blocks of the size classes and the 'Size_classes'
+	 * object itself, which are allocated from the local allocator as well.
+	 */
+	if (_size_classes) {
+		_size_classes->~Size_classes();
+		_alloc->free(_size_classes, sizeof(Size_classes));
+		_size_classes = nullptr;
+	}
+
 	/*
 	 * Destruct 'Allocator_avl' before destructing the dataspace pool. This
 	 * order is important because some dataspaces of the dataspace pool are
@@ -12,10 +12,12 @@
  */
 
 #include <log_session/connection.h>
+#include <log_session/log_ring.h>
 #include <base/printf.h>
 #include <base/console.h>
 #include <base/lock.h>
 #include <base/env.h>
+#include <base/internal/globals.h>
 #include <base/internal/unmanaged_singleton.h>
 
 using namespace Genode;
@@ -24,6 +26,12 @@ class Log_console : public Console
 {
 	private:
 
+		/*
+		 * Noncopyable
+		 */
+		Log_console(Log_console const &);
+		Log_console &operator = (Log_console const &);
+
 		enum { _BUF_SIZE = Log_session::MAX_STRING_LEN };
 
 
@@ -42,11 +50,61 @@ class Log_console : public Console
 		unsigned _num_chars = 0;
 		Lock     _lock { };
 
+		/*
+		 * Ring shared with the LOG server, requested at the first output
+		 * after signal submission became available
+		 */
+		Log_ring                 *_ring = nullptr;
+		Signal_context_capability _ring_sigh { };
+		bool                      _ring_requested = false;
+		bool                      _ring_enabled   = false;
+
+		void _request_ring()
+		{
+			_ring_requested = true;
+
+			try {
+				/* donate the capabilities consumed by the ring */
+				unsigned const ring_caps = Log_session::RING_CAP_QUOTA;
+				internal_env().upgrade(Parent::Env::log(),
+				                       String<32>("cap_quota=", ring_caps).string());
+
+				Dataspace_capability const ds = _log.ring_dataspace();
+				if (!ds.valid())
+					return;
+
+				_ring_sigh = _log.ring_sigh();
+				_ring = env_deprecated()->rm_session()->attach(ds);
+			}
+			catch (...) { _ring = nullptr; }
+		}
+
+		/*
+		 * The server is notified only if it has not been notified since it
+		 * started consuming the ring. So the server consumes all strings
+		 * written in the meantime at once.
+		 */
+		size_t _write(char const *s)
+		{
+			if (_ring_enabled && !_ring_requested)
+				_request_ring();
+
+			size_t const len = strlen(s);
+
+			if (_ring && _ring->write(s, len)) {
+				if (_ring->wakeup_needed())
+					Signal_transmitter(_ring_sigh).submit();
+				return len;
+			}
+
+			return _log.write(s);
+		}
+
 		void _flush()
 		{
 			/* null-terminate string */
 			_buf[_num_chars] = 0;
-			_log.write(_buf);
+			_write(_buf);
 
 			/* restart with empty buffer */
 			_num_chars = 0;
@@ -83,9 +141,18 @@ class Log_console : public Console
 		}
 
 		/**
-		 * Return LOG session interface
+		 * Use the ring from now on, called once signals can be submitted
 		 */
-		Log_session &log_session() { return _log; }
+		void enable_ring() { _ring_enabled = true; }
+
+		/**
+		 * Output null-terminated string
+		 */
+		size_t write(char const *s)
+		{
+			Lock::Guard lock_guard(_lock);
+			return _write(s);
+		}
 
 		/**
 		 * Re-establish LOG session
@@ -100,6 +167,15 @@ class Log_console : public Console
 			 * of the respective capability-space element.
 			 */
 			construct_at<Log>(&_log);
+
+			/* the ring belongs to the old session */
+			if (_ring) {
+				try { env_deprecated()->rm_session()->detach(_ring); }
+				catch (...) { }
+			}
+			construct_at<Signal_context_capability>(&_ring_sigh);
+			_ring           = nullptr;
+			_ring_requested = false;
 		}
 };
 
@@ -112,12 +188,15 @@ class Log_console : public Console
 static Log_console *stdout_log_console() { return unmanaged_singleton<Log_console>(); }
 
 
+void Genode::init_log_ring() { stdout_log_console()->enable_ring(); }
+
+
 /**
  * Hook for supporting libc back ends for stdio
  */
 extern "C" int stdout_write(const char *s)
 {
-	return stdout_log_console()->log_session().write(s);
+	return stdout_log_console()->write(s);
 }
 
 
@@ -0,0 +1,148 @@
+/*
+ * \brief  Heap benchmark
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The benchmark keeps a working set of small blocks of pseudo-random sizes
+ * and replaces randomly chosen blocks in each round. It compares the plain
+ * AVL-based heap with the heap using its size-class front end with respect to
+ * the alloc/free throughput and the fragmentation, i.e., the ratio of the
+ * quota consumed by the heap to the number of bytes in use.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Random
+{
+	unsigned long _state = 1;
+
+	unsigned long next()
+	{
+		_state = _state*1103515245 + 12345;
+		return (_state >> 16) & 0x7fff;
+	}
+};
+
+
+struct Working_set
+{
+	enum { NUM_BLOCKS = 32*1024, ROUNDS = 1024*1024, MAX_SIZE = 512 };
+
+	Allocator &_alloc;
+
+	struct Block { void *ptr; size_t size; } _blocks[NUM_BLOCKS];
+
+	size_t _used = 0;
+
+	Random _random { };
+
+	size_t _random_size() { return 8 + _random.next() % (MAX_SIZE - 8); }
+
+	void _alloc_block(Block &b)
+	{
+		b.size = _random_size();
+		b.ptr  = _alloc.alloc(b.size);
+		_used += b.size;
+	}
+
+	void _free_block(Block &b)
+	{
+		_alloc.free(b.ptr, b.size);
+		_used -= b.size;
+	}
+
+	Working_set(Allocator &alloc) : _alloc(alloc)
+	{
+		for (unsigned i = 0; i < NUM_BLOCKS; i++)
+			_alloc_block(_blocks[i]);
+	}
+
+	~Working_set()
+	{
+		for (unsigned i = 0; i < NUM_BLOCKS; i++)
+			_free_block(_blocks[i]);
+	}
+
+	void replace_random_blocks()
+	{
+		for (unsigned i = 0; i < ROUNDS; i++) {
+			Block &b = _blocks[_random.next() % NUM_BLOCKS];
+			_free_block(b);
+			_alloc_block(b);
+		}
+	}
+
+	size_t used() const { return _used; }
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Working_set(Working_set const &);
+		Working_set &operator = (Working_set const &);
+};
+
+
+static void measure(char const *name, Heap &heap, Allocator &md_alloc,
+                    Timer::Connection &timer)
+{
+	Working_set &set = *new (md_alloc) Working_set(heap);
+
+	unsigned long const start_ms = timer.elapsed_ms();
+
+	set.replace_random_blocks();
+
+	unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+
+	/* each round consists of one free and one alloc operation */
+	unsigned long const ops_per_ms = 2*Working_set::ROUNDS / duration_ms;
+
+	size_t const consumed = heap.consumed();
+	size_t const used     = set.used();
+
+	log(name, ": ", ops_per_ms, " ops/ms, "
+	    "used ", used/1024, " KiB, consumed ", consumed/1024, " KiB, "
+	    "overhead ", ((consumed - used)*100)/used, "%");
+
+	destroy(md_alloc, &set);
+}
+
+
+void Component::construct(Genode::Env &env)
+{
+	log("--- heap benchmark ---");
+
+	static Timer::Connection timer(env);
+
+	static Sliced_heap md_alloc(env.ram(), env.rm());
+
+	{
+		Heap heap(env.ram(), env.rm());
+		measure("AVL allocator", heap, md_alloc, timer);
+	}
+
+	{
+		Heap heap(env.ram(), env.rm());
+		if (!heap.enable_size_classes()) {
+			error("could not enable size classes");
+			return;
+		}
+		measure("size classes ", heap, md_alloc, timer);
+	}
+
+	log("Test done");
+}
@@ -244,6 +244,14 @@ struct Audio_out::Root_policy
 			              "denying '",Genode::label_from_args(args),"'");
 			throw Genode::Service_denied();
 		}
+
+		unsigned const sample_rate =
+			Arg_string::find_arg(args, "sample_rate").ulong_value(SAMPLE_RATE);
+		if (sample_rate != SAMPLE_RATE) {
+			Genode::error("unsupported sample rate ", sample_rate, " requested, "
+			              "denying '",Genode::label_from_args(args),"'");
+			throw Genode::Service_denied();
+		}
 	}
 
 	void release() { }
@@ -130,6 +130,11 @@ class Framebuffer::Session_component : public Genode::Rpc_object<Session>
 			return _config.xml().attribute_value<unsigned>("force_height", 0);
 		}
 
+		unsigned depth_from_config()
+		{
+			return _config.xml().attribute_value<unsigned>("depth", 16);
+		}
+
 
 		/***********************************
 		 ** Framebuffer session interface **
@@ -142,8 +147,11 @@ class Framebuffer::Session_component : public Genode::Rpc_object<Session>
 			return _ds.cap();
 		}
 
-		Mode mode() const override {
-			return Mode(_driver.width(), _driver.height(), Mode::RGB565); }
+		Mode mode() const override
+		{
+			return Mode(_driver.width(), _driver.height(),
+			            _driver.bpp() == 4 ? Mode::RGB888 : Mode::RGB565);
+		}
 
 		void mode_sigh(Genode::Signal_context_capability sigh) override {
 			_mode_sigh = sigh; }
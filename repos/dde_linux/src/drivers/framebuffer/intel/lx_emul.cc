@@ -173,6 +173,10 @@ void Framebuffer::Driver::update_mode()
 	Configuration old = _config;
 	_config = Configuration();
 
+	/* 32 bits per pixel select RGB888, any other depth RGB565 */
+	if (_session.depth_from_config() == 32)
+		_config._lx.bpp = 4;
+
 	lx_for_each_connector(lx_drm_device, [&] (drm_connector *c) {
 		drm_display_mode * mode = _preferred_mode(c);
 		if (!mode) return;
@@ -54,7 +54,7 @@ void lx_c_allocate_framebuffer(struct drm_device * dev,
 	if (!r) goto err2;
 	r->width        = c->width;
 	r->height       = c->height;
-	r->pixel_format = DRM_FORMAT_RGB565;
+	r->pixel_format = (c->bpp == 4) ? DRM_FORMAT_XRGB8888 : DRM_FORMAT_RGB565;
 	r->pitches[0]   = c->pitch;
 	c->lx_fb = lx_c_intel_framebuffer_create(dev, r, obj);
 	if (IS_ERR(c->lx_fb)) goto err2;
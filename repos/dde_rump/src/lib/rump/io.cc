@@ -14,9 +14,12 @@
 #include "sched.h"
 #include <base/allocator_avl.h>
 #include <base/printf.h>
+#include <base/semaphore.h>
 #include <block_session/connection.h>
+#include <os/ring_buffer.h>
 #include <rump/env.h>
 #include <rump_fs/fs.h>
+#include <util/hard_context.h>
 
 
 static const bool verbose = false;
@@ -25,18 +28,201 @@ enum  { GENODE_FD = 64 };
 
 /**
  * Block session connection
+ *
+ * Requests of the rump kernel are submitted to the block session without
+ * waiting for their completion. A dedicated thread receives the
+ * acknowledgements and completes the requests in the order they are
+ * finished by the block server. The number of outstanding requests is
+ * bounded by the size of the packet-stream queues.
  */
 class Backend
 {
+	public:
+
+		enum { MAX_PACKETS = Block::Session::TX_QUEUE_SIZE };
+
 	private:
 
+		/*
+		 * Noncopyable
+		 */
+		Backend(Backend const &);
+		Backend &operator = (Backend const &);
+
+		struct Request
+		{
+			bool                      used       = false;
+			bool                      sync       = false; /* awaits SYNC ack */
+			bool                      succeeded  = false;
+			int                       op         = 0;
+			void                     *data       = nullptr;
+			size_t                    length     = 0;
+			rump_biodone_fn           biodone    = nullptr;
+			void                     *donearg    = nullptr;
+			Block::Packet_descriptor  packet     { };
+
+			Request() { }
+
+			/*
+			 * Noncopyable
+			 */
+			Request(Request const &);
+			Request &operator = (Request const &);
+		};
+
+		/**
+		 * Finished request, delivered to the rump kernel outside the lock
+		 */
+		struct Completion
+		{
+			rump_biodone_fn  biodone;
+			void            *donearg;
+			size_t           length;
+			bool             succeeded;
+			bool             blocking_sync;
+		};
+
+		typedef Genode::Ring_buffer<unsigned, MAX_PACKETS + 1,
+		                            Genode::Ring_buffer_unsynchronized> Sync_queue;
+
 		Genode::Allocator_avl              _alloc { &Rump::env().heap() };
-		Block::Connection                  _session { Rump::env().env(), &_alloc };
+		Block::Connection                  _session { Rump::env().env(), &_alloc,
+		                                              1024*1024 };
 		Genode::size_t                     _blk_size; /* block size of the device   */
 		Block::sector_t                    _blk_cnt;  /* number of blocks of device */
 		Block::Session::Operations         _blk_ops;
 		Genode::Lock                       _session_lock;
 
+		Request    _requests[MAX_PACKETS];
+		unsigned   _packets   = 0;    /* packets in flight            */
+		Sync_queue _syncs     { };    /* requests awaiting SYNC acks  */
+		unsigned   _waiters   = 0;    /* submitters blocked for space */
+		bool       _completer = false;
+
+		Genode::Semaphore _completed { };
+
+		Request *_free_request()
+		{
+			for (unsigned i = 0; i < MAX_PACKETS; i++)
+				if (!_requests[i].used)
+					return &_requests[i];
+			return nullptr;
+		}
+
+		Request *_lookup(Block::Packet_descriptor const &packet)
+		{
+			for (unsigned i = 0; i < MAX_PACKETS; i++)
+				if (_requests[i].used && _requests[i].packet.size()
+				 && _requests[i].packet.offset() == packet.offset())
+					return &_requests[i];
+			return nullptr;
+		}
+
+		bool _sync_supported() {
+			return _blk_ops.supported(Block::Packet_descriptor::SYNC); }
+
+		/**
+		 * Wait until an outstanding request got completed
+		 *
+		 * Must be called with '_session_lock' held.
+		 */
+		void _wait_for_completion()
+		{
+			_waiters++;
+			_session_lock.unlock();
+			_completed.down();
+			_session_lock.lock();
+		}
+
+		/**
+		 * Account acknowledged packet
+		 *
+		 * \return true if the corresponding request is finished
+		 */
+		bool _acked(Block::Packet_descriptor const &packet, Completion &c)
+		{
+			using namespace Block;
+
+			Genode::Lock::Guard guard(_session_lock);
+
+			_packets--;
+
+			Request *r = nullptr;
+			if (packet.barrier()) {
+				if (_syncs.empty()) {
+					Genode::error("I/O back end: unexpected SYNC acknowledgement");
+					return false;
+				}
+				r = &_requests[_syncs.get()];
+				r->succeeded = r->succeeded && packet.succeeded();
+				r->sync      = false;
+			} else {
+				r = _lookup(packet);
+				if (!r) {
+					Genode::error("I/O back end: unknown packet acknowledged");
+					_session.tx()->release_packet(packet);
+					return false;
+				}
+
+				/* in packet */
+				r->succeeded = packet.succeeded();
+				if (r->succeeded && packet.operation() == Packet_descriptor::READ)
+					Genode::memcpy(r->data, _session.tx()->packet_content(packet),
+					               r->length);
+
+				_session.tx()->release_packet(packet);
+				r->packet = Packet_descriptor();
+
+				/* the SYNC request is acknowledged after the data request */
+				if (r->sync)
+					return false;
+			}
+
+			c = Completion { r->biodone, r->donearg, r->length, r->succeeded,
+			                 (r->op & RUMPUSER_BIO_SYNC) && !_sync_supported() };
+			r->used = false;
+
+			/* wake up blocked submitters, they re-check for resources */
+			for (; _waiters; _waiters--)
+				_completed.up();
+
+			return true;
+		}
+
+		void _complete_requests()
+		{
+			/* become a rump LWP, needed for calling back into the kernel */
+			_rump_upcalls.hyp_schedule();
+			_rump_upcalls.hyp_lwproc_newlwp(0);
+			_rump_upcalls.hyp_unschedule();
+
+			for (;;) {
+				Block::Packet_descriptor packet = _session.tx()->get_acked_packet();
+
+				Completion c { nullptr, nullptr, 0, false, false };
+				if (!_acked(packet, c))
+					continue;
+
+				/* sync request on a device without SYNC packet support */
+				if (c.blocking_sync)
+					_session.sync();
+
+				if (!c.biodone)
+					continue;
+
+				int nlocks;
+				rumpkern_sched(0, 0);
+				c.biodone(c.donearg, c.length, c.succeeded ? 0 : EIO);
+				rumpkern_unsched(&nlocks, 0);
+			}
+		}
+
+		static void *_completion_entry(void *arg)
+		{
+			static_cast<Backend *>(arg)->_complete_requests();
+			return nullptr;
+		}
+
 	public:
 
 		Backend()
@@ -52,53 +238,101 @@ class Backend
 			return _blk_ops.supported(Block::Packet_descriptor::WRITE);
 		}
 
+		/**
+		 * Make all submitted writes durable
+		 *
+		 * The server handles the 'sync' RPC independently of the packet
+		 * stream. Hence, all requests in flight must be completed first.
+		 */
 		void sync()
 		{
 			Genode::Lock::Guard guard(_session_lock);
+
+			while (_packets)
+				_wait_for_completion();
+
 			_session.sync();
 		}
 
-		bool submit(int op, int64_t offset, size_t length, void *data)
+		/**
+		 * Submit request to block session
+		 *
+		 * \return false if the request could not be submitted, 'biodone'
+		 *         is not called in this case
+		 *
+		 * The method blocks only if the maximum number of outstanding
+		 * requests is reached or the bulk buffer is exhausted.
+		 */
+		bool submit(int op, int64_t offset, size_t length, void *data,
+		            rump_biodone_fn biodone, void *donearg)
 		{
 			using namespace Block;
 
 			Genode::Lock::Guard guard(_session_lock);
 
+			/* the completion thread is started once the rump kernel is up */
+			if (!_completer) {
+				new (Rump::env().heap())
+					Hard_context_thread("rump_bio", _completion_entry, this, 0);
+				_completer = true;
+			}
+
 			Packet_descriptor::Opcode opcode;
 			opcode = op & RUMPUSER_BIO_WRITE ? Packet_descriptor::WRITE :
 			                                   Packet_descriptor::READ;
-			/* allocate packet */
-			try {
-				Packet_descriptor packet( _session.dma_alloc_packet(length),
-				                         opcode, offset / _blk_size,
-				                         length / _blk_size);
-
-				/* out packet -> copy data */
-				if (opcode == Packet_descriptor::WRITE)
-					Genode::memcpy(_session.tx()->packet_content(packet), data, length);
-
-				_session.tx()->submit_packet(packet);
-			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
-				Genode::error("I/O back end: Packet allocation failed!");
-				return false;
-			}
 
-			/* wait and process result */
-			Packet_descriptor packet = _session.tx()->get_acked_packet();
-
-			/* in packet */
-			if (opcode == Packet_descriptor::READ)
-				Genode::memcpy(data, _session.tx()->packet_content(packet), length);
-
-			bool succeeded = packet.succeeded();
-			_session.tx()->release_packet(packet);
+			bool const     sync   = (op & RUMPUSER_BIO_SYNC) && _sync_supported();
+			unsigned const needed = sync ? 2 : 1;
+
+			/* allocate request and packet */
+			Request           *r = nullptr;
+			Packet_descriptor  packet;
+			for (;;) {
+				r = _free_request();
+				if (r && _packets + needed <= MAX_PACKETS) {
+					try {
+						packet = Packet_descriptor(_session.dma_alloc_packet(length),
+						                           opcode, offset / _blk_size,
+						                           length / _blk_size);
+						break;
+					} catch (Block::Session::Tx::Source::Packet_alloc_failed) {
+						if (!_packets) {
+							Genode::error("I/O back end: Packet allocation failed!");
+							return false;
+						}
+					}
+				}
+				_wait_for_completion();
+			}
 
-			/* sync request */
-			if (op & RUMPUSER_BIO_SYNC) {
-				_session.sync();
+			r->used      = true;
+			r->sync      = sync;
+			r->succeeded = false;
+			r->op        = op;
+			r->data      = data;
+			r->length    = length;
+			r->biodone   = biodone;
+			r->donearg   = donearg;
+			r->packet    = packet;
+
+			/* out packet -> copy data */
+			if (opcode == Packet_descriptor::WRITE)
+				Genode::memcpy(_session.tx()->packet_content(packet), data, length);
+
+			_session.tx()->submit_packet(packet);
+			_packets++;
+
+			/* sync request, ordered after the data request by the server */
+			if (sync) {
+				_syncs.add(r - _requests);
+				_session.tx()->submit_packet(
+					Packet_descriptor(_session.tx()->alloc_packet(0),
+					                  Packet_descriptor::SYNC,
+					                  offset / _blk_size, length / _blk_size));
+				_packets++;
 			}
 
-			return succeeded;
+			return true;
 		}
 };
 
@@ -154,12 +388,13 @@ void rumpuser_bio(int fd, int op, void *data, size_t dlen, int64_t off,
 		            "bio ",   donearg, " "
 		            "sync: ", !!(op & RUMPUSER_BIO_SYNC));
 
-	bool succeeded = backend().submit(op, off, dlen, data);
+	bool submitted = backend().submit(op, off, dlen, data, biodone, donearg);
 
 	rumpkern_sched(nlocks, 0);
 
-	if (biodone)
-		biodone(donearg, dlen, succeeded ? 0 : EIO);
+	/* completed requests are reported by the back end's completion thread */
+	if (!submitted && biodone)
+		biodone(donearg, dlen, EIO);
 }
 
 
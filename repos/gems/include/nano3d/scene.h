@@ -7,6 +7,9 @@
  * view with a triple-buffer for rendering tearing-free animations.
  * A derrived class implements the to-be-displayed content in the virtual
  * 'render' method.
+ *
+ * Optionally, the scene is rendered by multiple threads, each drawing a
+ * horizontal band of the frame via the virtual 'render_band' method.
  */
 
 /*
@@ -26,6 +29,9 @@
 #include <os/surface.h>
 #include <os/pixel_alpha8.h>
 #include <base/attached_dataspace.h>
+#include <base/semaphore.h>
+#include <base/thread.h>
+#include <util/reconstructible.h>
 #include <input/event.h>
 
 namespace Nano3d {
@@ -50,9 +56,29 @@ class Nano3d::Scene
 
 		typedef Genode::Pixel_alpha8 Pixel_alpha8;
 
+		enum { MAX_THREADS = 8 };
+
 		virtual void render(Genode::Surface<PT>           &pixel_surface,
 		                    Genode::Surface<Pixel_alpha8> &alpha_surface) = 0;
 
+		/**
+		 * Render horizontal band of the scene
+		 *
+		 * \param thread  index of the calling thread, which allows for
+		 *                using state per thread such as polygon painters
+		 *
+		 * The clipping area of the surfaces is restricted to the band. If
+		 * the scene is rendered by multiple threads, this method is called
+		 * concurrently. The default implementation calls 'render', which
+		 * suffices for scenes rendered by a single thread.
+		 */
+		virtual void render_band(Genode::Surface<PT>           &pixel_surface,
+		                         Genode::Surface<Pixel_alpha8> &alpha_surface,
+		                         unsigned                       thread)
+		{
+			render(pixel_surface, alpha_surface);
+		}
+
 	private:
 
 		Genode::Env &_env;
@@ -163,17 +189,19 @@ class Nano3d::Scene
 			Genode::Surface_base::Area size() const { return pixel.size(); }
 
 			template <typename T>
-			void _clear(Genode::Surface<T> &surface)
+			void _clear(Genode::Surface<T> &surface, unsigned y, unsigned h)
 			{
-				Genode::size_t n = (surface.size().count()*sizeof(T))/sizeof(long);
-				for (long *dst = (long *)surface.addr(); n--; dst++)
-					*dst = 0;
+				unsigned const w = surface.size().w();
+				Genode::memset(surface.addr() + y*w, 0, h*w*sizeof(T));
 			}
 
-			void clear()
+			/**
+			 * Clear 'h' lines starting at line 'y'
+			 */
+			void clear(unsigned y, unsigned h)
 			{
-				_clear(pixel);
-				_clear(alpha);
+				_clear(pixel, y, h);
+				_clear(alpha, y, h);
 			}
 		};
 
@@ -192,6 +220,65 @@ class Nano3d::Scene
 
 		Timer::Connection _timer { _env };
 
+		unsigned long _frame_ms = 0;
+
+		/*
+		 * Threads for rendering bands of the frame in parallel, the band
+		 * with index 0 is rendered by the entrypoint
+		 */
+		struct Band_thread : Genode::Thread
+		{
+			enum { STACK_SIZE = 16*1024*sizeof(long) };
+
+			Scene             &scene;
+			unsigned     const index;
+			Genode::Semaphore  go { };
+
+			void entry() override
+			{
+				for (;;) {
+					go.down();
+					scene._render_band(index);
+					scene._bands_done.up();
+				}
+			}
+
+			Band_thread(Genode::Env &env, Scene &scene, unsigned index,
+			            Genode::Affinity::Location location)
+			:
+				Genode::Thread(env, "band", STACK_SIZE, location, Weight(), env.cpu()),
+				scene(scene), index(index)
+			{ }
+		};
+
+		unsigned const _threads;
+
+		Genode::Constructible<Band_thread> _band_threads[MAX_THREADS];
+
+		Genode::Semaphore _bands_done { };
+
+		void _render_band(unsigned index)
+		{
+			Surface &surface = *_surface_back;
+
+			int const w  = surface.size().w();
+			int const h  = surface.size().h();
+			int const y1 = (h*index)/_threads;
+			int const y2 = (h*(index + 1))/_threads;
+
+			surface.clear(y1, y2 - y1);
+
+			Genode::Surface_base::Rect const band(Genode::Surface_base::Point(0, y1),
+			                                      Genode::Surface_base::Point(w - 1, y2 - 1));
+
+			Pixel_surface pixel(surface.pixel.addr(), surface.size());
+			Alpha_surface alpha(surface.alpha.addr(), surface.size());
+			pixel.clip(band);
+			alpha.clip(band);
+
+			render_band(pixel, alpha, index);
+		}
+
 		Genode::Attached_dataspace _input_ds { _env.rm(), _nitpicker.input()->dataspace() };
 
 		Input_handler *_input_handler_callback = nullptr;
@@ -232,9 +319,15 @@ class Nano3d::Scene
 			if (_do_sync)
 				return;
 
-			_surface_back->clear();
+			_frame_ms = _timer.elapsed_ms();
 
-			render(_surface_back->pixel, _surface_back->alpha);
+			for (unsigned i = 1; i < _threads; i++)
+				_band_threads[i]->go.up();
+
+			_render_band(0);
+
+			for (unsigned i = 1; i < _threads; i++)
+				_bands_done.down();
 
 			_swap_back_and_front_surfaces();
 
@@ -274,11 +367,23 @@ class Nano3d::Scene
 
 	public:
 
+		/**
+		 * Constructor
+		 *
+		 * \param threads  number of threads rendering the scene in parallel
+		 */
 		Scene(Genode::Env &env, unsigned update_rate_ms,
-		      Nitpicker::Point pos, Nitpicker::Area size)
+		      Nitpicker::Point pos, Nitpicker::Area size, unsigned threads = 1)
 		:
-			_env(env), _pos(pos), _size(size)
+			_env(env), _pos(pos), _size(size),
+			_threads(Genode::max(1U, Genode::min(threads, (unsigned)MAX_THREADS)))
 		{
+			Genode::Affinity::Space space = _env.cpu().affinity_space();
+			for (unsigned i = 1; i < _threads; i++) {
+				_band_threads[i].construct(_env, *this, i, space.location_of_index(i));
+				_band_threads[i]->start();
+			}
+
 			Nitpicker::Rect rect(_pos, _size);
 			_nitpicker.enqueue<Command::Geometry>(_view_handle, rect);
 			_nitpicker.enqueue<Command::To_front>(_view_handle);
@@ -294,6 +399,15 @@ class Nano3d::Scene
 
 		unsigned long elapsed_ms() const { return _timer.elapsed_ms(); }
 
+		/**
+		 * Return time of the frame currently being rendered
+		 *
+		 * In contrast to 'elapsed_ms', the value is the same for all bands.
+		 */
+		unsigned long frame_ms() const { return _frame_ms; }
+
+		unsigned threads() const { return _threads; }
+
 		void input_handler(Input_handler *input_handler)
 		{
 			_framebuffer.input_mask(input_handler ? true : false);
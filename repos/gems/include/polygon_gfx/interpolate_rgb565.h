@@ -17,6 +17,7 @@
 /* Genode includes */
 #include <util/dither_matrix.h>
 #include <os/pixel_rgb565.h>
+#include <nitpicker_gfx/pixel_span.h>
 #include <polygon_gfx/interpolate_rgba.h>
 
 namespace Polygon {
@@ -52,6 +53,52 @@ inline void Polygon::interpolate_rgba(Color start, Color end, Pixel_rgb565 *dst,
 	    b = start.b<<16,
 	    a = start.a<<16;
 
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+
+	/*
+	 * Process four pixels at once, performing the same calculations as the
+	 * loop below for each lane
+	 */
+	{
+		using namespace Pixel_span::Simd;
+
+		typedef int Vi __attribute__((vector_size(16)));
+
+		Vi const lane = { 0, 1, 2, 3 };
+
+		Vi vr = r + lane*r_ascent, vg = g + lane*g_ascent,
+		   vb = b + lane*b_ascent, va = a + lane*a_ascent;
+
+		Genode::Dither_matrix::Row const row = Genode::Dither_matrix::row(y);
+
+		for ( ; num_values >= LANES; num_values -= LANES,
+		      dst += LANES, dst_alpha += LANES, x += LANES) {
+
+			Vi const dither = Vi { row.value(x),     row.value(x + 1),
+			                       row.value(x + 2), row.value(x + 3) } << 12;
+
+			Vi const pixel = (((vr + dither) >> 16 << 8) & 0xf800)
+			               | (((vg + dither) >> 16 << 3) & 0x07e0)
+			               | (((vb + dither) >> 16 >> 3) & 0x001f);
+
+			V const alpha = (V)(va + dither);
+
+			store(dst, mix(dst, load(dst), (V)pixel, alpha >> 16));
+
+			V const da = load(dst_alpha);
+			V const res = da + (((255 - da)*alpha) >> (16 + 8));
+			dst_alpha[0] = (unsigned char)res[0]; dst_alpha[1] = (unsigned char)res[1];
+			dst_alpha[2] = (unsigned char)res[2]; dst_alpha[3] = (unsigned char)res[3];
+
+			vr += LANES*r_ascent; vg += LANES*g_ascent;
+			vb += LANES*b_ascent; va += LANES*a_ascent;
+		}
+
+		r = vr[0]; g = vg[0]; b = vb[0]; a = va[0];
+	}
+
+#endif /* __SSE2__ || __ARM_NEON__ */
+
 	for ( ; num_values--; dst++, dst_alpha++, x++) {
 
 		int const dither_value = Genode::Dither_matrix::value(x, y) << 12;
@@ -63,7 +110,8 @@ inline void Polygon::interpolate_rgba(Color start, Color end, Pixel_rgb565 *dst,
 		                                      (b + dither_value) >> 16),
 		                         (a + dither_value) >> 16);
 
-		*dst_alpha += ((255 - *dst_alpha)*(a + dither_value)) >> (16 + 8);
+		/* the product exceeds the range of 'int' */
+		*dst_alpha += ((255U - *dst_alpha)*(unsigned)(a + dither_value)) >> (16 + 8);
 
 		/* increment color-component values by ascent */
 		r += r_ascent;
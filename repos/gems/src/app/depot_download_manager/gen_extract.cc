@@ -16,13 +16,18 @@
 void Depot_download_manager::gen_extract_start_content(Xml_generator       &xml,
                                                        Import        const &import,
                                                        Path          const &user_path,
-                                                       Archive::User const &user)
+                                                       Archive::User const &user,
+                                                       Extract_version      version)
 {
 	gen_common_start_content(xml, "extract",
-	                         Cap_quota{200}, Ram_quota{12*1024*1024});
+	                         Cap_quota{200}, Ram_quota{16*1024*1024});
+
+	xml.attribute("version", version.value);
 
 	xml.node("config", [&] () {
 		xml.attribute("verbose", "yes");
+		xml.attribute("block_size",   "256K");
+		xml.attribute("write_buffer", "512K");
 
 		xml.node("libc", [&] () {
 			xml.attribute("stdout", "/dev/log");
@@ -34,14 +39,19 @@ void Depot_download_manager::gen_extract_start_content(Xml_generator       &xml,
 		xml.node("vfs", [&] () {
 			xml.node("dir", [&] () {
 				xml.attribute("name", "public");
-				xml.node("fs", [&] () { xml.attribute("label", "public"); });
+				xml.node("fs", [&] () {
+					xml.attribute("label", "public");
+					xml.attribute("buffer_size", "1M");
+				});
 			});
 			xml.node("dir", [&] () {
 				xml.attribute("name", "depot");
 				xml.node("dir", [&] () {
 					xml.attribute("name", user);
 					xml.node("fs", [&] () {
-						xml.attribute("label", user_path); });
+						xml.attribute("label", user_path);
+						xml.attribute("buffer_size", "1M");
+					});
 				});
 			});
 			xml.node("dir", [&] () {
@@ -51,7 +61,7 @@ void Depot_download_manager::gen_extract_start_content(Xml_generator       &xml,
 			});
 		});
 
-		import.for_each_verified_archive([&] (Archive::Path const &path) {
+		import.for_each_extracting_archive([&] (Archive::Path const &path) {
 
 			typedef String<160> Path;
 			typedef String<16>  Ext;
@@ -88,8 +98,9 @@ void Depot_download_manager::gen_extract_start_content(Xml_generator       &xml,
 		gen_parent_rom_route(xml, "libarchive.lib.so");
 		gen_parent_rom_route(xml, "zlib.lib.so");
 		gen_parent_rom_route(xml, "liblzma.lib.so");
-		gen_parent_route<Cpu_session>(xml);
-		gen_parent_route<Pd_session> (xml);
-		gen_parent_route<Log_session>(xml);
+		gen_parent_route<Cpu_session>   (xml);
+		gen_parent_route<Pd_session>    (xml);
+		gen_parent_route<Log_session>   (xml);
+		gen_parent_route<Timer::Session>(xml);
 	});
 }
@@ -23,6 +23,14 @@ void Depot_download_manager::gen_fetchurl_start_content(Xml_generator &xml,
 
 	xml.attribute("version", version.value);
 	xml.node("config", [&] () {
+
+		/* download archives concurrently, report each completed file */
+		xml.attribute("max_connections", 4);
+		xml.node("report", [&] () {
+			xml.attribute("progress", "yes");
+			xml.attribute("delay_ms", 500);
+		});
+
 		xml.node("libc", [&] () {
 			xml.attribute("stdout", "/dev/log");
 			xml.attribute("stderr", "/dev/log");
@@ -98,10 +106,11 @@ void Depot_download_manager::gen_fetchurl_start_content(Xml_generator &xml,
 		gen_parent_rom_route(xml, "libcrypto.lib.so");
 		gen_parent_rom_route(xml, "zlib.lib.so");
 		gen_parent_rom_route(xml, "pthread.lib.so");
-		gen_parent_route<Cpu_session>   (xml);
-		gen_parent_route<Pd_session>    (xml);
-		gen_parent_route<Log_session>   (xml);
-		gen_parent_route<Timer::Session>(xml);
-		gen_parent_route<Nic::Session>  (xml);
+		gen_parent_route<Cpu_session>    (xml);
+		gen_parent_route<Pd_session>     (xml);
+		gen_parent_route<Log_session>    (xml);
+		gen_parent_route<Timer::Session> (xml);
+		gen_parent_route<Nic::Session>   (xml);
+		gen_parent_route<Report::Session>(xml);
 	});
 }
@@ -41,10 +41,32 @@ class Depot_download_manager::Import
 			             DOWNLOAD_COMPLETE,
 			             VERIFIED,
 			             VERIFICATION_FAILED,
+			             EXTRACTION_IN_PROGRESS,
 			             UNPACKED };
 
 			State state = DOWNLOAD_IN_PROGRESS;
 
+			/*
+			 * Flags for tracking the download of the archive and its
+			 * signature by the progress report of 'fetchurl'
+			 */
+			bool fetch_seen   = false;
+			bool archive_done = false;
+			bool sig_done     = false;
+
+			char const *state_name() const
+			{
+				switch (state) {
+				case DOWNLOAD_IN_PROGRESS:   return "download";
+				case DOWNLOAD_COMPLETE:      return "verify";
+				case VERIFIED:               return "extract";
+				case VERIFICATION_FAILED:    return "failed";
+				case EXTRACTION_IN_PROGRESS: return "extract";
+				case UNPACKED:               return "done";
+				}
+				return "";
+			}
+
 			Item(Registry<Item> &registry, Archive::Path const &path)
 			:
 				_element(registry, *this), path(path)
@@ -118,6 +140,22 @@ class Depot_download_manager::Import
 			return _item_state_exists(Item::VERIFIED);
 		}
 
+		bool extraction_in_progress() const
+		{
+			return _item_state_exists(Item::EXTRACTION_IN_PROGRESS);
+		}
+
+		/**
+		 * Return true if no archive of the import is pending
+		 */
+		bool completed() const
+		{
+			return !downloads_in_progress()
+			    && !unverified_archives_available()
+			    && !verified_archives_available()
+			    && !extraction_in_progress();
+		}
+
 		template <typename FN>
 		void for_each_download(FN const &fn) const
 		{
@@ -136,12 +174,78 @@ class Depot_download_manager::Import
 			_for_each_item(Item::VERIFIED, fn);
 		}
 
+		template <typename FN>
+		void for_each_extracting_archive(FN const &fn) const
+		{
+			_for_each_item(Item::EXTRACTION_IN_PROGRESS, fn);
+		}
+
 		template <typename FN>
 		void for_each_ready_archive(FN const &fn) const
 		{
 			_for_each_item(Item::UNPACKED, fn);
 		}
 
+		/**
+		 * Call 'fn' with the path and processing stage of each archive
+		 */
+		template <typename FN>
+		void for_each_archive(FN const &fn) const
+		{
+			_items.for_each([&] (Item const &item) {
+				fn(item.path, item.state_name()); });
+		}
+
+		/**
+		 * Apply download progress reported by 'fetchurl'
+		 *
+		 * \param download_path  local path of the fetched file within the
+		 *                       VFS of 'fetchurl', without the '/download/'
+		 *                       prefix
+		 * \param complete       true if the fetch has finished successfully
+		 *
+		 * An archive is considered as downloaded once both the archive and
+		 * its signature are complete. Completion is accepted only for fetches
+		 * observed before as pending, which prevents a stale report of an
+		 * earlier 'fetchurl' instance from being taken as the result.
+		 *
+		 * \return true if an archive became completely downloaded
+		 */
+		bool fetch_progress(Path const &download_path, bool complete)
+		{
+			bool downloaded = false;
+
+			_items.for_each([&] (Item &item) {
+
+				if (item.state != Item::DOWNLOAD_IN_PROGRESS)
+					return;
+
+				bool const archive = (download_path == Path(item.path, ".tar.xz"));
+				bool const sig     = (download_path == Path(item.path, ".tar.xz.sig"));
+
+				if (!archive && !sig)
+					return;
+
+				if (!complete) {
+					item.fetch_seen = true;
+					return;
+				}
+
+				if (!item.fetch_seen)
+					return;
+
+				if (archive) item.archive_done = true;
+				if (sig)     item.sig_done     = true;
+
+				if (item.archive_done && item.sig_done) {
+					item.state = Item::DOWNLOAD_COMPLETE;
+					downloaded = true;
+				}
+			});
+
+			return downloaded;
+		}
+
 		void all_downloads_completed()
 		{
 			_items.for_each([&] (Item &item) {
@@ -165,10 +269,20 @@ class Depot_download_manager::Import
 						item.state = Item::VERIFICATION_FAILED; });
 		}
 
-		void all_verified_archives_extracted()
+		/**
+		 * Hand over all verified archives to the 'extract' component
+		 */
+		void start_extraction()
 		{
 			_items.for_each([&] (Item &item) {
 				if (item.state == Item::VERIFIED)
+					item.state = Item::EXTRACTION_IN_PROGRESS; });
+		}
+
+		void all_extracting_archives_unpacked()
+		{
+			_items.for_each([&] (Item &item) {
+				if (item.state == Item::EXTRACTION_IN_PROGRESS)
 					item.state = Item::UNPACKED; });
 		}
 };
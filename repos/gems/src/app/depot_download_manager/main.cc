@@ -29,9 +29,10 @@ namespace Depot_download_manager {
 
 struct Depot_download_manager::Child_exit_state
 {
-	bool exists = false;
-	bool exited = false;
-	int  code   = 0;
+	bool     exists  = false;
+	bool     exited  = false;
+	int      code    = 0;
+	unsigned version = 0;
 
 	typedef String<64> Name;
 
@@ -39,7 +40,8 @@ struct Depot_download_manager::Child_exit_state
 	{
 		init_state.for_each_sub_node("child", [&] (Xml_node child) {
 			if (child.attribute_value("name", Name()) == name) {
-				exists = true;
+				exists  = true;
+				version = child.attribute_value("version", 0U);
 				if (child.has_attribute("exited")) {
 					exited = true;
 					code = child.attribute_value("exited", 0L);
@@ -70,6 +72,11 @@ struct Depot_download_manager::Main
 	 */
 	Attached_rom_dataspace _verified { _env, "verified" };
 
+	/**
+	 * Download progress, reported by the 'fetchurl' component
+	 */
+	Attached_rom_dataspace _fetchurl_progress { _env, "fetchurl_progress" };
+
 	class Invalid_download_url : Exception { };
 
 	/**
@@ -89,12 +96,20 @@ struct Depot_download_manager::Main
 
 	Expanding_reporter _init_config { _env, "config", "init_config" };
 
+	/**
+	 * Report of the processing stage of each archive of the current import
+	 */
+	Expanding_reporter _state_reporter { _env, "progress", "state" };
+
+	void _generate_state_report();
+
 	/**
 	 * Version counters, used to enforce the restart or reconfiguration of
 	 * components.
 	 */
 	Depot_query_version _depot_query_count { 1 };
 	Fetchurl_version    _fetchurl_count    { 1 };
+	Extract_version     _extract_count     { 1 };
 
 	Archive::User _next_user { };
 
@@ -124,6 +139,7 @@ struct Depot_download_manager::Main
 		_current_user.sigh(_query_result_handler);
 		_init_state  .sigh(_init_state_handler);
 		_verified    .sigh(_init_state_handler);
+		_fetchurl_progress.sigh(_init_state_handler);
 
 		_generate_init_config();
 	}
@@ -188,18 +204,52 @@ void Depot_download_manager::Main::_generate_init_config(Xml_generator &xml)
 		xml.node("start", [&] () {
 			gen_verify_start_content(xml, *_import, _current_user_path()); });
 
-	if (_import.constructed() && _import->verified_archives_available()) {
+	if (_import.constructed() && _import->extraction_in_progress()) {
 
 		xml.node("start", [&] () {
 			gen_chroot_start_content(xml, _current_user_name());  });
 
 		xml.node("start", [&] () {
 			gen_extract_start_content(xml, *_import, _current_user_path(),
-			                          _current_user_name()); });
+			                          _current_user_name(), _extract_count); });
 	}
 }
 
 
+void Depot_download_manager::Main::_generate_state_report()
+{
+	_state_reporter.generate([&] (Xml_generator &xml) {
+
+		if (!_import.constructed())
+			return;
+
+		Xml_node const fetchurl_progress = _fetchurl_progress.xml();
+
+		_import->for_each_archive([&] (Archive::Path const &path,
+		                               char const *state) {
+			xml.node("archive", [&] () {
+				xml.attribute("path",  path);
+				xml.attribute("state", state);
+
+				if (strcmp(state, "download"))
+					return;
+
+				/* supplement the byte counts of the archive download */
+				Path const download_path("/download/", path, ".tar.xz");
+				fetchurl_progress.for_each_sub_node("fetch", [&] (Xml_node fetch) {
+					if (fetch.attribute_value("path", Path()) != download_path)
+						return;
+
+					typedef String<32> Value;
+					xml.attribute("total", fetch.attribute_value("total", Value()));
+					xml.attribute("now",   fetch.attribute_value("now",   Value()));
+				});
+			});
+		});
+	});
+}
+
+
 void Depot_download_manager::Main::_handle_query_result()
 {
 	/* finish current import before starting a new one */
@@ -234,6 +284,7 @@ void Depot_download_manager::Main::_handle_query_result()
 
 	/* spawn fetchurl */
 	_generate_init_config();
+	_generate_state_report();
 }
 
 
@@ -241,6 +292,7 @@ void Depot_download_manager::Main::_handle_init_state()
 {
 	_init_state.update();
 	_verified.update();
+	_fetchurl_progress.update();
 
 	bool reconfigure_init = false;
 	bool import_finished  = false;
@@ -252,9 +304,37 @@ void Depot_download_manager::Main::_handle_init_state()
 
 	if (import.downloads_in_progress()) {
 
+		/*
+		 * Hand over each archive to the verification as soon as the
+		 * archive and its signature are downloaded, while the remaining
+		 * downloads are still in progress.
+		 */
+		_fetchurl_progress.xml().for_each_sub_node("fetch", [&] (Xml_node fetch) {
+
+			typedef String<16> State;
+			State const state = fetch.attribute_value("state", State());
+
+			Path const abs_path = fetch.attribute_value("path", Path());
+			char const * const prefix = "/download/";
+			size_t const prefix_len = strlen(prefix);
+			if (strcmp(abs_path.string(), prefix, prefix_len))
+				return;
+
+			Path const path(abs_path.string() + prefix_len);
+
+			if (state == "pending" || state == "active")
+				import.fetch_progress(path, false);
+
+			/* start the verification of a newly downloaded archive */
+			if (state == "complete" && import.fetch_progress(path, true))
+				reconfigure_init = true;
+		});
+
 		Child_exit_state const fetchurl_state(_init_state.xml(), "fetchurl");
 
-		if (fetchurl_state.exited && fetchurl_state.code != 0) {
+		bool const current = (fetchurl_state.version == _fetchurl_count.value);
+
+		if (current && fetchurl_state.exited && fetchurl_state.code != 0) {
 			error("fetchurl failed with exit code ", fetchurl_state.code);
 
 			/* retry by incrementing the version attribute of the start node */
@@ -262,7 +342,7 @@ void Depot_download_manager::Main::_handle_init_state()
 			reconfigure_init = true;
 		}
 
-		if (fetchurl_state.exited && fetchurl_state.code == 0) {
+		if (current && fetchurl_state.exited && fetchurl_state.code == 0) {
 			import.all_downloads_completed();
 
 			/* kill fetchurl, start untar */
@@ -291,29 +371,50 @@ void Depot_download_manager::Main::_handle_init_state()
 					      "(", node.attribute_value("reason", String<64>()), ")");
 					import.archive_verification_failed(path);
 				}
-			}
 
-			reconfigure_init = true;
+				reconfigure_init = true;
+			}
 		});
 	}
 
-	if (import.verified_archives_available()) {
+	if (import.extraction_in_progress()) {
 
 		Child_exit_state const extract_state(_init_state.xml(), "extract");
 
-		if (extract_state.exited && extract_state.code != 0)
+		bool const current = (extract_state.version == _extract_count.value);
+
+		if (current && extract_state.exited && extract_state.code != 0)
 			error("extract failed with exit code ", extract_state.code);
 
-		if (extract_state.exited && extract_state.code == 0) {
-			import.all_verified_archives_extracted();
-			import_finished = true;
+		if (current && extract_state.exited && extract_state.code == 0) {
+			import.all_extracting_archives_unpacked();
 
-			/* kill extract, re-issue new depot query to start next iteration */
-			_depot_query_count.value++;
+			/* kill extract */
 			reconfigure_init = true;
 		}
 	}
 
+	/*
+	 * Extract the archives verified so far while the other archives are
+	 * still being downloaded or verified. Each batch is processed by a new
+	 * instance of the 'extract' component.
+	 */
+	if (!import.extraction_in_progress() && import.verified_archives_available()) {
+		import.start_extraction();
+		_extract_count.value++;
+		reconfigure_init = true;
+	}
+
+	if (import.completed()) {
+		import_finished = true;
+
+		/* re-issue new depot query to start next iteration */
+		_depot_query_count.value++;
+		reconfigure_init = true;
+	}
+
+	_generate_state_report();
+
 	if (import_finished)
 		_import.destruct();
 
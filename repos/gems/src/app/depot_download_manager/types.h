@@ -28,6 +28,7 @@ namespace Depot_download_manager {
 
 	struct Depot_query_version { unsigned value; };
 	struct Fetchurl_version    { unsigned value; };
+	struct Extract_version     { unsigned value; };
 }
 
 namespace Genode {
@@ -15,6 +15,7 @@
 #include <base/component.h>
 #include <base/heap.h>
 #include <base/attached_rom_dataspace.h>
+#include <util/avl_string.h>
 #include <os/reporter.h>
 #include <gems/vfs.h>
 #include <depot/archive.h>
@@ -22,6 +23,8 @@
 namespace Depot_query {
 	using namespace Depot;
 	struct Recursion_limit;
+	struct Path_set;
+	struct Archive_info;
 	struct Dependencies;
 	struct Main;
 }
@@ -63,76 +66,251 @@ class Depot_query::Recursion_limit : Noncopyable
 
 
 /**
- * Collection of dependencies
+ * Set of unique archive paths
  *
- * This data structure keeps track of a list of archive paths along with the
- * information of whether or not the archive is present in the depot. It also
- * ensures that all entries are unique.
+ * The entries are kept in insertion order and indexed by an AVL tree for
+ * the lookup.
  */
-class Depot_query::Dependencies
+class Depot_query::Path_set : Noncopyable
 {
 	private:
 
-		struct Collection : Noncopyable
+		Allocator &_alloc;
+
+		struct Entry : Avl_string<Archive::Path::capacity()>
 		{
-			Allocator &_alloc;
+			Registry<Entry>::Element _element;
 
-			typedef Registered_no_delete<Archive::Path> Entry;
+			Entry(Registry<Entry> &registry, Archive::Path const &path)
+			: Avl_string(path.string()), _element(registry, *this) { }
 
-			Registry<Entry> _entries;
+			Archive::Path path() const { return Archive::Path(name()); }
+		};
 
-			Collection(Allocator &alloc) : _alloc(alloc) { }
+		Registry<Entry>           _entries { };
+		Avl_tree<Avl_string_base> _index   { };
 
-			~Collection()
-			{
-				_entries.for_each([&] (Entry &e) { destroy(_alloc, &e); });
-			}
+	public:
+
+		Path_set(Allocator &alloc) : _alloc(alloc) { }
+
+		~Path_set()
+		{
+			_entries.for_each([&] (Entry &e) {
+				_index.remove(&e);
+				destroy(_alloc, &e);
+			});
+		}
+
+		bool known(Archive::Path const &path)
+		{
+			Avl_string_base * const first = _index.first();
+			return first && first->find_by_name(path.string());
+		}
+
+		/**
+		 * Insert path
+		 *
+		 * \return false if the path was already present
+		 */
+		bool insert(Archive::Path const &path)
+		{
+			if (known(path))
+				return false;
+
+			_index.insert(new (_alloc) Entry(_entries, path));
+			return true;
+		}
+
+		template <typename FN>
+		void for_each(FN const &fn) const
+		{
+			_entries.for_each([&] (Entry const &e) { fn(e.path()); });
+		}
+};
+
+
+/**
+ * Cache of archive meta data
+ *
+ * The presence of an archive and the content of its meta-data files
+ * ('archives', 'used_apis') are kept in memory while a query is processed.
+ * So archives shared by several queried packages are read only once. The
+ * depot content may change between queries, e.g., by a download or the
+ * removal of an archive. Therefore, each query starts with an empty cache.
+ * Archives and files that are not present are not cached.
+ */
+class Depot_query::Archive_info : Noncopyable
+{
+	private:
+
+		Allocator &_alloc;
+		Directory &_depot;
+
+		/*
+		 * Meta-data file of an archive, keyed by '<archive>/<file>'
+		 */
+		struct Meta_file : Avl_string<Directory::Path::capacity()>
+		{
+			Allocator &_alloc;
 
-			bool known(Archive::Path const &path) const
+			struct Line : List<Line>::Element
 			{
-				bool result = false;
-				_entries.for_each([&] (Entry const &entry) {
-					if (path == entry)
-						result = true; });
+				Archive::Path const path;
+
+				Line(Archive::Path const &path) : path(path) { }
+			};
 
-				return result;
+			List<Line> _lines { };
+
+			Meta_file(Allocator &alloc, Directory::Path const &key,
+			     File_content const &content)
+			:
+				Avl_string(key.string()), _alloc(alloc)
+			{
+				Line *last = nullptr;
+				content.for_each_line<Archive::Path>([&] (Archive::Path const &path) {
+					Line * const line = new (_alloc) Line(path);
+					_lines.insert(line, last);
+					last = line;
+				});
 			}
 
-			void insert(Archive::Path const &path)
+			~Meta_file()
 			{
-				if (!known(path))
-					new (_alloc) Entry(_entries, path);
+				while (Line * const line = _lines.first()) {
+					_lines.remove(line);
+					destroy(_alloc, line);
+				}
 			}
 
 			template <typename FN>
-			void for_each(FN const &fn) const { _entries.for_each(fn); };
+			void for_each_line(FN const &fn) const
+			{
+				for (Line const *l = _lines.first(); l; l = l->next())
+					fn(l->path);
+			}
 		};
 
-		Directory const &_depot;
+		Avl_tree<Avl_string_base> _files   { };
+		Path_set                  _present { _alloc };
+
+	public:
+
+		Archive_info(Allocator &alloc, Directory &depot)
+		: _alloc(alloc), _depot(depot) { }
+
+		~Archive_info()
+		{
+			while (Avl_string_base * const file = _files.first()) {
+				_files.remove(file);
+				destroy(_alloc, static_cast<Meta_file *>(file));
+			}
+		}
+
+		bool present(Archive::Path const &path)
+		{
+			if (_present.known(path))
+				return true;
+
+			if (!_depot.directory_exists(path))
+				return false;
+
+			_present.insert(path);
+			return true;
+		}
+
+		/**
+		 * Call 'fn' for each line of the meta-data file 'name' of 'archive'
+		 *
+		 * \throw Directory::Nonexistent_directory
+		 * \throw File_content::Nonexistent_file
+		 * \throw File_content::Truncated_during_read
+		 */
+		template <typename FN>
+		void for_each_line(Archive::Path const &archive, char const *name,
+		                   FN const &fn)
+		{
+			Directory::Path const key(archive, "/", name);
+
+			Avl_string_base * const first = _files.first();
+			Meta_file *file = first ? static_cast<Meta_file *>(first->find_by_name(key.string()))
+			                   : nullptr;
+			if (!file) {
+				File_content const content(_alloc, Directory(_depot, archive),
+				                           name, File_content::Limit{16*1024});
+
+				file = new (_alloc) Meta_file(_alloc, key, content);
+				_files.insert(file);
+			}
+
+			file->for_each_line(fn);
+		}
+};
+
+
+/**
+ * Collection of dependencies
+ *
+ * This data structure keeps track of a list of archive paths along with the
+ * information of whether or not the archive is present in the depot. It also
+ * ensures that all entries are unique.
+ *
+ * All dependencies of one query are collected in a single pass. The
+ * archives visited so far are remembered per kind of traversal so that
+ * dependency graphs shared by several queried archives are walked only once.
+ */
+class Depot_query::Dependencies
+{
+	private:
+
+		Archive_info &_archive_info;
 
-		Collection _present;
-		Collection _missing;
+		Path_set _present;
+		Path_set _missing;
+
+		Path_set _visited_source;
+		Path_set _visited_binary;
 
 	public:
 
-		Dependencies(Allocator &alloc, Directory const &depot)
+		Dependencies(Allocator &alloc, Archive_info &archive_info)
 		:
-			_depot(depot), _present(alloc), _missing(alloc)
+			_archive_info(archive_info),
+			_present(alloc), _missing(alloc),
+			_visited_source(alloc), _visited_binary(alloc)
 		{ }
 
-		bool known(Archive::Path const &path) const
+		bool known(Archive::Path const &path)
 		{
 			return _present.known(path) || _missing.known(path);
 		}
 
 		void record(Archive::Path const &path)
 		{
-			if (_depot.directory_exists(path))
+			if (known(path))
+				return;
+
+			if (_archive_info.present(path))
 				_present.insert(path);
 			else
 				_missing.insert(path);
 		}
 
+		/**
+		 * Mark archive as visited by the source-dependency traversal
+		 *
+		 * \return false if the archive was visited before
+		 */
+		bool visit_source(Archive::Path const &path) { return _visited_source.insert(path); }
+
+		/**
+		 * Mark archive as visited by the binary-dependency traversal
+		 *
+		 * \return false if the archive was visited before
+		 */
+		bool visit_binary(Archive::Path const &path) { return _visited_binary.insert(path); }
+
 		void xml(Xml_generator &xml) const
 		{
 			_present.for_each([&] (Archive::Path const &path) {
@@ -158,6 +336,8 @@ struct Depot_query::Main
 
 	Directory _depot_dir { _root, "depot" };
 
+	Reconstructible<Archive_info> _archive_info { _heap, _depot_dir };
+
 	Signal_handler<Main> _config_handler {
 		_env.ep(), *this, &Main::_handle_config };
 
@@ -254,6 +434,9 @@ struct Depot_query::Main
 
 		_architecture = query.attribute_value("arch", Architecture());
 
+		/* drop the meta data of the previous query */
+		_archive_info.construct(_heap, _depot_dir);
+
 		if (_directory_reporter.constructed()) {
 			_directory_reporter->generate([&] (Xml_generator &xml) {
 				query.for_each_sub_node("scan", [&] (Xml_node node) {
@@ -281,7 +464,7 @@ struct Depot_query::Main
 
 		if (_dependencies_reporter.constructed()) {
 			_dependencies_reporter->generate([&] (Xml_generator &xml) {
-				Dependencies dependencies(_heap, _depot_dir);
+				Dependencies dependencies(_heap, *_archive_info);
 				query.for_each_sub_node("dependencies", [&] (Xml_node node) {
 
 					Archive::Path const path = node.attribute_value("path", Archive::Path());
@@ -337,20 +520,14 @@ Depot_query::Main::_find_rom_in_pkg(Directory::Path const &pkg_path,
                                     Rom_label       const &rom_label,
                                     Recursion_limit        recursion_limit)
 {
-	/*
-	 * \throw Directory::Nonexistent_directory
-	 */
-	Directory pkg_dir(_depot_dir, pkg_path);
+	Archive::Path result;
 
 	/*
+	 * \throw Directory::Nonexistent_directory
 	 * \throw Directory::Nonexistent_file
 	 * \throw File::Truncated_during_read
 	 */
-	File_content archives(_heap, pkg_dir, "archives", File_content::Limit{16*1024});
-
-	Archive::Path result;
-
-	archives.for_each_line<Archive::Path>([&] (Archive::Path const &archive_path) {
+	_archive_info->for_each_line(pkg_path, "archives", [&] (Archive::Path const &archive_path) {
 
 		/*
 		 * \throw Archive::Unknown_archive_type
@@ -474,14 +651,19 @@ void Depot_query::Main::_collect_source_dependencies(Archive::Path const &path,
 
 	dependencies.record(path);
 
+	/* dependencies of a missing archive are unknown */
+	if (!_archive_info->present(path))
+		return;
+
+	/* skip archive already resolved within the current query */
+	if (!dependencies.visit_source(path))
+		return;
+
 	switch (Archive::type(path)) {
 
 	case Archive::PKG:
 		try {
-			File_content archives(_heap, Directory(_depot_dir, path),
-			                      "archives", File_content::Limit{16*1024});
-
-			archives.for_each_line<Archive::Path>([&] (Archive::Path const &path) {
+			_archive_info->for_each_line(path, "archives", [&] (Archive::Path const &path) {
 				_collect_source_dependencies(path, dependencies, recursion_limit); });
 		}
 		catch (File_content::Nonexistent_file) { }
@@ -489,11 +671,7 @@ void Depot_query::Main::_collect_source_dependencies(Archive::Path const &path,
 
 	case Archive::SRC:
 		try {
-			File_content used_apis(_heap, Directory(_depot_dir, path),
-			                       "used_apis", File_content::Limit{16*1024});
-
-			typedef String<160> Api;
-			used_apis.for_each_line<Archive::Path>([&] (Api const &api) {
+			_archive_info->for_each_line(path, "used_apis", [&] (Archive::Path const &api) {
 				dependencies.record(Archive::Path(Archive::user(path), "/api/", api));
 			});
 		}
@@ -522,10 +700,10 @@ void Depot_query::Main::_collect_binary_dependencies(Archive::Path const &path,
 		try {
 			dependencies.record(path);
 
-			File_content archives(_heap, Directory(_depot_dir, path),
-			                      "archives", File_content::Limit{16*1024});
+			if (!_archive_info->present(path) || !dependencies.visit_binary(path))
+				break;
 
-			archives.for_each_line<Archive::Path>([&] (Archive::Path const &archive_path) {
+			_archive_info->for_each_line(path, "archives", [&] (Archive::Path const &archive_path) {
 				_collect_binary_dependencies(archive_path, dependencies, recursion_limit); });
 
 		} catch (File_content::Nonexistent_file) { }
@@ -104,20 +104,28 @@ class Scene : public Nano3d::Scene<PT>
 	public:
 
 		Scene(Genode::Env &env, unsigned update_rate_ms,
-		      Nitpicker::Point pos, Nitpicker::Area size)
+		      Nitpicker::Point pos, Nitpicker::Area size, unsigned threads)
 		:
-			Nano3d::Scene<PT>(env, update_rate_ms, pos, size),
+			Nano3d::Scene<PT>(env, update_rate_ms, pos, size, threads),
 			_env(env), _size(size),
 			_config_handler(env.ep(), *this, &Scene::_handle_config)
 		{
 			_config.sigh(_config_handler);
 			_handle_config();
+
+			for (unsigned i = 0; i < this->threads(); i++) {
+				_shaded_painters[i].construct(_heap, _size.h());
+				_textured_painters[i].construct(_heap, _size.h());
+			}
 		}
 
 	private:
 
-		Polygon::Shaded_painter   _shaded_painter   { _heap, _size.h() };
-		Polygon::Textured_painter _textured_painter { _heap, _size.h() };
+		enum { MAX_THREADS = Nano3d::Scene<PT>::MAX_THREADS };
+
+		/* painters keep state while painting, hence each thread uses its own */
+		Genode::Constructible<Polygon::Shaded_painter>   _shaded_painters[MAX_THREADS];
+		Genode::Constructible<Polygon::Textured_painter> _textured_painters[MAX_THREADS];
 
 		Nano3d::Cube_shape         const _cube         { 7000 };
 		Nano3d::Dodecahedron_shape const _dodecahedron { 10000 };
@@ -126,7 +134,7 @@ class Scene : public Nano3d::Scene<PT>
 		void _render_shape(Genode::Surface<PT>                   &pixel,
 		                   Genode::Surface<Genode::Pixel_alpha8> &alpha,
 		                   SHAPE const &shape, unsigned frame,
-		                   bool backward_facing)
+		                   bool backward_facing, unsigned thread)
 		{
 			typedef Genode::Color Color;
 
@@ -166,8 +174,8 @@ class Scene : public Nano3d::Scene<PT>
 						point = Textured_point(vertex.x(), vertex.y(), u, v);
 					}
 
-					_textured_painter.paint(pixel, alpha, points, num_vertices,
-					                        _texture.texture);
+					_textured_painters[thread]->paint(pixel, alpha, points,
+					                                  num_vertices, _texture.texture);
 				});
 			}
 
@@ -195,8 +203,8 @@ class Scene : public Nano3d::Scene<PT>
 						point = Shaded_point(v.x(), v.y(), color);
 					}
 
-					_shaded_painter.paint(pixel, alpha,
-					                      points, num_vertices);
+					_shaded_painters[thread]->paint(pixel, alpha,
+					                                points, num_vertices);
 				});
 			}
 		}
@@ -209,17 +217,24 @@ class Scene : public Nano3d::Scene<PT>
 		void render(Genode::Surface<PT>                   &pixel,
 		            Genode::Surface<Genode::Pixel_alpha8> &alpha) override
 		{
-			unsigned const frame = (this->elapsed_ms()/10) % 1024;
+			render_band(pixel, alpha, 0);
+		}
+
+		void render_band(Genode::Surface<PT>                   &pixel,
+		                 Genode::Surface<Genode::Pixel_alpha8> &alpha,
+		                 unsigned                               thread) override
+		{
+			unsigned const frame = (this->frame_ms()/10) % 1024;
 
 			if (_shape == SHAPE_DODECAHEDRON) {
 
-				_render_shape(pixel, alpha, _dodecahedron, frame, true);
-				_render_shape(pixel, alpha, _dodecahedron, frame, false);
+				_render_shape(pixel, alpha, _dodecahedron, frame, true,  thread);
+				_render_shape(pixel, alpha, _dodecahedron, frame, false, thread);
 
 			} else if (_shape == SHAPE_CUBE) {
 
-				_render_shape(pixel, alpha, _cube, frame, true);
-				_render_shape(pixel, alpha, _cube, frame, false);
+				_render_shape(pixel, alpha, _cube, frame, true,  thread);
+				_render_shape(pixel, alpha, _cube, frame, false, thread);
 			}
 		}
 };
@@ -229,7 +244,11 @@ void Component::construct(Genode::Env &env)
 {
 	enum { UPDATE_RATE_MS = 20 };
 
+	/* the number of rendering threads is evaluated at startup only */
+	unsigned const threads = Genode::Attached_rom_dataspace(env, "config")
+	                         .xml().attribute_value("threads", 1U);
+
 	static Scene<Genode::Pixel_rgb565>
 		scene(env, UPDATE_RATE_MS,
-		      Nitpicker::Point(-200, -200), Nitpicker::Area(400, 400));
+		      Nitpicker::Point(-200, -200), Nitpicker::Area(400, 400), threads);
 }
@@ -0,0 +1,167 @@
+/*
+ * \brief  Cache of pre-composed window backgrounds
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _BACKGROUND_CACHE_H_
+#define _BACKGROUND_CACHE_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <util/string.h>
+
+/* local includes */
+#include "theme.h"
+
+namespace Decorator { class Background_cache; }
+
+
+/**
+ * Cache of backgrounds painted by 'Theme::draw_background'
+ *
+ * Painting the background stretches the theme texture over the whole
+ * decoration buffer. The result depends only on the buffer size and the
+ * alpha value of the window, which is the same for all unfocused and all
+ * focused windows. Hence, windows of equal size share the cached result,
+ * and repainting a decoration merely copies it.
+ *
+ * The theme is immutable, so the cached backgrounds remain valid for the
+ * lifetime of the cache. If all slots are occupied, the least recently
+ * used entry is replaced.
+ */
+class Decorator::Background_cache
+{
+	public:
+
+		enum { NUM_ENTRIES = 16 };
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Background_cache(Background_cache const &);
+		Background_cache &operator = (Background_cache const &);
+
+		Theme       const &_theme;
+		Genode::Allocator &_alloc;
+
+		struct Entry
+		{
+			Area           size      { };
+			unsigned       alpha     = 0;
+			unsigned long  last_used = 0;
+			Pixel_rgb888  *pixel     = nullptr;
+			Pixel_alpha8  *mask      = nullptr;
+
+			bool matches(Area s, unsigned a) const
+			{
+				return pixel && a == alpha && s.w() == size.w() && s.h() == size.h();
+			}
+		};
+
+		Entry _entries[NUM_ENTRIES];
+
+		unsigned long _now = 0;
+
+		void _release(Entry &entry)
+		{
+			if (!entry.pixel)
+				return;
+
+			_alloc.free(entry.pixel, entry.size.count()*sizeof(Pixel_rgb888));
+			_alloc.free(entry.mask,  entry.size.count()*sizeof(Pixel_alpha8));
+
+			entry = Entry();
+		}
+
+		/**
+		 * Paint background into the buffers of 'entry'
+		 */
+		void _paint(Entry &entry)
+		{
+			Genode::size_t const num_pixels = entry.size.count();
+
+			/* same initial state as 'Nitpicker_buffer::reset_surface' */
+			Pixel_rgb888 const gray(127, 127, 127, 255);
+			for (Genode::size_t i = 0; i < num_pixels; i++)
+				entry.pixel[i] = gray;
+
+			Genode::memset(entry.mask, 0, num_pixels*sizeof(Pixel_alpha8));
+
+			Pixel_surface pixel(entry.pixel, entry.size);
+			Alpha_surface alpha(entry.mask,  entry.size);
+
+			_theme.draw_background(pixel, alpha, entry.alpha);
+		}
+
+		Entry &_lookup(Area size, unsigned alpha)
+		{
+			Entry *victim = &_entries[0];
+
+			for (unsigned i = 0; i < NUM_ENTRIES; i++) {
+
+				Entry &entry = _entries[i];
+
+				if (entry.matches(size, alpha))
+					return entry;
+
+				if (entry.last_used < victim->last_used)
+					victim = &entry;
+			}
+
+			_release(*victim);
+
+			Genode::size_t const num_pixels = size.count();
+
+			victim->pixel = (Pixel_rgb888 *)_alloc.alloc(num_pixels*sizeof(Pixel_rgb888));
+			victim->mask  = (Pixel_alpha8 *)_alloc.alloc(num_pixels*sizeof(Pixel_alpha8));
+			victim->size  = size;
+			victim->alpha = alpha;
+
+			_paint(*victim);
+
+			return *victim;
+		}
+
+	public:
+
+		Background_cache(Theme const &theme, Genode::Allocator &alloc)
+		: _theme(theme), _alloc(alloc) { }
+
+		~Background_cache()
+		{
+			for (unsigned i = 0; i < NUM_ENTRIES; i++)
+				_release(_entries[i]);
+		}
+
+		/**
+		 * Initialize surfaces with the background for the given alpha value
+		 *
+		 * This is equivalent to resetting the surfaces followed by
+		 * 'Theme::draw_background'. Both surfaces must have the same size.
+		 */
+		void draw(Pixel_surface &pixel, Alpha_surface &alpha, unsigned alpha_value)
+		{
+			Area const size = pixel.size();
+
+			if (!size.valid())
+				return;
+
+			Entry &entry = _lookup(size, alpha_value);
+			entry.last_used = ++_now;
+
+			Genode::memcpy(pixel.addr(), entry.pixel, size.count()*sizeof(Pixel_rgb888));
+			Genode::memcpy(alpha.addr(), entry.mask,  size.count()*sizeof(Pixel_alpha8));
+		}
+};
+
+#endif /* _BACKGROUND_CACHE_H_ */
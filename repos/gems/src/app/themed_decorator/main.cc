@@ -75,6 +75,8 @@ struct Decorator::Main : Window_factory_base
 
 	Theme _theme { _env.ram(), _env.rm(), _heap };
 
+	Background_cache _background_cache { _theme, _heap };
+
 	Reporter _decorator_margins_reporter = { _env, "decorator_margins" };
 
 	/**
@@ -167,7 +169,7 @@ struct Decorator::Main : Window_factory_base
 	{
 		return new (_heap)
 			Window(_env, attribute(window_node, "id", 0UL), _nitpicker, _animator,
-			       _theme, _decorator_config);
+			       _theme, _background_cache, _decorator_config);
 	}
 
 	/**
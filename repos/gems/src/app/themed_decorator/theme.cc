@@ -254,6 +254,7 @@ void Decorator::Theme::draw_background(Decorator::Pixel_surface &pixel_surface,
 	}
 
 	pixel_surface.clip(orig_clip);
+	alpha_surface.clip(orig_clip);
 }
 
 
@@ -32,6 +32,7 @@
 #include "theme.h"
 #include "config.h"
 #include "tint_painter.h"
+#include "background_cache.h"
 
 namespace Decorator {
 
@@ -49,6 +50,8 @@ class Decorator::Window : public Window_base, public Animator::Item
 
 		Theme const &_theme;
 
+		Background_cache &_background_cache;
+
 		/*
 		 * Flag indicating that the current window position has been propagated
 		 * to the window's corresponding nitpicker views.
@@ -281,12 +284,23 @@ class Decorator::Window : public Window_base, public Animator::Item
 
 		void _repaint_decorations(Nitpicker_buffer &buffer)
 		{
-			buffer.reset_surface();
+			/*
+			 * While fading, the alpha value changes with each frame. Painting
+			 * those transient backgrounds directly keeps them from evicting
+			 * the backgrounds of the other windows from the cache.
+			 */
+			bool const fading = ((int)_alpha != _alpha.dst());
+
+			if (fading)
+				buffer.reset_surface();
 
 			buffer.apply_to_surface([&] (Pixel_surface &pixel,
 			                             Alpha_surface &alpha) {
 
-				_theme.draw_background(pixel, alpha, (int)_alpha);
+				if (fading)
+					_theme.draw_background(pixel, alpha, (int)_alpha);
+				else
+					_background_cache.draw(pixel, alpha, (int)_alpha);
 
 				_theme.draw_title(pixel, alpha, _title.string());
 				
@@ -316,11 +330,13 @@ class Decorator::Window : public Window_base, public Animator::Item
 	public:
 
 		Window(Genode::Env &env, unsigned id, Nitpicker::Session_client &nitpicker,
-		       Animator &animator, Theme const &theme, Config const &config)
+		       Animator &animator, Theme const &theme,
+		       Background_cache &background_cache, Config const &config)
 		:
 			Window_base(id),
 			Animator::Item(animator),
-			_env(env),_theme(theme), _animator(animator),
+			_env(env),_theme(theme), _background_cache(background_cache),
+			_animator(animator),
 			_nitpicker(nitpicker), _config(config)
 		{
 			_reallocate_nitpicker_buffers();
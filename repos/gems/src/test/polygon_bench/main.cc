@@ -0,0 +1,123 @@
+/*
+ * \brief  Benchmark of the polygon_gfx painters
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The benchmark paints triangles of different sizes at pseudo-random
+ * positions into RAM surfaces and reports the painted triangles per second.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <os/pixel_alpha8.h>
+#include <polygon_gfx/shaded_polygon_painter.h>
+#include <polygon_gfx/interpolate_rgb565.h>
+#include <polygon_gfx/textured_polygon_painter.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	typedef Pixel_rgb565 PT;
+
+	enum { W = 1024, H = 768, TEX_SIZE = 128, DURATION_MS = 1000 };
+
+	Env &_env;
+
+	Timer::Connection _timer { _env };
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Attached_ram_dataspace _pixel_ds { _env.ram(), _env.rm(), W*H*sizeof(PT) };
+	Attached_ram_dataspace _alpha_ds { _env.ram(), _env.rm(), W*H };
+
+	Surface<PT>           _pixel { _pixel_ds.local_addr<PT>(), Surface_base::Area(W, H) };
+	Surface<Pixel_alpha8> _alpha { _alpha_ds.local_addr<Pixel_alpha8>(), Surface_base::Area(W, H) };
+
+	Attached_ram_dataspace _tex_pixel_ds { _env.ram(), _env.rm(), TEX_SIZE*TEX_SIZE*sizeof(PT) };
+	Attached_ram_dataspace _tex_alpha_ds { _env.ram(), _env.rm(), TEX_SIZE*TEX_SIZE };
+
+	Texture<PT> _texture { _tex_pixel_ds.local_addr<PT>(),
+	                       _tex_alpha_ds.local_addr<unsigned char>(),
+	                       Surface_base::Area(TEX_SIZE, TEX_SIZE) };
+
+	Polygon::Shaded_painter   _shaded_painter   { _heap, H };
+	Polygon::Textured_painter _textured_painter { _heap, H };
+
+	unsigned _seed = 1;
+
+	int _random(int max) { return (_seed = _seed*1103515245 + 12345) % max; }
+
+	/**
+	 * Paint triangles via 'fn' until 'DURATION_MS' elapsed
+	 *
+	 * \param fn  functor called with the position and size of a triangle
+	 */
+	template <typename FN>
+	void _measure(char const *painter, int size, FN const &fn)
+	{
+		enum { BATCH = 64 };
+
+		unsigned long triangles = 0;
+		unsigned long const start_ms = _timer.elapsed_ms();
+		unsigned long       end_ms   = start_ms;
+		for (; end_ms - start_ms < DURATION_MS; end_ms = _timer.elapsed_ms()) {
+			for (unsigned i = 0; i < BATCH; i++)
+				fn(_random(W - size), _random(H - size), size);
+			triangles += BATCH;
+		}
+
+		log("  ", painter, " ", size, "x", size, ": ",
+		    (triangles*1000) / (end_ms - start_ms), " triangles/s");
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("--- polygon benchmark ---");
+
+		for (unsigned i = 0; i < TEX_SIZE*TEX_SIZE; i++) {
+			_tex_pixel_ds.local_addr<PT>()[i] = PT(i & 0xff, i >> 7, 128);
+			_tex_alpha_ds.local_addr<unsigned char>()[i] = (i*7) & 0xff;
+		}
+
+		int const sizes[] = { 16, 64, 256 };
+
+		for (int size : sizes) {
+
+			_measure("shaded", size, [&] (int x, int y, int s) {
+				typedef Polygon::Shaded_painter::Point Point;
+				Point const points[3] = {
+					Point(x,     y,     Color(255,   0,   0, 255)),
+					Point(x + s, y + s, Color(  0, 255,   0, 128)),
+					Point(x,     y + s, Color(  0,   0, 255,  64)) };
+				_shaded_painter.paint(_pixel, _alpha, points, 3);
+			});
+
+			_measure("textured", size, [&] (int x, int y, int s) {
+				typedef Polygon::Textured_painter::Point Point;
+				Point const points[3] = {
+					Point(x,     y,     0,            0),
+					Point(x + s, y + s, TEX_SIZE - 1, TEX_SIZE - 1),
+					Point(x,     y + s, 0,            TEX_SIZE - 1) };
+				_textured_painter.paint(_pixel, _alpha, points, 3, _texture);
+			});
+		}
+
+		log("--- polygon benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,5 @@
+TARGET = test-polygon_bench
+SRC_CC = main.cc
+LIBS  += base
+
+CC_CXX_WARN_STRICT =
@@ -56,6 +56,17 @@ void lwip_nic_link_state_changed(int state);
 
 #ifdef __cplusplus
 }
+
+namespace Genode { class Entrypoint; }
+
+/**
+ * Handle the signals of the NIC session at entrypoint 'ep'
+ *
+ * By default, a dedicated thread receives the signals of the NIC session.
+ * Components whose entrypoint never blocks in lwIP calls may use their
+ * entrypoint instead. The function must be called before 'lwip_nic_init'.
+ */
+extern "C" void lwip_nic_entrypoint(Genode::Entrypoint &ep);
 #endif
 
 #endif /* __LWIP__GENODE_H__ */
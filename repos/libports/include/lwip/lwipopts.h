@@ -40,6 +40,8 @@
 #define SO_REUSE                    1  /* enable SO_REUSE */
 #define LWIP_WND_SCALE              1  /* enable window scaling */
 #define TCP_RCV_SCALE               2  /* receive scale factor IETF RFC 1323 */
+#define LWIP_SUPPORT_CUSTOM_PBUF    1  /* reference received packets in place */
+#define LWIP_NETIF_TX_SINGLE_PBUF   1  /* assemble outgoing frames contiguously */
 
 #if LWIP_DHCP
 #define LWIP_NETIF_STATUS_CALLBACK  1  /* callback function used for interface changes */
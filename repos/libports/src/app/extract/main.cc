@@ -14,9 +14,12 @@
 /* Genode includes */
 #include <libc/component.h>
 #include <base/attached_rom_dataspace.h>
+#include <base/heap.h>
+#include <timer_session/connection.h>
 
 /* libc includes */
 #include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
 
 /* libarchive includes */
@@ -25,6 +28,7 @@
 
 namespace Extract {
 	using namespace Genode;
+	struct Write_buffer;
 	struct Extracted_archive;
 	struct Main;
 }
@@ -72,6 +76,80 @@ bool create_directories(Genode::String<N> const &path)
 }
 
 
+/**
+ * Buffer for coalescing consecutive data blocks of an archive entry
+ *
+ * The blocks returned by libarchive are as small as the decompressor's
+ * output chunks. Writing each of them individually to the file system would
+ * cost one VFS round trip per block. The buffer collects contiguous blocks
+ * and hands them to the disk writer in one piece.
+ */
+struct Extract::Write_buffer
+{
+	/*
+	 * Noncopyable
+	 */
+	Write_buffer(Write_buffer const &);
+	Write_buffer &operator = (Write_buffer const &);
+
+	Allocator &_alloc;
+
+	size_t const capacity;
+
+	char * const _base = (char *)_alloc.alloc(capacity);
+
+	size_t    _fill   = 0;
+	::int64_t _offset = 0;
+
+	Write_buffer(Allocator &alloc, size_t capacity)
+	: _alloc(alloc), capacity(capacity) { }
+
+	~Write_buffer() { _alloc.free(_base, capacity); }
+
+	/**
+	 * Write buffered data via 'dst'
+	 *
+	 * \return false on error
+	 */
+	bool flush(archive *dst)
+	{
+		if (_fill == 0)
+			return true;
+
+		bool const ok = archive_write_data_block(dst, _base, _fill, _offset)
+		                == ARCHIVE_OK;
+		_fill = 0;
+		return ok;
+	}
+
+	/**
+	 * Append data block at file position 'offset'
+	 *
+	 * \return false on error
+	 */
+	bool write(archive *dst, void const *src, size_t size, ::int64_t offset)
+	{
+		bool const contiguous = (_fill > 0)
+		                     && (offset == _offset + (::int64_t)_fill);
+
+		if ((_fill && !contiguous) || (_fill + size > capacity))
+			if (!flush(dst))
+				return false;
+
+		/* pass large blocks through without copying */
+		if (size >= capacity)
+			return archive_write_data_block(dst, src, size, offset) == ARCHIVE_OK;
+
+		if (_fill == 0)
+			_offset = offset;
+
+		memcpy(_base + _fill, src, size);
+		_fill += size;
+		return true;
+	}
+};
+
+
 struct Extract::Extracted_archive : Noncopyable
 {
 	struct Source : Noncopyable
@@ -103,20 +181,52 @@ struct Extract::Extracted_archive : Noncopyable
 	struct Read_failed  : Exception { };
 	struct Write_failed : Exception { };
 
+	/**
+	 * Number of extracted bytes
+	 */
+	Genode::uint64_t bytes = 0;
+
+	/**
+	 * Extend the file of 'entry' to its final size before writing the data
+	 *
+	 * This way, the file system learns about the size of the file upfront
+	 * instead of growing the file with each write.
+	 */
+	static void _preallocate(archive_entry *entry)
+	{
+		if (archive_entry_filetype(entry) != AE_IFREG)
+			return;
+
+		::int64_t const size = archive_entry_size(entry);
+		if (size <= 0)
+			return;
+
+		int const fd = open(archive_entry_pathname(entry), O_WRONLY);
+		if (fd < 0)
+			return;
+
+		ftruncate(fd, size);
+		close(fd);
+	}
+
 	/**
 	 * Constructor
 	 *
+	 * \param block_size   size of the blocks read from the archive file
+	 * \param buffer       buffer for coalescing writes
+	 * \param preallocate  extend each file to its final size before
+	 *                     writing its content
+	 *
 	 * \throw Open_failed
 	 * \throw Read_failed
 	 * \throw Write_failed
 	 */
-	explicit Extracted_archive(Path const &path)
+	Extracted_archive(Path const &path, size_t block_size,
+	                  Write_buffer &buffer, bool preallocate)
 	{
 		archive_read_support_format_all(src.ptr);
 		archive_read_support_filter_all(src.ptr);
 
-		size_t const block_size = 10240;
-
 		if (archive_read_open_filename(src.ptr, path.string(), block_size))
 			throw Open_failed();
 
@@ -137,6 +247,9 @@ struct Extract::Extracted_archive : Noncopyable
 			if (archive_write_header(dst.ptr, entry) != ARCHIVE_OK)
 				throw Write_failed();
 
+			if (preallocate)
+				_preallocate(entry);
+
 			for (;;) {
 				void const *buf    = nullptr;
 				size_t      size   = 0;
@@ -152,10 +265,15 @@ struct Extract::Extracted_archive : Noncopyable
 						throw Read_failed();
 				}
 
-				if (archive_write_data_block(dst.ptr, buf, size, offset) != ARCHIVE_OK)
+				if (!buffer.write(dst.ptr, buf, size, offset))
 					throw Write_failed();
+
+				bytes += size;
 			}
 
+			if (!buffer.flush(dst.ptr))
+				throw Write_failed();
+
 			if (archive_write_finish_entry(dst.ptr) != ARCHIVE_OK)
 				throw Write_failed();
 		}
@@ -171,14 +289,59 @@ struct Extract::Main
 
 	Attached_rom_dataspace _config { _env, "config" };
 
+	Heap _heap { _env.ram(), _env.rm() };
+
 	bool _verbose = false;
 
+	/*
+	 * The timer is used for measuring the throughput, which is reported in
+	 * verbose mode only.
+	 */
+	Constructible<Timer::Connection> _timer { };
+
+	unsigned long _elapsed_ms() { return _timer.constructed() ? _timer->elapsed_ms() : 0; }
+
+	struct Throughput
+	{
+		Genode::uint64_t bytes;
+		unsigned long    ms;
+
+		void print(Output &out) const
+		{
+			Genode::print(out, bytes/(1024*1024), " MiB in ", ms, " ms");
+			if (ms)
+				Genode::print(out, ", ", (bytes*1000/ms)/(1024*1024), " MiB/s");
+		}
+	};
+
 	void _process_config()
 	{
 		Xml_node const config = _config.xml();
 
 		_verbose = config.attribute_value("verbose", false);
 
+		if (_verbose)
+			_timer.construct(_env);
+
+		enum { DEFAULT_BLOCK_SIZE   = 256*1024,
+		       DEFAULT_WRITE_BUFFER = 512*1024 };
+
+		size_t const block_size =
+			max((size_t)config.attribute_value("block_size",
+			                                   Number_of_bytes(DEFAULT_BLOCK_SIZE)),
+			    (size_t)10240);
+
+		size_t const write_buffer_size =
+			max((size_t)config.attribute_value("write_buffer",
+			                                   Number_of_bytes(DEFAULT_WRITE_BUFFER)),
+			    (size_t)4096);
+
+		bool const preallocate = config.attribute_value("preallocate", false);
+
+		Write_buffer write_buffer(_heap, write_buffer_size);
+
+		Throughput total { 0, 0 };
+
 		config.for_each_sub_node("extract", [&] (Xml_node node) {
 
 			Path const src_path = node.attribute_value("archive", Path());
@@ -186,6 +349,8 @@ struct Extract::Main
 
 			bool success = false;
 
+			Throughput throughput { 0, 0 };
+
 			struct Create_directories_failed { };
 
 			try {
@@ -195,8 +360,13 @@ struct Extract::Main
 				chdir("/");
 				chdir(dst_path.string());
 
-				Extracted_archive extracted_archive(src_path);
+				unsigned long const start_ms = _elapsed_ms();
+
+				Extracted_archive extracted_archive(src_path, block_size,
+				                                    write_buffer, preallocate);
 
+				throughput = Throughput { extracted_archive.bytes,
+				                          _elapsed_ms() - start_ms };
 				success = true;
 			}
 			catch (Create_directories_failed) {
@@ -212,9 +382,16 @@ struct Extract::Main
 			if (!success)
 				throw Exception();
 
+			total.bytes += throughput.bytes;
+			total.ms    += throughput.ms;
+
 			if (_verbose)
-				log("extracted '", src_path, "' to '", dst_path, "'");
+				log("extracted '", src_path, "' to '", dst_path, "' "
+				    "(", throughput, ")");
 		});
+
+		if (_verbose)
+			log("extracted ", total);
 	}
 
 	Main(Env &env) : _env(env)
@@ -50,6 +50,14 @@ class Fetchurl::Fetch : Genode::List<Fetch>::Element
 {
 	friend class Genode::List<Fetch>;
 
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Fetch(Fetch const &);
+		Fetch &operator = (Fetch const &);
+
 	public:
 
 		Main &main;
@@ -63,7 +71,12 @@ class Fetchurl::Fetch : Genode::List<Fetch>::Element
 		double dltotal = 0;
 		double dlnow = 0;
 
-		int fd = -1;
+		enum State { PENDING, ACTIVE, COMPLETE, FAILED };
+
+		State state = PENDING;
+
+		int   fd   = -1;
+		CURL *curl = nullptr;
 
 		Fetch(Main &main, Url const &url, Path const &path, Url const &proxy)
 		: main(main), url(url), path(path), proxy(proxy) { }
@@ -81,10 +94,20 @@ struct Fetchurl::Main
 
 	Timer::Connection _timer { _env, "reporter" };
 
-	Genode::Reporter _reporter { _env, "progress" };
+	/* constructed if progress reporting is enabled */
+	Genode::Constructible<Genode::Expanding_reporter> _reporter { };
 
 	Genode::List<Fetch> _fetches { };
 
+	/*
+	 * Maximum number of transfers processed concurrently
+	 *
+	 * The curl version used does not support 'CURLMOPT_MAX_TOTAL_CONNECTIONS'.
+	 * Hence, the limit is enforced by the number of easy handles added to
+	 * the multi handle at a time.
+	 */
+	unsigned _max_connections = 1;
+
 	Timer::One_shot_timeout<Main> _report_timeout {
 		_timer, *this, &Main::_report };
 
@@ -101,13 +124,30 @@ struct Fetchurl::Main
 		}
 	}
 
+	static char const *_state_name(Fetch::State state)
+	{
+		switch (state) {
+		case Fetch::PENDING:  return "pending";
+		case Fetch::ACTIVE:   return "active";
+		case Fetch::COMPLETE: return "complete";
+		case Fetch::FAILED:   return "failed";
+		}
+		return "";
+	}
+
 	void _report()
 	{
 		using namespace Genode;
-		Reporter::Xml_generator xml_gen(_reporter, [&] {
+
+		if (!_reporter.constructed())
+			return;
+
+		_reporter->generate([&] (Xml_generator &xml_gen) {
 			for (Fetch *f = _fetches.first(); f; f = f->next()) {
 				xml_gen.node("fetch", [&] {
 					xml_gen.attribute("url", f->url);
+					xml_gen.attribute("path", f->path.base());
+					xml_gen.attribute("state", _state_name(f->state));
 					xml_gen.attribute("total", f->dltotal);
 					xml_gen.attribute("now", f->dlnow);
 				});
@@ -134,11 +174,15 @@ struct Fetchurl::Main
 
 				_report_delay = Duration(delay_ms);
 				_schedule_report();
-				_reporter.enabled(true);
+				if (!_reporter.constructed())
+					_reporter.construct(_env, "progress", "progress", _heap);
 			}
 		}
 		catch (...) { }
 
+		_max_connections = Genode::max(1U,
+			config_node.attribute_value("max_connections", 1U));
+
 		auto const parse_fn = [&] (Genode::Xml_node node) {
 			Url url;
 			Path path;
@@ -167,7 +211,12 @@ struct Fetchurl::Main
 		});
 	}
 
-	CURLcode _process_fetch(CURL *_curl, Fetch &_fetch)
+	/**
+	 * Prepare transfer of 'fetch' and add it to the 'multi' handle
+	 *
+	 * \return false if the transfer could not be started
+	 */
+	bool _start_fetch(CURLM *multi, Fetch &_fetch)
 	{
 		char const *out_path = _fetch.path.base();
 
@@ -198,7 +247,7 @@ struct Fetchurl::Main
 			/* create directory for sub path */
 			if (mkdir(sub_path.string(), 0777) < 0) {
 				Genode::error("failed to create directory ", sub_path);
-				return CURLE_FAILED_INIT;
+				return false;
 			}
 		}
 
@@ -216,9 +265,18 @@ struct Fetchurl::Main
 			default:
 				Genode::error("creation of ", out_path, " failed (errno=", errno, ")");
 			}
-			return CURLE_FAILED_INIT;
+			return false;
+		}
+
+		CURL *_curl = curl_easy_init();
+		if (!_curl) {
+			Genode::error("failed to initialize libcurl");
+			close(fd);
+			return false;
 		}
-		_fetch.fd = fd;
+
+		_fetch.fd   = fd;
+		_fetch.curl = _curl;
 
 		curl_easy_setopt(_curl, CURLOPT_URL, _fetch.url.string());
 		curl_easy_setopt(_curl, CURLOPT_FOLLOWLOCATION, true);
@@ -241,39 +299,101 @@ struct Fetchurl::Main
 			curl_easy_setopt(_curl, CURLOPT_PROXY, _fetch.proxy.string());
 		}
 
-		CURLcode res = curl_easy_perform(_curl);
-		close(_fetch.fd);
-		_fetch.fd = -1;
+		curl_multi_add_handle(multi, _curl);
+		_fetch.state = Fetch::ACTIVE;
+		return true;
+	}
+
+	void _finish_fetch(CURLM *multi, Fetch &fetch, CURLcode res)
+	{
+		curl_multi_remove_handle(multi, fetch.curl);
+		curl_easy_cleanup(fetch.curl);
+		fetch.curl = nullptr;
+
+		close(fetch.fd);
+		fetch.fd = -1;
+
+		fetch.state = (res == CURLE_OK) ? Fetch::COMPLETE : Fetch::FAILED;
 
 		if (res != CURLE_OK)
-			Genode::error(curl_easy_strerror(res), ", failed to fetch ", _fetch.url);
-		return res;
+			Genode::error(curl_easy_strerror(res), ", failed to fetch ", fetch.url);
 	}
 
-	int run()
+	Fetch *_lookup(CURL *curl)
 	{
-		CURLcode res = CURLE_OK;
+		for (Fetch *f = _fetches.first(); f; f = f->next())
+			if (f->curl == curl)
+				return f;
+		return nullptr;
+	}
 
-		CURL *curl = curl_easy_init();
-		if (!curl) {
+	int run()
+	{
+		CURLM *multi = curl_multi_init();
+		if (!multi) {
 			Genode::error("failed to initialize libcurl");
 			return -1;
 		}
 
-		if (_reporter.enabled())
+		if (_reporter.constructed())
 			_report();
 
-		for (Fetch *f = _fetches.first(); f; f = f->next()) {
-			if (res != CURLE_OK) break;
-			res = _process_fetch(curl, *f);
+		Fetch   *next   = _fetches.first();
+		unsigned active = 0;
+		CURLcode result = CURLE_OK;
+
+		for (;;) {
+
+			/* do not start new transfers after the first error */
+			for (; result == CURLE_OK && next && active < _max_connections; next = next->next()) {
+				if (_start_fetch(multi, *next))
+					active++;
+				else
+					result = CURLE_FAILED_INIT;
+			}
+
+			if (active == 0)
+				break;
+
+			int running = 0;
+			curl_multi_perform(multi, &running);
+
+			/* collect finished transfers */
+			bool finished = false;
+			int  remaining = 0;
+			while (CURLMsg *msg = curl_multi_info_read(multi, &remaining)) {
+
+				if (msg->msg != CURLMSG_DONE)
+					continue;
+
+				Fetch *fetch = _lookup(msg->easy_handle);
+				if (!fetch)
+					continue;
+
+				CURLcode const res = msg->data.result;
+				_finish_fetch(multi, *fetch, res);
+
+				if (res != CURLE_OK)
+					result = res;
+
+				active--;
+				finished = true;
+			}
+
+			/* let the consumer of the report pick up completed files early */
+			if (finished && _reporter.constructed())
+				_report();
+
+			if (!finished)
+				curl_multi_wait(multi, nullptr, 0, 1000, nullptr);
 		}
 
-		if (_reporter.enabled())
+		if (_reporter.constructed())
 			_report();
 
-		curl_easy_cleanup(curl);
+		curl_multi_cleanup(multi);
 
-		return res ^ CURLE_OK;
+		return result ^ CURLE_OK;
 	}
 };
 
@@ -72,6 +72,7 @@ class Framebuffer::Session_component : public Genode::Rpc_object<Session>
 			/* determine bytes per pixel */
 			int bypp = 0;
 			if (_scr_depth == 16) bypp = 2;
+			if (_scr_depth == 32) bypp = 4;
 			if (!bypp) return;
 
 			/* copy pixels from back buffer to physical frame buffer */
@@ -99,7 +100,7 @@ class Framebuffer::Session_component : public Genode::Rpc_object<Session>
 		{
 			if (!buffered) return;
 
-			if (_scr_depth != 16) {
+			if (_scr_depth != 16 && _scr_depth != 32) {
 				Genode::warning("buffered mode not supported for depth ", _scr_depth);
 				return;
 			}
@@ -141,7 +142,8 @@ class Framebuffer::Session_component : public Genode::Rpc_object<Session>
 		Mode mode() const override
 		{
 			return Mode(_scr_width, _scr_height,
-			            _scr_depth == 16 ? Mode::RGB565 : Mode::INVALID);
+			            _scr_depth == 16 ? Mode::RGB565 :
+			            _scr_depth == 32 ? Mode::RGB888 : Mode::INVALID);
 		}
 
 		void mode_sigh(Genode::Signal_context_capability) override { }
@@ -28,86 +28,290 @@ extern "C" {
 
 /* Genode includes */
 #include <base/thread.h>
+#include <base/entrypoint.h>
+#include <base/lock.h>
 #include <base/log.h>
 #include <nic/packet_allocator.h>
 #include <nic_session/connection.h>
+#include <os/ring_buffer.h>
 
-extern "C" {
+/* LwIP includes */
+#include <lwip/genode.h>
 
-	static void  genode_netif_input(struct netif *netif);
+extern "C" {
 
 	void lwip_nic_link_state_changed(int state);
 }
 
 
+/**
+ * Entrypoint used for handling NIC signals, if defined
+ */
+static Genode::Entrypoint *_nic_ep;
+
+
+void lwip_nic_entrypoint(Genode::Entrypoint &ep) { _nic_ep = &ep; }
+
+
 /*
- * Thread, that receives packets by the nic-session interface.
+ * Interface between lwIP and the nic session
  */
-class Nic_receiver_thread : public Genode::Thread_deprecated<8192>
+class Nic_client
 {
 	private:
 
 		typedef Nic::Packet_descriptor Packet_descriptor;
 
-		Nic::Connection  *_nic;       /* nic-session */
-		Packet_descriptor _rx_packet; /* actual packet received */
-		struct netif     *_netif;     /* LwIP network interface structure */
+		Nic::Connection &_nic;
+		struct netif    &_netif;
+
+		/*
+		 * Custom pbuf referencing the content of a received packet
+		 *
+		 * The packet is acknowledged not before lwIP frees the pbuf.
+		 */
+		struct Rx_pbuf
+		{
+			struct pbuf_custom custom;   /* must be the first member */
+			Nic_client        *client;
+			Packet_descriptor  packet;
+			Rx_pbuf           *next_free;
+		};
+
+		/*
+		 * A received packet occupies the RX buffer of the NIC server as long
+		 * as it is referenced by lwIP. To leave enough room for the server,
+		 * the number of referenced packets is limited. Packets that arrive
+		 * while all 'Rx_pbuf' objects are in use get copied.
+		 */
+		enum { MAX_RX_PBUFS = Nic::Session::QUEUE_SIZE / 4 };
 
-		Genode::Signal_receiver  _sig_rec;
+		Rx_pbuf  _rx_pbufs[MAX_RX_PBUFS];
+		Rx_pbuf *_free_rx_pbufs = nullptr;
 
-		Genode::Io_signal_dispatcher<Nic_receiver_thread> _link_state_dispatcher;
-		Genode::Io_signal_dispatcher<Nic_receiver_thread> _rx_packet_avail_dispatcher;
-		Genode::Io_signal_dispatcher<Nic_receiver_thread> _rx_ready_to_ack_dispatcher;
+		/*
+		 * As lwIP frees pbufs from any of its threads, the acknowledgement of
+		 * RX packets and the allocation of 'Rx_pbuf' objects are serialized.
+		 */
+		Genode::Lock _rx_lock { };
+
+		/*
+		 * Acknowledgements deferred while the acknowledgement queue is full
+		 *
+		 * Besides the referenced packets, at most one copied packet is
+		 * pending because no packet is received while acknowledgements are
+		 * deferred. The deferred acknowledgements are sent once the server
+		 * signals that the queue has room again.
+		 */
+		typedef Genode::Ring_buffer<Packet_descriptor, MAX_RX_PBUFS + 2,
+		                            Genode::Ring_buffer_unsynchronized> Ack_queue;
+
+		Ack_queue _deferred_acks { };
 
-		void _handle_rx_packet_avail(unsigned)
+		/**
+		 * Acknowledge deferred packets as far as possible
+		 *
+		 * Must be called with '_rx_lock' held.
+		 */
+		void _flush_deferred_acks()
 		{
-			while (_nic->rx()->packet_avail() && _nic->rx()->ready_to_ack()) {
-				_rx_packet = _nic->rx()->get_packet();
-				genode_netif_input(_netif);
-				_nic->rx()->acknowledge_packet(_rx_packet);
-			}
+			while (!_deferred_acks.empty() && _nic.rx()->ready_to_ack())
+				_nic.rx()->acknowledge_packet(_deferred_acks.get());
+		}
+
+		/**
+		 * Acknowledge packet without blocking
+		 *
+		 * Must be called with '_rx_lock' held.
+		 */
+		void _ack_or_defer(Packet_descriptor packet)
+		{
+			_flush_deferred_acks();
+
+			if (_deferred_acks.empty() && _nic.rx()->ready_to_ack())
+				_nic.rx()->acknowledge_packet(packet);
+			else
+				_deferred_acks.add(packet);
 		}
 
-		void _handle_rx_read_to_ack(unsigned) { _handle_rx_packet_avail(0); }
+		/*
+		 * Noncopyable
+		 */
+		Nic_client(Nic_client const &);
+		Nic_client &operator = (Nic_client const &);
 
-		void _handle_link_state(unsigned)
+		bool _rx_ready()
 		{
-			lwip_nic_link_state_changed(_nic->link_state());
+			Genode::Lock::Guard guard(_rx_lock);
+
+			_flush_deferred_acks();
+
+			return _deferred_acks.empty()
+			    && _nic.rx()->packet_avail() && _nic.rx()->ready_to_ack();
+		}
+
+		void _rx_ack(Packet_descriptor packet)
+		{
+			Genode::Lock::Guard guard(_rx_lock);
+			_ack_or_defer(packet);
+		}
+
+		static void _free_rx_pbuf(struct pbuf *p)
+		{
+			Rx_pbuf    &rx_pbuf = *reinterpret_cast<Rx_pbuf *>(p);
+			Nic_client &client  = *rx_pbuf.client;
+
+			Genode::Lock::Guard guard(client._rx_lock);
+
+			client._ack_or_defer(rx_pbuf.packet);
+
+			rx_pbuf.next_free     = client._free_rx_pbufs;
+			client._free_rx_pbufs = &rx_pbuf;
+		}
+
+		/**
+		 * Return pbuf referencing the content of 'packet' in place
+		 *
+		 * \return  nullptr if no 'Rx_pbuf' is available
+		 */
+		struct pbuf *_reference_rx_packet(Packet_descriptor packet)
+		{
+#if ETH_PAD_SIZE
+			/* the padding cannot be prepended to the packet content */
+			return nullptr;
+#else
+			Rx_pbuf *rx_pbuf = nullptr;
+			{
+				Genode::Lock::Guard guard(_rx_lock);
+
+				rx_pbuf = _free_rx_pbufs;
+				if (!rx_pbuf)
+					return nullptr;
+
+				_free_rx_pbufs = rx_pbuf->next_free;
+			}
+
+			u16_t const len = packet.size();
+
+			rx_pbuf->packet                      = packet;
+			rx_pbuf->custom.custom_free_function = _free_rx_pbuf;
+
+			return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx_pbuf->custom,
+			                           _nic.rx()->packet_content(packet), len);
+#endif
+		}
+
+		/**
+		 * Return pbuf chain holding a copy of the content of 'packet'
+		 *
+		 * \return  nullptr on memory error
+		 */
+		struct pbuf *_copy_rx_packet(Packet_descriptor packet)
+		{
+			char  *rx_content = _nic.rx()->packet_content(packet);
+			u16_t  len        = packet.size();
+
+#if ETH_PAD_SIZE
+			len += ETH_PAD_SIZE; /* allow room for Ethernet padding */
+#endif
+
+			/* We allocate a pbuf chain of pbufs from the pool. */
+			struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+			if (!p)
+				return nullptr;
+
+#if ETH_PAD_SIZE
+			pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
+#endif
+
+			/*
+			 * We iterate over the pbuf chain until we have read the entire
+			 * packet into the pbuf.
+			 */
+			for (struct pbuf *q = p; q != 0; q = q->next) {
+				char *dst = (char*)q->payload;
+				Genode::memcpy(dst, rx_content, q->len);
+				rx_content += q->len;
+			}
+
+#if ETH_PAD_SIZE
+			pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
+#endif
+			return p;
 		}
 
 		void _tx_ack(bool block = false)
 		{
 			/* check for acknowledgements */
-			while (nic()->tx()->ack_avail() || block) {
-				Packet_descriptor acked_packet = nic()->tx()->get_acked_packet();
-				nic()->tx()->release_packet(acked_packet);
+			while (_nic.tx()->ack_avail() || block) {
+				Packet_descriptor acked_packet = _nic.tx()->get_acked_packet();
+				_nic.tx()->release_packet(acked_packet);
 				block = false;
 			}
 		}
 
 	public:
 
-		Nic_receiver_thread(Nic::Connection *nic, struct netif *netif)
+		Nic_client(Nic::Connection &nic, struct netif &netif,
+		           Genode::size_t rx_buf_size)
 		:
-			Genode::Thread_deprecated<8192>("nic-recv"), _nic(nic), _netif(netif),
-			_link_state_dispatcher(_sig_rec, *this, &Nic_receiver_thread::_handle_link_state),
-			_rx_packet_avail_dispatcher(_sig_rec, *this, &Nic_receiver_thread::_handle_rx_packet_avail),
-			_rx_ready_to_ack_dispatcher(_sig_rec, *this, &Nic_receiver_thread::_handle_rx_read_to_ack)
+			_nic(nic), _netif(netif)
 		{
-			_nic->link_state_sigh(_link_state_dispatcher);
-			_nic->rx_channel()->sigh_packet_avail(_rx_packet_avail_dispatcher);
-			_nic->rx_channel()->sigh_ready_to_ack(_rx_ready_to_ack_dispatcher);
+			/* reference at most half of the RX buffer */
+			Genode::size_t const max_rx_pbufs =
+				Genode::min((Genode::size_t)MAX_RX_PBUFS,
+				            rx_buf_size / Nic::Packet_allocator::DEFAULT_PACKET_SIZE / 2);
+
+			for (unsigned i = 0; i < max_rx_pbufs; i++) {
+				_rx_pbufs[i].client    = this;
+				_rx_pbufs[i].next_free = _free_rx_pbufs;
+				_free_rx_pbufs         = &_rx_pbufs[i];
+			}
 		}
 
-		void entry();
-		Nic::Connection  *nic() { return _nic; };
-		Packet_descriptor rx_packet() { return _rx_packet; };
+		Nic::Connection &nic() { return _nic; }
+
+		/**
+		 * Pass received packets to lwIP
+		 */
+		void handle_rx()
+		{
+			while (_rx_ready()) {
+
+				Packet_descriptor const packet = _nic.rx()->get_packet();
+
+				struct pbuf *p = _reference_rx_packet(packet);
+				if (!p) {
+					p = _copy_rx_packet(packet);
+					_rx_ack(packet);
+				}
+
+				if (!p) {
+					LINK_STATS_INC(link.memerr);
+					LINK_STATS_INC(link.drop);
+					continue;
+				}
+
+				LINK_STATS_INC(link.recv);
+
+				if (_netif.input(p, &_netif) != ERR_OK) {
+					if (verbose)
+						Genode::error("genode_netif_input: input error");
+					pbuf_free(p);
+				}
+			}
+		}
+
+		void handle_link_state()
+		{
+			lwip_nic_link_state_changed(_nic.link_state());
+		}
 
 		Packet_descriptor alloc_tx_packet(Genode::size_t size)
 		{
 			while (true) {
 				try {
-					Packet_descriptor packet = nic()->tx()->alloc_packet(size);
+					Packet_descriptor packet = _nic.tx()->alloc_packet(size);
 					return packet;
 				} catch(Nic::Session::Tx::Source::Packet_alloc_failed) {
 					/* packet allocator exhausted, wait for acknowledgements */
@@ -118,13 +322,83 @@ class Nic_receiver_thread : public Genode::Thread_deprecated<8192>
 
 		void submit_tx_packet(Packet_descriptor packet)
 		{
-			nic()->tx()->submit_packet(packet);
+			_nic.tx()->submit_packet(packet);
 			/* check for acknowledgements */
 			_tx_ack();
 		}
 
 		char *content(Packet_descriptor packet) {
-			return nic()->tx()->packet_content(packet); }
+			return _nic.tx()->packet_content(packet); }
+};
+
+
+/*
+ * Thread, that receives the signals of the nic session
+ */
+class Nic_receiver_thread : public Genode::Thread_deprecated<8192>
+{
+	private:
+
+		Nic_client &_client;
+
+		Genode::Signal_receiver _sig_rec { };
+
+		Genode::Io_signal_dispatcher<Nic_receiver_thread> _link_state_dispatcher;
+		Genode::Io_signal_dispatcher<Nic_receiver_thread> _rx_dispatcher;
+
+		void _handle_rx(unsigned) { _client.handle_rx(); }
+
+		void _handle_link_state(unsigned) { _client.handle_link_state(); }
+
+	public:
+
+		Nic_receiver_thread(Nic_client &client)
+		:
+			Genode::Thread_deprecated<8192>("nic-recv"), _client(client),
+			_link_state_dispatcher(_sig_rec, *this, &Nic_receiver_thread::_handle_link_state),
+			_rx_dispatcher(_sig_rec, *this, &Nic_receiver_thread::_handle_rx)
+		{
+			Nic::Connection &nic = _client.nic();
+
+			nic.link_state_sigh(_link_state_dispatcher);
+			nic.rx_channel()->sigh_packet_avail(_rx_dispatcher);
+			nic.rx_channel()->sigh_ready_to_ack(_rx_dispatcher);
+		}
+
+		void entry();
+};
+
+
+/*
+ * Handling of the signals of the nic session at the component's entrypoint
+ */
+class Nic_signal_handler
+{
+	private:
+
+		Nic_client &_client;
+
+		Genode::Io_signal_handler<Nic_signal_handler> _link_state_handler;
+		Genode::Io_signal_handler<Nic_signal_handler> _rx_handler;
+
+		void _handle_rx() { _client.handle_rx(); }
+
+		void _handle_link_state() { _client.handle_link_state(); }
+
+	public:
+
+		Nic_signal_handler(Genode::Entrypoint &ep, Nic_client &client)
+		:
+			_client(client),
+			_link_state_handler(ep, *this, &Nic_signal_handler::_handle_link_state),
+			_rx_handler(ep, *this, &Nic_signal_handler::_handle_rx)
+		{
+			Nic::Connection &nic = _client.nic();
+
+			nic.link_state_sigh(_link_state_handler);
+			nic.rx_channel()->sigh_packet_avail(_rx_handler);
+			nic.rx_channel()->sigh_ready_to_ack(_rx_handler);
+		}
 };
 
 
@@ -151,26 +425,27 @@ extern "C" {
 	static err_t
 	low_level_output(struct netif *netif, struct pbuf *p)
 	{
-		Nic_receiver_thread *th = reinterpret_cast<Nic_receiver_thread*>(netif->state);
+		Nic_client *client = reinterpret_cast<Nic_client*>(netif->state);
 
 #if ETH_PAD_SIZE
 		pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
-		Nic::Packet_descriptor tx_packet = th->alloc_tx_packet(p->tot_len);
-		char *tx_content                 = th->content(tx_packet);
+		Nic::Packet_descriptor tx_packet = client->alloc_tx_packet(p->tot_len);
+		char *tx_content                 = client->content(tx_packet);
 
 		/*
-		 * Iterate through all pbufs and
-		 * copy payload into packet's payload
+		 * With 'LWIP_NETIF_TX_SINGLE_PBUF' enabled, lwIP assembles each
+		 * outgoing frame in one contiguous pbuf, which is copied at once.
+		 * Otherwise, iterate through all pbufs and copy payload into
+		 * packet's payload.
 		 */
-		for(struct pbuf *q = p; q != NULL; q = q->next) {
-			char *src = (char*) q->payload;
-			Genode::memcpy(tx_content, src, q->len);
-			tx_content += q->len;
-		}
+		if (p->len == p->tot_len)
+			Genode::memcpy(tx_content, p->payload, p->len);
+		else
+			pbuf_copy_partial(p, tx_content, p->tot_len, 0);
 
 		/* Submit packet */
-		th->submit_tx_packet(tx_packet);
+		client->submit_tx_packet(tx_packet);
 
 #if ETH_PAD_SIZE
 		pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
@@ -180,87 +455,6 @@ extern "C" {
 	}
 
 
-	/**
-	 * Should allocate a pbuf and transfer the bytes of the incoming
-	 * packet from the interface into the pbuf.
-	 *
-	 * @param netif the lwip network interface structure for this genode_netif
-	 * @return a pbuf filled with the received packet (including MAC header)
-	 *         NULL on memory error
-	 */
-	static struct pbuf *
-	low_level_input(struct netif *netif)
-	{
-		Nic_receiver_thread   *th         = reinterpret_cast<Nic_receiver_thread*>(netif->state);
-		Nic::Connection       *nic        = th->nic();
-		Nic::Packet_descriptor rx_packet  = th->rx_packet();
-		char                  *rx_content = nic->rx()->packet_content(rx_packet);
-		u16_t                  len        = rx_packet.size();
-
-#if ETH_PAD_SIZE
-		len += ETH_PAD_SIZE; /* allow room for Ethernet padding */
-#endif
-
-		/* We allocate a pbuf chain of pbufs from the pool. */
-		struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
-		if (p) {
-#if ETH_PAD_SIZE
-			pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
-#endif
-
-			/*
-			 * We iterate over the pbuf chain until we have read the entire
-			 * packet into the pbuf.
-			 */
-			for(struct pbuf *q = p; q != 0; q = q->next) {
-				char *dst = (char*)q->payload;
-				Genode::memcpy(dst, rx_content, q->len);
-				rx_content += q->len;
-			}
-
-#if ETH_PAD_SIZE
-			pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
-#endif
-			LINK_STATS_INC(link.recv);
-		} else {
-			LINK_STATS_INC(link.memerr);
-			LINK_STATS_INC(link.drop);
-		}
-
-		return p;
-	}
-
-
-	/**
-	 * This function should be called when a packet is ready to be read
-	 * from the interface. It uses the function low_level_input() that
-	 * should handle the actual reception of bytes from the network
-	 * interface. Then the type of the received packet is determined and
-	 * the appropriate input function is called.
-	 *
-	 * @param netif the lwip network interface structure for this genode_netif
-	 */
-	static void
-	genode_netif_input(struct netif *netif)
-	{
-		/*
-		 * Move received packet into a new pbuf,
-		 * if something went wrong, return silently
-		 */
-		struct pbuf *p = low_level_input(netif);
-
-		/* No packet could be read, silently ignore this */
-		if (p == NULL) return;
-
-		if (netif->input(p, netif) != ERR_OK) {
-			if (verbose)
-				Genode::error("genode_netif_input: input error");
-			pbuf_free(p);
-			p = 0;
-		}
-	}
-
-
 	/**
 	 * Should be called at the beginning of the program to set up the
 	 * network interface. It calls the function low_level_init() to do the
@@ -294,12 +488,21 @@ extern "C" {
 			return ERR_IF;
 		}
 
-		/* Setup receiver thread */
-		Nic_receiver_thread *th = new (env()->heap())
-			Nic_receiver_thread(nic, netif);
+		Nic_client *client = new (env()->heap())
+			Nic_client(*nic, *netif, nbs->rx_buf_size);
 
-		/* Store receiver thread address in user-defined netif struct part */
-		netif->state      = (void*) th;
+		/*
+		 * Handle the NIC signals at the entrypoint if configured via
+		 * 'lwip_nic_entrypoint', or by a dedicated receiver thread
+		 */
+		Nic_receiver_thread *th = nullptr;
+		if (_nic_ep)
+			new (env()->heap()) Nic_signal_handler(*_nic_ep, *client);
+		else
+			th = new (env()->heap()) Nic_receiver_thread(*client);
+
+		/* Store nic-client address in user-defined netif struct part */
+		netif->state      = (void*) client;
 #if LWIP_NETIF_HOSTNAME
 		netif->hostname   = "lwip";
 #endif /* LWIP_NETIF_HOSTNAME */
@@ -318,7 +521,8 @@ extern "C" {
 		for(int i=0; i<6; ++i)
 			netif->hwaddr[i] = _mac.addr[i];
 
-		th->start();
+		if (th)
+			th->start();
 
 		return ERR_OK;
 	}
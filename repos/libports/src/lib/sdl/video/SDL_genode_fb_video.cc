@@ -32,10 +32,12 @@
 /* Genode includes */
 #include <base/log.h>
 #include <base/env.h>
+#include <base/attached_rom_dataspace.h>
 #include <framebuffer_session/connection.h>
 
 /* local includes */
 #include <SDL_genode_internal.h>
+#include "SDL_genode_yuv.h"
 
 
 extern Genode::Env        *global_env();
@@ -56,6 +58,7 @@ extern "C" {
 #include "SDL_events_c.h"
 #include "SDL_genode_fb_events.h"
 #include "SDL_genode_fb_video.h"
+#include "SDL_yuvfuncs.h"
 
 	static SDL_Rect df_mode;
 
@@ -323,7 +326,7 @@ extern "C" {
 		device->InitOSKeymap     = Genode_Fb_InitOSKeymap;
 		device->PumpEvents       = Genode_Fb_PumpEvents;
 		device->free             = Genode_Fb_DeleteDevice;
-		device->CreateYUVOverlay = 0;
+		device->CreateYUVOverlay = Genode_Fb_CreateYUVOverlay;
 		device->CheckHWBlit      = 0;
 		device->FillHWRect       = 0;
 		device->SetHWColorKey    = 0;
@@ -554,6 +557,217 @@ extern "C" {
 	}
 
 
+	/*****************
+	 ** YUV overlay **
+	 *****************/
+
+	/*
+	 * The overlay converts and scales the planar YUV image directly into the
+	 * framebuffer in one pass. SDL's generic software overlay, by contrast,
+	 * converts the image into an intermediate surface first and stretches
+	 * it to the screen in a second pass.
+	 */
+
+	struct private_yuvhwdata
+	{
+		Uint16  pitches[3];
+		Uint8  *planes[3];
+		Uint8  *pixels;
+
+		/* source column for each destination column */
+		int *x_map;
+		int  x_map_len;
+
+		/*
+		 * Statistics, reported every 'STATS_PERIOD_MS' if enabled
+		 *
+		 * A frame counts as late if its distance to the previous frame is
+		 * more than 1.5 times the average distance, which is the case if
+		 * the player dropped frames or could not keep up.
+		 */
+		enum { STATS_PERIOD_MS = 5000 };
+
+		bool     stats;
+		Uint32   period_start, last_display;
+		unsigned frames, late, convert_ms;
+		Uint32   avg_interval;    /* in 1/16 milliseconds */
+	};
+
+
+	static bool yuv_stats_configured()
+	{
+		try {
+			Genode::Attached_rom_dataspace config(*global_env(), "config");
+
+			if (!config.xml().has_sub_node("sdl_yuv_overlay"))
+				return false;
+
+			return config.xml().sub_node("sdl_yuv_overlay")
+			                   .attribute_value("stats", false);
+		} catch (...) { return false; }
+	}
+
+
+	static void yuv_account_frame(private_yuvhwdata &hw, Uint32 start, Uint32 end)
+	{
+		if (hw.frames == 0 && hw.late == 0)
+			hw.period_start = start;
+
+		if (hw.last_display) {
+			Uint32 const interval = (start - hw.last_display) << 4;
+
+			if (hw.avg_interval && interval > hw.avg_interval*3/2)
+				hw.late++;
+
+			hw.avg_interval = hw.avg_interval
+			                ? (hw.avg_interval*7 + interval)/8 : interval;
+		}
+
+		hw.last_display = start;
+		hw.frames++;
+		hw.convert_ms += end - start;
+
+		Uint32 const period = end - hw.period_start;
+		if (period < private_yuvhwdata::STATS_PERIOD_MS)
+			return;
+
+		Genode::log("YUV overlay: ", hw.frames, " frames in ", period, " ms, "
+		            "fps=", hw.frames*1000/period, " "
+		            "late=", hw.late, " "
+		            "convert=", hw.convert_ms/hw.frames, " ms/frame");
+
+		hw.frames = hw.late = hw.convert_ms = 0;
+	}
+
+
+	static int Genode_Fb_LockYUVOverlay(SDL_VideoDevice *t, SDL_Overlay *overlay)
+	{
+		return 0;
+	}
+
+
+	static void Genode_Fb_UnlockYUVOverlay(SDL_VideoDevice *t, SDL_Overlay *overlay) { }
+
+
+	static int Genode_Fb_DisplayYUVOverlay(SDL_VideoDevice *t, SDL_Overlay *overlay,
+	                                       SDL_Rect *src, SDL_Rect *dst)
+	{
+		private_yuvhwdata &hw = *overlay->hwdata;
+
+		if (!t->hidden->buffer)
+			return -1;
+
+		if (dst->w > hw.x_map_len) {
+			int *x_map = (int *)SDL_realloc(hw.x_map, dst->w*sizeof(int));
+			if (!x_map) {
+				SDL_OutOfMemory();
+				return -1;
+			}
+			hw.x_map     = x_map;
+			hw.x_map_len = dst->w;
+		}
+
+		Uint32 const start = hw.stats ? SDL_GetTicks() : 0;
+
+		bool const yv12 = (overlay->format == SDL_YV12_OVERLAY);
+
+		Uint8 const *u = hw.planes[yv12 ? 2 : 1],
+		            *v = hw.planes[yv12 ? 1 : 2];
+
+		Yuv::Planes const planes { hw.planes[0], u, v, hw.pitches[0], hw.pitches[1] };
+
+		Genode::uint16_t *fb = (Genode::uint16_t *)t->hidden->buffer
+		                     + dst->y*t->hidden->w + dst->x;
+
+		Yuv::convert(fb, t->hidden->w, dst->w, dst->h,
+		             planes, src->x, src->y, src->w, src->h, hw.x_map);
+
+		framebuffer->refresh(dst->x, dst->y, dst->w, dst->h);
+
+		if (hw.stats)
+			yuv_account_frame(hw, start, SDL_GetTicks());
+
+		return 0;
+	}
+
+
+	static void Genode_Fb_FreeYUVOverlay(SDL_VideoDevice *t, SDL_Overlay *overlay)
+	{
+		private_yuvhwdata *hw = overlay->hwdata;
+		if (!hw)
+			return;
+
+		SDL_free(hw->x_map);
+		SDL_free(hw->pixels);
+		SDL_free(hw);
+		overlay->hwdata = nullptr;
+	}
+
+
+	static struct private_yuvhwfuncs yuv_funcs = {
+		Genode_Fb_LockYUVOverlay,
+		Genode_Fb_UnlockYUVOverlay,
+		Genode_Fb_DisplayYUVOverlay,
+		Genode_Fb_FreeYUVOverlay
+	};
+
+
+	/**
+	 * Create overlay for the planar 4:2:0 formats
+	 *
+	 * For other formats, SDL falls back to its software overlay.
+	 */
+	static SDL_Overlay *Genode_Fb_CreateYUVOverlay(SDL_VideoDevice *t,
+	                                               int width, int height,
+	                                               Uint32 format,
+	                                               SDL_Surface *display)
+	{
+		if (format != SDL_YV12_OVERLAY && format != SDL_IYUV_OVERLAY)
+			return nullptr;
+
+		if (display->format->BitsPerPixel != 16)
+			return nullptr;
+
+		SDL_Overlay       *overlay = (SDL_Overlay *)SDL_malloc(sizeof(SDL_Overlay));
+		private_yuvhwdata *hw      = (private_yuvhwdata *)SDL_malloc(sizeof(private_yuvhwdata));
+
+		int const uv_w = (width + 1)/2, uv_h = (height + 1)/2;
+
+		Uint8 *pixels = (Uint8 *)SDL_malloc(width*height + 2*uv_w*uv_h);
+
+		if (!overlay || !hw || !pixels) {
+			SDL_free(pixels);
+			SDL_free(hw);
+			SDL_free(overlay);
+			SDL_OutOfMemory();
+			return nullptr;
+		}
+
+		SDL_memset(overlay, 0, sizeof(*overlay));
+		SDL_memset(hw,      0, sizeof(*hw));
+
+		hw->pixels     = pixels;
+		hw->pitches[0] = width;
+		hw->pitches[1] = hw->pitches[2] = uv_w;
+		hw->planes[0]  = pixels;
+		hw->planes[1]  = hw->planes[0] + width*height;
+		hw->planes[2]  = hw->planes[1] + uv_w*uv_h;
+		hw->stats      = yuv_stats_configured();
+
+		overlay->format     = format;
+		overlay->w          = width;
+		overlay->h          = height;
+		overlay->planes     = 3;
+		overlay->pitches    = hw->pitches;
+		overlay->pixels     = hw->planes;
+		overlay->hwfuncs    = &yuv_funcs;
+		overlay->hwdata     = hw;
+		overlay->hw_overlay = 1;
+
+		return overlay;
+	}
+
+
 	/**
 	 * Sets the color entries { firstcolor .. (firstcolor+ncolors-1) }
 	 * of the physical palette to those in 'colors'. If the device is
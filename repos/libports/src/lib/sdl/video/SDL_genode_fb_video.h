@@ -60,6 +60,14 @@ static int Genode_Fb_LockHWSurface(SDL_VideoDevice *t, SDL_Surface *surface);
 static void Genode_Fb_UnlockHWSurface(SDL_VideoDevice *t, SDL_Surface *surface);
 static void Genode_Fb_FreeHWSurface(SDL_VideoDevice *t, SDL_Surface *surface);
 
+/**
+ * YUV overlay functions
+ */
+static SDL_Overlay *Genode_Fb_CreateYUVOverlay(SDL_VideoDevice *t,
+                                               int width, int height,
+                                               Uint32 format,
+                                               SDL_Surface *display);
+
 /**
  * etc.
  */
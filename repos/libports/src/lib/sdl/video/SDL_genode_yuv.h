@@ -0,0 +1,160 @@
+/*
+ * \brief  Conversion of planar YUV 4:2:0 images to RGB565
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _SDL_GENODE_YUV_H_
+#define _SDL_GENODE_YUV_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Yuv {
+
+	struct Planes
+	{
+		unsigned char const *y, *u, *v;
+
+		int y_pitch, uv_pitch;    /* in bytes */
+	};
+
+	inline int clamp(int c) { return c < 0 ? 0 : (c > 255 ? 255 : c); }
+
+	/**
+	 * Convert one pixel using the ITU-R BT.601 coefficients in 8.8 fixpoint
+	 */
+	inline Genode::uint16_t rgb565(int y, int u, int v)
+	{
+		int const c = 298*(y - 16), d = u - 128, e = v - 128;
+
+		int const r = clamp((c + 409*e + 128) >> 8),
+		          g = clamp((c - 100*d - 208*e + 128) >> 8),
+		          b = clamp((c + 516*d + 128) >> 8);
+
+		return (Genode::uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+	/**
+	 * Convert and scale one line
+	 *
+	 * \param x_map  source column for each destination column, relative to
+	 *               the start of the source lines 'y', 'u', and 'v'
+	 */
+	inline void convert_line_generic(Genode::uint16_t *dst, int w, int const *x_map,
+	                                 unsigned char const *y, unsigned char const *u,
+	                                 unsigned char const *v, int x = 0)
+	{
+		for (; x < w; x++) {
+			int const sx = x_map[x];
+			dst[x] = rgb565(y[sx], u[sx >> 1], v[sx >> 1]);
+		}
+	}
+}
+
+
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+
+namespace Yuv {
+
+	typedef int V __attribute__((vector_size(16)));
+
+	inline V clamp(V c)
+	{
+		c &= ~(c >> 31);                 /* negative values become 0    */
+		return (c | (V)(c > 255)) & 255; /* values above 255 become 255 */
+	}
+
+	/*
+	 * The arithmetics is the same as in the scalar 'rgb565' function. Only
+	 * the loads are done lane by lane.
+	 */
+	inline void convert_line(Genode::uint16_t *dst, int w, int const *x_map,
+	                         unsigned char const *y, unsigned char const *u,
+	                         unsigned char const *v)
+	{
+		int x = 0;
+		for (; x + 4 <= w; x += 4) {
+
+			int const *m = x_map + x;
+
+			V const vy = { y[m[0]], y[m[1]], y[m[2]], y[m[3]] };
+			V const vu = { u[m[0] >> 1], u[m[1] >> 1], u[m[2] >> 1], u[m[3] >> 1] };
+			V const vv = { v[m[0] >> 1], v[m[1] >> 1], v[m[2] >> 1], v[m[3] >> 1] };
+
+			V const c = 298*(vy - 16), d = vu - 128, e = vv - 128;
+
+			V const r = clamp((c + 409*e + 128) >> 8),
+			        g = clamp((c - 100*d - 208*e + 128) >> 8),
+			        b = clamp((c + 516*d + 128) >> 8);
+
+			V const p = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+
+			dst[x + 0] = (Genode::uint16_t)p[0]; dst[x + 1] = (Genode::uint16_t)p[1];
+			dst[x + 2] = (Genode::uint16_t)p[2]; dst[x + 3] = (Genode::uint16_t)p[3];
+		}
+
+		convert_line_generic(dst, w, x_map, y, u, v, x);
+	}
+}
+
+#else
+
+namespace Yuv {
+
+	inline void convert_line(Genode::uint16_t *dst, int w, int const *x_map,
+	                         unsigned char const *y, unsigned char const *u,
+	                         unsigned char const *v) {
+		convert_line_generic(dst, w, x_map, y, u, v); }
+}
+
+#endif /* __SSE2__ || __ARM_NEON__ */
+
+
+namespace Yuv {
+
+	/**
+	 * Convert source image to a destination area of a different size
+	 *
+	 * Each destination pixel is written exactly once, taking the nearest
+	 * source pixel. Hence, the image is converted and scaled in a single
+	 * pass without an intermediate buffer.
+	 *
+	 * The chroma position of each pixel is derived from its absolute source
+	 * position. Hence, the planes refer to the whole source image and the
+	 * source area is denoted by 'src_x', 'src_y', 'src_w', and 'src_h'.
+	 *
+	 * \param dst        first destination pixel
+	 * \param dst_pitch  destination line length in pixels
+	 * \param x_map      buffer of at least 'dst_w' entries
+	 */
+	inline void convert(Genode::uint16_t *dst, int dst_pitch, int dst_w, int dst_h,
+	                    Planes const &src, int src_x, int src_y,
+	                    int src_w, int src_h, int *x_map)
+	{
+		if (dst_w <= 0 || dst_h <= 0)
+			return;
+
+		for (int x = 0; x < dst_w; x++)
+			x_map[x] = src_x + (int)(((long long)x*src_w) / dst_w);
+
+		for (int i = 0; i < dst_h; i++, dst += dst_pitch) {
+
+			int const sy = src_y + (int)(((long long)i*src_h) / dst_h);
+
+			convert_line(dst, dst_w, x_map,
+			             src.y + sy*src.y_pitch,
+			             src.u + (sy >> 1)*src.uv_pitch,
+			             src.v + (sy >> 1)*src.uv_pitch);
+		}
+	}
+}
+
+#endif /* _SDL_GENODE_YUV_H_ */
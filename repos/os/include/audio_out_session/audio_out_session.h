@@ -24,6 +24,13 @@
  *
  * Note: That most components right now only support: "(front) left" and
  * "(front) right".
+ *
+ * Samples are always transferred as floating-point values in the range of
+ * [-1.0, 1.0]. The sample rate of a stream is negotiated at session-creation
+ * time via the 'sample_rate' session argument, which defaults to
+ * 'SAMPLE_RATE'. A server that is unable to handle the requested rate denies
+ * the session request. The mixer accepts arbitrary rates and converts the
+ * stream to the rate of its output session.
  */
 
 /*
@@ -52,8 +59,17 @@ namespace Audio_out {
 		QUEUE_SIZE  = 256,           /* buffer queue size */
 		SAMPLE_RATE = 44100,
 		SAMPLE_SIZE = sizeof(float),
+
+		MIN_SAMPLE_RATE = 8000,
+		MAX_SAMPLE_RATE = 192000,
 	};
 
+	/**
+	 * Return true if 'rate' is a sample rate that may be requested by a client
+	 */
+	static inline bool valid_sample_rate(unsigned rate) {
+		return rate >= MIN_SAMPLE_RATE && rate <= MAX_SAMPLE_RATE; }
+
 	/**
 	 * Samples per perios (~11.6ms)
 	 */
@@ -97,6 +113,28 @@ class Audio_out::Packet
 				Genode::memset(data + samples, 0, (PERIOD - samples) * SAMPLE_SIZE);
 		}
 
+		/**
+		 * Copy signed 16-bit data into packet
+		 *
+		 * The samples are converted to the floating-point representation
+		 * used by the session. If there are less frames given than 'PERIOD',
+		 * the remainder is filled with zeros.
+		 *
+		 * \param  data     frames to copy in
+		 * \param  samples  number of frames to copy
+		 */
+		void content(Genode::int16_t const *data, Genode::size_t samples)
+		{
+			float const scale = 1.0f / 32768.0f;
+
+			Genode::size_t const n = samples > PERIOD ? PERIOD : samples;
+			for (Genode::size_t i = 0; i < n; i++)
+				_data[i] = (float)data[i] * scale;
+
+			if (n < PERIOD)
+				Genode::memset(_data + n, 0, (PERIOD - n) * SAMPLE_SIZE);
+		}
+
 		/**
 		 * Get content
 		 *
@@ -295,6 +333,14 @@ class Audio_out::Stream
 		 * Increment current stream position by one
 		 */
 		void increment_position() { _pos = (_pos + 1) % QUEUE_SIZE; }
+
+		/**
+		 * Submit packet on behalf of a client
+		 *
+		 * This is used by servers that keep a stream of their own to stage
+		 * processed client packets, e.g., after sample-rate conversion.
+		 */
+		void submit(Packet *packet) { packet->_submit(); }
 };
 
 
@@ -28,10 +28,22 @@ struct Audio_out::Connection : Genode::Connection<Session>, Audio_out::Session_c
 	 *
 	 * \noapi
 	 */
-	Genode::Capability<Audio_out::Session> _session(Genode::Parent &parent, char const *channel)
+	Genode::Capability<Audio_out::Session> _session(Genode::Parent &parent,
+	                                                char const *channel,
+	                                                unsigned sample_rate)
 	{
-		return session(parent, "ram_quota=%ld, cap_quota=%ld, channel=\"%s\"",
-		               2*4096 + 2048 + sizeof(Stream), CAP_QUOTA, channel);
+		/*
+		 * A server that converts the stream to another sample rate needs
+		 * a second stream for staging the converted packets as well as
+		 * the state of the converter.
+		 */
+		Genode::size_t const stream_size = sizeof(Stream) +
+			(sample_rate == SAMPLE_RATE ? 0 : sizeof(Stream) + 32*1024);
+
+		return session(parent, "ram_quota=%ld, cap_quota=%ld, channel=\"%s\", "
+		               "sample_rate=%u",
+		               2*4096 + 2048 + stream_size, CAP_QUOTA, channel,
+		               sample_rate);
 	}
 
 	/**
@@ -43,13 +55,16 @@ struct Audio_out::Connection : Genode::Connection<Session>, Audio_out::Session_c
 	 * \param progress_signal  install progress signal, the client may then
 	 *                         call 'wait_for_progress', which is sent when the
 	 *                         server processed one or more packets
+	 * \param sample_rate      sample rate of the submitted frames
 	 */
 	Connection(Genode::Env &env,
 	           char const  *channel,
 	           bool         alloc_signal = true,
-	           bool         progress_signal = false)
+	           bool         progress_signal = false,
+	           unsigned     sample_rate = SAMPLE_RATE)
 	:
-		Genode::Connection<Session>(env, _session(env.parent(), channel)),
+		Genode::Connection<Session>(env, _session(env.parent(), channel,
+		                                          sample_rate)),
 		Session_client(env.rm(), cap(), alloc_signal, progress_signal)
 	{ }
 
@@ -64,7 +79,8 @@ struct Audio_out::Connection : Genode::Connection<Session>, Audio_out::Session_c
 	           bool        alloc_signal = true,
 	           bool        progress_signal = false) __attribute__((deprecated))
 	:
-		Genode::Connection<Session>(_session(*Genode::env_deprecated()->parent(), channel)),
+		Genode::Connection<Session>(_session(*Genode::env_deprecated()->parent(), channel,
+		                                     SAMPLE_RATE)),
 		Session_client(*Genode::env_deprecated()->rm_session(), cap(), alloc_signal, progress_signal)
 	{ }
 };
@@ -72,12 +72,23 @@ class Block::Session_component : public Block::Session_component_base,
 		addr_t                            _rq_phys;
 		Signal_handler<Session_component> _sink_ack;
 		Signal_handler<Session_component> _sink_submit;
+		Signal_handler<Session_component> _barrier_retry;
 		bool                              _req_queue_full = false;
 		bool                              _ack_queue_full = false;
 		Packet_descriptor                 _p_to_handle { };
 		unsigned                          _p_in_fly;
 		bool                              _writeable;
 
+		/*
+		 * A 'SYNC' or 'TRIM' request is passed to the driver only if no
+		 * other request is pending. It is deferred until all preceding
+		 * requests are acknowledged. While it is in flight, no subsequent
+		 * request is passed to the driver.
+		 */
+		bool _barrier_deferred  = false;
+		bool _barrier_in_flight = false;
+		bool _in_driver_call    = false;
+
 		/**
 		 * Acknowledge a packet already handled
 		 */
@@ -93,9 +104,66 @@ class Block::Session_component : public Block::Session_component_base,
 		/**
 		 * Range check packet request
 		 */
-		inline bool _range_check(Packet_descriptor &p) {
-			return p.block_number() + p.block_count() - 1
-			       < _driver.block_count(); }
+		inline bool _range_check(Packet_descriptor &p)
+		{
+			/* a 'SYNC' of zero blocks refers to the whole device */
+			if (p.operation() == Packet_descriptor::SYNC && !p.block_count())
+				return true;
+
+			return p.block_count()
+			    && p.block_number() + p.block_count() - 1
+			       < _driver.block_count();
+		}
+
+		/**
+		 * Pass 'SYNC' or 'TRIM' request to the driver
+		 */
+		void _handle_barrier(Packet_descriptor &packet)
+		{
+			/*
+			 * If the barrier was deferred, it is already accounted for in
+			 * '_p_in_fly'.
+			 */
+			unsigned const preceding = _p_in_fly - (_barrier_deferred ? 1 : 0);
+
+			if (preceding) {
+				_barrier_deferred = true;
+				_req_queue_full   = true;
+				return;
+			}
+
+			_barrier_deferred  = false;
+			_barrier_in_flight = true;
+			_in_driver_call    = true;
+
+			try {
+				if (packet.operation() == Packet_descriptor::SYNC)
+					_driver.sync(packet.block_number(), packet.block_count(),
+					             packet);
+				else
+					_driver.trim(packet.block_number(), packet.block_count(),
+					             packet);
+			} catch (Driver::Request_congestion) {
+				_in_driver_call    = false;
+				_barrier_in_flight = false;
+
+				/*
+				 * Retry once the driver acknowledged another request. If no
+				 * request of the session is pending, no acknowledgement
+				 * triggers the retry, so trigger it ourself.
+				 */
+				_barrier_deferred  = true;
+				if (!preceding)
+					Signal_transmitter(_barrier_retry).submit();
+				throw;
+			} catch (...) {
+				_in_driver_call    = false;
+				_barrier_in_flight = false;
+				throw;
+			}
+
+			_in_driver_call = false;
+		}
 
 		/**
 		 * Handle a single request
@@ -105,8 +173,9 @@ class Block::Session_component : public Block::Session_component_base,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
-			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
+			/* ignore invalid packets, only 'SYNC' and 'TRIM' carry no data */
+			if ((!packet.size() && !packet.barrier())
+			 || !_range_check(_p_to_handle)) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
@@ -144,6 +213,15 @@ class Block::Session_component : public Block::Session_component_base,
 						              _p_to_handle);
 					break;
 
+				case Block::Packet_descriptor::SYNC:
+				case Block::Packet_descriptor::TRIM:
+					if (!_writeable) {
+						_ack_packet(_p_to_handle);
+						break;
+					}
+					_handle_barrier(_p_to_handle);
+					break;
+
 				default:
 					throw Driver::Io_error();
 				}
@@ -154,6 +232,19 @@ class Block::Session_component : public Block::Session_component_base,
 			}
 		}
 
+		/**
+		 * Retry barrier rejected by the driver while no request was pending
+		 */
+		void _retry_barrier()
+		{
+			if (!_barrier_deferred || !_req_queue_full)
+				return;
+
+			_req_queue_full = false;
+			_handle_packet(_p_to_handle);
+			_signal();
+		}
+
 		/**
 		 * Called whenever a signal from the packet-stream interface triggered
 		 */
@@ -165,7 +256,7 @@ class Block::Session_component : public Block::Session_component_base,
 			 * direct the packet request to the driver backend
 			 */
 			for (_ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free());
-			     !_req_queue_full && !_ack_queue_full
+			     !_req_queue_full && !_ack_queue_full && !_barrier_in_flight
 			     && tx_sink()->packet_avail();
 				 _ack_queue_full = (++_p_in_fly >= tx_sink()->ack_slots_free()))
 				_handle_packet(tx_sink()->get_packet());
@@ -190,6 +281,7 @@ class Block::Session_component : public Block::Session_component_base,
 		  _rq_phys(Dataspace_client(_rq_ds).phys_addr()),
 		  _sink_ack(ep, *this, &Session_component::_signal),
 		  _sink_submit(ep, *this, &Session_component::_signal),
+		  _barrier_retry(ep, *this, &Session_component::_retry_barrier),
 		  _req_queue_full(false),
 		  _p_in_fly(0),
 		  _writeable(writeable)
@@ -215,7 +307,19 @@ class Block::Session_component : public Block::Session_component_base,
 			packet.succeeded(success);
 			_ack_packet(packet);
 
-			if (!_req_queue_full && !_ack_queue_full)
+			/* no other request is pending while a barrier is in flight */
+			bool const barrier_completed = _barrier_in_flight;
+			_barrier_in_flight = false;
+
+			/* a barrier acknowledged from within the driver call */
+			if (barrier_completed && _in_driver_call)
+				return;
+
+			/* the deferred barrier waits for the remaining requests */
+			if (_barrier_deferred && _p_in_fly > 1)
+				return;
+
+			if (!_req_queue_full && !_ack_queue_full && !barrier_completed)
 				return;
 
 			/*
@@ -251,7 +355,10 @@ class Block::Session_component : public Block::Session_component_base,
 				ops->set_operation(Opcode::READ);
 			if (_writeable && driver_ops.supported(Opcode::WRITE))
 				ops->set_operation(Opcode::WRITE);
-
+			if (_writeable)
+				ops->set_operation(Opcode::SYNC);
+			if (_writeable && driver_ops.supported(Opcode::TRIM))
+				ops->set_operation(Opcode::TRIM);
 		}
 
 		void sync() { _driver.sync(); }
@@ -233,6 +233,128 @@ class Block::Driver : Genode::Interface
 		 */
 		virtual void sync() {}
 
+		/**
+		 * Synchronize range of blocks with device
+		 *
+		 * \param block_number  number of first block to synchronize
+		 * \param block_count   number of blocks, 0 refers to the whole
+		 *                      device
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * The request is issued only if no other request of the session is
+		 * pending. The default implementation calls the blocking 'sync'
+		 * method and acknowledges the packet immediately.
+		 *
+		 * Note: should be overridden by drivers that process requests
+		 *       asynchronously
+		 */
+		virtual void sync(sector_t            /* block_number */,
+		                  Genode::size_t      /* block_count */,
+		                  Packet_descriptor  &packet)
+		{
+			sync();
+			ack_packet(packet);
+		}
+
+		/**
+		 * Discard the content of a range of blocks
+		 *
+		 * \param block_number  number of first block to discard
+		 * \param block_count   number of blocks to discard
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * The request is issued only if no other request of the session is
+		 * pending.
+		 *
+		 * Note: should be overridden by devices that announce the 'TRIM'
+		 *       operation
+		 */
+		virtual void trim(sector_t            /* block_number */,
+		                  Genode::size_t      /* block_count */,
+		                  Packet_descriptor & /* packet */) {
+			throw Io_error(); }
+
+		/**
+		 * Request passed to the driver as part of a batch
+		 */
+		struct Request
+		{
+			Packet_descriptor packet { };      /* returned via 'ack_packet' */
+			char             *buffer = nullptr; /* payload, if not DMA-capable */
+			Genode::addr_t    phys   = 0;       /* payload, if DMA-capable */
+		};
+
+		/**
+		 * Outcome of submitting a batch of requests
+		 */
+		enum class Submit_status {
+			ACCEPTED,  /* all requests were taken over by the driver */
+			CONGESTED, /* driver cannot take over the request at the moment */
+			REJECTED,  /* driver cannot process the request at all */
+		};
+
+		/**
+		 * Submit a batch of requests
+		 *
+		 * \param requests  array of requests
+		 * \param count     number of requests
+		 * \param accepted  number of leading requests taken over by the driver
+		 *
+		 * \return  'ACCEPTED' if all requests were taken over, otherwise the
+		 *          status of request 'accepted', requests following it are
+		 *          not looked at
+		 *
+		 * A congested request must be submitted again after the driver
+		 * acknowledged another request. A rejected request is not
+		 * acknowledged by the driver. 'SYNC' and 'TRIM' requests are
+		 * submitted only alone and if no other request is pending.
+		 *
+		 * The default implementation passes the requests one by one to the
+		 * methods above. Drivers able to process a batch more efficiently
+		 * than the individual requests, e.g., by merging them, should
+		 * override it.
+		 */
+		virtual Submit_status submit(Request const *requests, unsigned count,
+		                             unsigned &accepted)
+		{
+			for (accepted = 0; accepted < count; accepted++) {
+
+				Request const    &r      = requests[accepted];
+				Packet_descriptor packet = r.packet;
+
+				sector_t       const nr  = packet.block_number();
+				Genode::size_t const cnt = packet.block_count();
+
+				try {
+					switch (packet.operation()) {
+
+					case Packet_descriptor::READ:
+						if (dma_enabled()) read_dma(nr, cnt, r.phys, packet);
+						else               read(nr, cnt, r.buffer, packet);
+						break;
+
+					case Packet_descriptor::WRITE:
+						if (dma_enabled()) write_dma(nr, cnt, r.phys, packet);
+						else               write(nr, cnt, r.buffer, packet);
+						break;
+
+					case Packet_descriptor::SYNC: sync(nr, cnt, packet); break;
+					case Packet_descriptor::TRIM: trim(nr, cnt, packet); break;
+
+					default:
+						return Submit_status::REJECTED;
+					}
+				}
+				catch (Request_congestion) { return Submit_status::CONGESTED; }
+				catch (Io_error)           { return Submit_status::REJECTED;  }
+			}
+			return Submit_status::ACCEPTED;
+		}
+
 		/**
 		 * Informs the driver that the client session was closed
 		 *
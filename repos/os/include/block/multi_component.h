@@ -0,0 +1,673 @@
+/*
+ * \brief  Block-session component sharing one driver among multiple clients
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BLOCK__MULTI_COMPONENT_H_
+#define _INCLUDE__BLOCK__MULTI_COMPONENT_H_
+
+#include <base/log.h>
+#include <base/allocator_avl.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/session_label.h>
+#include <root/component.h>
+#include <os/session_policy.h>
+#include <block/driver.h>
+#include <block/scheduler.h>
+
+namespace Block {
+
+	using namespace Genode;
+
+	class Request_dispatcher;
+	class Multi_session_component_base;
+	class Multi_session_component;
+	class Multi_root;
+};
+
+
+/**
+ * Mediator between the sessions and the driver
+ *
+ * The dispatcher is the single session of the driver. It takes the requests
+ * from the sessions in the order determined by the scheduling policy and
+ * submits them in batches. Each request passed to the driver carries a tag
+ * in place of the packet offset, which is used to route the
+ * acknowledgement back to the originating session. 'SYNC' and 'TRIM'
+ * requests are passed to the driver only if no other request is in flight,
+ * and no other request is passed while they are in flight.
+ */
+class Block::Request_dispatcher : public Driver_session_base
+{
+	public:
+
+		enum { MAX_TAGS = 2*Session::TX_QUEUE_SIZE, BATCH = 16 };
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Request_dispatcher(Request_dispatcher const &);
+		Request_dispatcher &operator = (Request_dispatcher const &);
+
+		struct Tag
+		{
+			Multi_session_component *session = nullptr; /* nullptr if closed */
+			Packet_descriptor        packet  { };       /* client's descriptor */
+			bool                     used    = false;
+
+			/* buffer of a closed session, freed with its last request */
+			Ram_dataspace_capability orphaned_buffer { };
+		};
+
+		Driver_factory    &_factory;
+		Scheduling_policy &_policy;
+		Driver            *_driver   = nullptr;
+		unsigned           _sessions = 0;
+
+		Scheduling_policy::Clients _clients { };
+
+		Tag      _tags[MAX_TAGS] { };
+		unsigned _free[MAX_TAGS] { };
+		unsigned _num_free = 0;
+
+		unsigned long _acks        = 0;     /* acknowledgements received */
+		bool          _congested   = false;
+		bool          _dispatching = false;
+
+		bool                     _barrier_in_flight = false;
+		Multi_session_component *_barrier_session   = nullptr; /* draining */
+
+		void _reset_tags()
+		{
+			for (unsigned i = 0; i < MAX_TAGS; i++) {
+				_tags[i] = Tag();
+				_free[i] = MAX_TAGS - 1 - i;
+			}
+			_num_free          = MAX_TAGS;
+			_barrier_in_flight = false;
+			_barrier_session   = nullptr;
+			_congested         = false;
+		}
+
+		unsigned _in_flight() const { return MAX_TAGS - _num_free; }
+
+		bool _buffer_in_use(Ram_dataspace_capability ds) const
+		{
+			for (unsigned i = 0; i < MAX_TAGS; i++)
+				if (_tags[i].used && _tags[i].orphaned_buffer == ds)
+					return true;
+			return false;
+		}
+
+		inline Driver::Request _request(Multi_session_component &, Packet_descriptor);
+		inline void _release_tag(unsigned, bool put_back, bool success);
+		inline void _submit(Driver::Request *, unsigned);
+		inline void _update_waiting(uint64_t);
+
+	public:
+
+		Request_dispatcher(Driver_factory &factory, Scheduling_policy &policy)
+		: _factory(factory), _policy(policy) { _reset_tags(); }
+
+		/**
+		 * Return driver, create it for the first session
+		 */
+		Driver &acquire()
+		{
+			if (!_sessions++) {
+				_driver = _factory.create();
+				_driver->session(this);
+			}
+			return *_driver;
+		}
+
+		/**
+		 * Release session buffer, destroy driver after the last session
+		 * was closed
+		 *
+		 * Requests of the closed session may still be in flight. The
+		 * buffer is freed once the driver acknowledged all of them.
+		 */
+		void release(Ram_dataspace_capability buffer)
+		{
+			if (!_buffer_in_use(buffer))
+				_driver->free_dma_buffer(buffer);
+
+			if (--_sessions)
+				return;
+
+			/* no more requests are processed after destroying the driver */
+			for (unsigned i = 0; i < MAX_TAGS; i++) {
+				Ram_dataspace_capability const ds = _tags[i].orphaned_buffer;
+				if (!_tags[i].used || !ds.valid())
+					continue;
+
+				for (unsigned j = i; j < MAX_TAGS; j++)
+					if (_tags[j].orphaned_buffer == ds)
+						_tags[j].orphaned_buffer = Ram_dataspace_capability();
+
+				_driver->free_dma_buffer(ds);
+			}
+
+			_driver->session(nullptr);
+			_factory.destroy(_driver);
+			_driver = nullptr;
+			_reset_tags();
+		}
+
+		inline void add(Multi_session_component &);
+		inline void remove(Multi_session_component &, Ram_dataspace_capability);
+
+		/**
+		 * Pass pending requests of the sessions to the driver
+		 */
+		inline void dispatch();
+
+
+		/*****************************
+		 ** Driver_session_base API **
+		 *****************************/
+
+		inline void ack_packet(Packet_descriptor &, bool) override;
+};
+
+
+/**
+ * Base class creating the driver before the packet stream, see
+ * 'Block::Session_component_base'
+ */
+class Block::Multi_session_component_base
+{
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Multi_session_component_base(Multi_session_component_base const &);
+		Multi_session_component_base &operator = (Multi_session_component_base const &);
+
+	protected:
+
+		Request_dispatcher      &_dispatcher;
+		Driver                  &_driver;
+		Ram_dataspace_capability _rq_ds;
+
+		Multi_session_component_base(Request_dispatcher &dispatcher,
+		                             size_t tx_buf_size)
+		: _dispatcher(dispatcher),
+		  _driver(dispatcher.acquire()),
+		  _rq_ds(_driver.alloc_dma_buffer(tx_buf_size)) { }
+
+		~Multi_session_component_base() { _dispatcher.release(_rq_ds); }
+};
+
+
+class Block::Multi_session_component : public Block::Multi_session_component_base,
+                                       public Block::Session_rpc_object,
+                                       public Block::Scheduling_client
+{
+	private:
+
+		addr_t                                  _rq_phys;
+		Signal_handler<Multi_session_component> _sink_ack;
+		Signal_handler<Multi_session_component> _sink_submit;
+		bool const                              _writeable;
+
+		/* requests taken from the submit queue but not acknowledged yet */
+		unsigned _taken = 0;
+
+		/* requests handed back by the dispatcher, taken again first */
+		Packet_descriptor _deferred[Request_dispatcher::BATCH] { };
+		unsigned          _num_deferred = 0;
+
+		void _signal() { _dispatcher.dispatch(); }
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param dispatcher   dispatcher of the driver shared by the sessions
+		 * \param ep           entrypoint handling this session component
+		 * \param rm           region map of local address space
+		 * \param buf_size     size of packet-stream payload buffer
+		 * \param writeable    true if the client may modify the device
+		 * \param weight       requests per round of the weighted policy
+		 * \param deadline_us  latency target used by the deadline policy
+		 */
+		Multi_session_component(Request_dispatcher &dispatcher,
+		                        Genode::Entrypoint &ep,
+		                        Genode::Region_map &rm,
+		                        size_t              buf_size,
+		                        bool                writeable,
+		                        unsigned            weight,
+		                        uint64_t            deadline_us)
+		: Multi_session_component_base(dispatcher, buf_size),
+		  Session_rpc_object(rm, _rq_ds, ep.rpc_ep()),
+		  _rq_phys(Dataspace_client(_rq_ds).phys_addr()),
+		  _sink_ack(ep, *this, &Multi_session_component::_signal),
+		  _sink_submit(ep, *this, &Multi_session_component::_signal),
+		  _writeable(writeable)
+		{
+			Scheduling_client::weight      = weight;
+			Scheduling_client::deadline_us = deadline_us;
+
+			_tx.sigh_ready_to_ack(_sink_ack);
+			_tx.sigh_packet_avail(_sink_submit);
+
+			_dispatcher.add(*this);
+		}
+
+		~Multi_session_component() { _dispatcher.remove(*this, _rq_ds); }
+
+		/**
+		 * Return true if the client may issue the request
+		 */
+		bool permitted(Packet_descriptor const &p)
+		{
+			bool const barrier = p.barrier();
+
+			if (!barrier && (!p.size() || !tx_sink()->packet_valid(p)))
+				return false;
+
+			if (!_writeable && p.operation() != Packet_descriptor::READ)
+				return false;
+
+			/* a 'SYNC' of zero blocks refers to the whole device */
+			if (p.operation() == Packet_descriptor::SYNC && !p.block_count())
+				return true;
+
+			return p.block_count()
+			    && p.block_number() + p.block_count() - 1
+			       < _driver.block_count();
+		}
+
+		/**
+		 * Take next request
+		 */
+		Packet_descriptor take()
+		{
+			_taken++;
+
+			if (!_num_deferred)
+				return tx_sink()->get_packet();
+
+			Packet_descriptor const p = _deferred[0];
+			for (unsigned i = 1; i < _num_deferred; i++)
+				_deferred[i - 1] = _deferred[i];
+			_num_deferred--;
+			return p;
+		}
+
+		/**
+		 * Hand back request not accepted by the driver
+		 */
+		void put_back(Packet_descriptor const &p)
+		{
+			for (unsigned i = _num_deferred; i > 0; i--)
+				_deferred[i] = _deferred[i - 1];
+			_deferred[0] = p;
+			_num_deferred++;
+			_taken--;
+		}
+
+		/**
+		 * Acknowledge request to the client
+		 */
+		void ack(Packet_descriptor p, bool success)
+		{
+			p.succeeded(success);
+
+			if (!tx_sink()->ready_to_ack())
+				error("not ready to ack!");
+
+			tx_sink()->acknowledge_packet(p);
+			_taken--;
+		}
+
+		char   *content(Packet_descriptor const &p) { return tx_sink()->packet_content(p); }
+		addr_t  phys(Packet_descriptor const &p) const { return _rq_phys + p.offset(); }
+
+
+		/*********************************
+		 ** Scheduling_client interface **
+		 *********************************/
+
+		bool ready() override
+		{
+			return (_num_deferred || tx_sink()->packet_avail())
+			    && _taken < tx_sink()->ack_slots_free();
+		}
+
+
+		/*******************************
+		 **  Block session interface  **
+		 *******************************/
+
+		void info(sector_t *blk_count, size_t *blk_size,
+		          Operations *ops)
+		{
+			Operations driver_ops = _driver.ops();
+
+			*blk_count = _driver.block_count();
+			*blk_size  = _driver.block_size();
+			*ops       = Operations();
+
+			typedef Block::Packet_descriptor::Opcode Opcode;
+
+			if (driver_ops.supported(Opcode::READ))
+				ops->set_operation(Opcode::READ);
+			if (_writeable && driver_ops.supported(Opcode::WRITE))
+				ops->set_operation(Opcode::WRITE);
+			if (_writeable)
+				ops->set_operation(Opcode::SYNC);
+			if (_writeable && driver_ops.supported(Opcode::TRIM))
+				ops->set_operation(Opcode::TRIM);
+		}
+
+		void sync() { _driver.sync(); }
+};
+
+
+/************************************
+ ** Request_dispatcher (continued) **
+ ************************************/
+
+void Block::Request_dispatcher::add(Multi_session_component &session) {
+	_clients.insert(&session); }
+
+
+void Block::Request_dispatcher::remove(Multi_session_component &session,
+                                       Ram_dataspace_capability buffer)
+{
+	/* requests in flight are acknowledged to nobody */
+	for (unsigned i = 0; i < MAX_TAGS; i++)
+		if (_tags[i].session == &session) {
+			_tags[i].session         = nullptr;
+			_tags[i].orphaned_buffer = buffer;
+		}
+
+	if (_barrier_session == &session)
+		_barrier_session = nullptr;
+
+	_policy.removed(session);
+	_clients.remove(&session);
+}
+
+
+Block::Driver::Request
+Block::Request_dispatcher::_request(Multi_session_component &session,
+                                    Packet_descriptor        packet)
+{
+	unsigned const tag = _free[--_num_free];
+	_tags[tag].session = &session;
+	_tags[tag].packet  = packet;
+	_tags[tag].used    = true;
+
+	if (packet.barrier())
+		_barrier_in_flight = true;
+
+	Driver::Request request;
+	request.packet = Packet_descriptor(Packet_descriptor(tag, packet.size()),
+	                                   packet.operation(),
+	                                   packet.block_number(),
+	                                   packet.block_count());
+	if (!packet.barrier()) {
+		request.buffer = session.content(packet);
+		request.phys   = session.phys(packet);
+	}
+	return request;
+}
+
+
+/**
+ * Free tag, hand the request back to its session or acknowledge it
+ */
+void Block::Request_dispatcher::_release_tag(unsigned tag, bool put_back,
+                                             bool success)
+{
+	Tag const t = _tags[tag];
+	_tags[tag] = Tag();
+	_free[_num_free++] = tag;
+
+	if (t.packet.barrier()) {
+		_barrier_in_flight = false;
+
+		/* a barrier handed back keeps its precedence */
+		if (put_back)
+			_barrier_session = t.session;
+	}
+
+	if (t.orphaned_buffer.valid() && !_buffer_in_use(t.orphaned_buffer))
+		_driver->free_dma_buffer(t.orphaned_buffer);
+
+	if (!t.session)
+		return;
+
+	if (put_back) {
+		t.session->put_back(t.packet);
+		_policy.handed_back(*t.session);
+	} else {
+		t.session->ack(t.packet, success);
+	}
+}
+
+
+void Block::Request_dispatcher::_submit(Driver::Request *batch, unsigned n)
+{
+	unsigned long const acks     = _acks;
+	unsigned            accepted = 0;
+
+	Driver::Submit_status const status = _driver->submit(batch, n, accepted);
+	if (status == Driver::Submit_status::ACCEPTED)
+		return;
+
+	/* hand back the requests not looked at, the last one first */
+	for (unsigned i = n; i-- > accepted + 1; )
+		_release_tag(batch[i].packet.offset(), true, false);
+
+	unsigned const tag = batch[accepted].packet.offset();
+
+	if (status == Driver::Submit_status::REJECTED) {
+		_release_tag(tag, false, false);
+		return;
+	}
+
+	_release_tag(tag, true, false);
+
+	/* wait for an acknowledgement unless one arrived during the call */
+	if (_acks == acks)
+		_congested = true;
+}
+
+
+void Block::Request_dispatcher::_update_waiting(uint64_t now_us)
+{
+	for (Scheduling_client *c = _clients.first(); c; c = c->next())
+		if (!c->ready())
+			c->waiting_since_us = 0;
+		else if (!c->waiting_since_us)
+			c->waiting_since_us = now_us;
+}
+
+
+void Block::Request_dispatcher::dispatch()
+{
+	/* requests acknowledged from within the driver call are picked up below */
+	if (!_driver || _dispatching)
+		return;
+
+	_dispatching = true;
+
+	while (!_congested && !_barrier_in_flight) {
+
+		Driver::Request batch[BATCH];
+		unsigned        n   = 0;
+		uint64_t const  now = _policy.now_us();
+
+		_update_waiting(now);
+
+		while (n < BATCH && _num_free) {
+
+			/* a barrier waiting for the device to drain takes precedence */
+			Multi_session_component *s = _barrier_session;
+			if (s && (n || _in_flight() || !s->ready()))
+				break;
+
+			if (!s)
+				s = static_cast<Multi_session_component *>(_policy.select(_clients));
+			if (!s)
+				break;
+
+			Packet_descriptor const p = s->take();
+			_policy.taken(*s);
+			s->waiting_since_us = now;
+
+			if (!s->permitted(p)) {
+				s->ack(p, false);
+				continue;
+			}
+
+			if (p.barrier() && (n || _in_flight())) {
+				s->put_back(p);
+				_policy.handed_back(*s);
+				_barrier_session = s;
+				break;
+			}
+
+			batch[n++] = _request(*s, p);
+
+			if (p.barrier()) {
+				_barrier_session = nullptr;
+				break;
+			}
+		}
+
+		if (!n)
+			break;
+
+		_submit(batch, n);
+	}
+
+	_dispatching = false;
+}
+
+
+void Block::Request_dispatcher::ack_packet(Packet_descriptor &packet,
+                                           bool success)
+{
+	unsigned long const tag = packet.offset();
+	if (tag >= MAX_TAGS || !_tags[tag].used) {
+		error("driver acknowledged unknown request");
+		return;
+	}
+
+	_acks++;
+	_congested = false;
+	_release_tag(tag, false, success);
+
+	dispatch();
+}
+
+
+/**
+ * Root component, handling new session requests
+ *
+ * The scheduling parameters of a session are taken from the session policy
+ * matching its label, e.g.,
+ *
+ * ! <policy label_prefix="db" weight="4" deadline_ms="10" writeable="yes"/>
+ */
+class Block::Multi_root : public Genode::Root_component<Block::Multi_session_component>
+{
+	private:
+
+		Request_dispatcher              _dispatcher;
+		Genode::Entrypoint             &_ep;
+		Genode::Region_map             &_rm;
+		Genode::Attached_rom_dataspace &_config;
+		bool const                      _writeable;
+
+	protected:
+
+		Multi_session_component *_create_session(const char *args)
+		{
+			size_t ram_quota =
+				Arg_string::find_arg(args, "ram_quota"  ).ulong_value(0);
+			size_t tx_buf_size =
+				Arg_string::find_arg(args, "tx_buf_size").ulong_value(0);
+
+			/* delete ram quota by the memory needed for the session */
+			size_t session_size = max((size_t)4096,
+			                          sizeof(Multi_session_component)
+			                          + sizeof(Allocator_avl));
+			if (ram_quota < session_size)
+				throw Insufficient_ram_quota();
+
+			if (tx_buf_size > ram_quota - session_size) {
+				error("insufficient 'ram_quota', got ", ram_quota, ", need ",
+				     tx_buf_size + session_size);
+				throw Insufficient_ram_quota();
+			}
+
+			bool writeable = _writeable
+				? Arg_string::find_arg(args, "writeable").bool_value(true)
+				: false;
+
+			unsigned weight      = 1;
+			unsigned deadline_ms = 0;
+
+			Session_label const label = label_from_args(args);
+			try {
+				Session_policy const policy(label, _config.xml());
+
+				weight      = policy.attribute_value("weight",      weight);
+				deadline_ms = policy.attribute_value("deadline_ms", deadline_ms);
+				writeable   = writeable && policy.attribute_value("writeable", true);
+			} catch (Session_policy::No_policy_defined) { }
+
+			return new (md_alloc())
+				Multi_session_component(_dispatcher, _ep, _rm, tx_buf_size,
+				                        writeable, weight, deadline_ms*1000ULL);
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param ep              entrypoint handling this root component
+		 * \param md_alloc        allocator to allocate session components
+		 * \param rm              region map
+		 * \param driver_factory  factory to create and destroy driver backend
+		 * \param policy          policy for scheduling the requests of the
+		 *                        sessions
+		 * \param config          configuration containing the session
+		 *                        policies
+		 * \param writeable       true if sessions may modify the device
+		 */
+		Multi_root(Genode::Entrypoint             &ep,
+		           Allocator                      &md_alloc,
+		           Genode::Region_map             &rm,
+		           Driver_factory                 &driver_factory,
+		           Scheduling_policy              &policy,
+		           Genode::Attached_rom_dataspace &config,
+		           bool                            writeable)
+		:
+			Root_component(ep, md_alloc),
+			_dispatcher(driver_factory, policy),
+			_ep(ep), _rm(rm), _config(config), _writeable(writeable)
+		{ }
+};
+
+#endif /* _INCLUDE__BLOCK__MULTI_COMPONENT_H_ */
@@ -0,0 +1,253 @@
+/*
+ * \brief  Policies for scheduling the requests of multiple block sessions
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BLOCK__SCHEDULER_H_
+#define _INCLUDE__BLOCK__SCHEDULER_H_
+
+#include <base/stdint.h>
+#include <util/interface.h>
+#include <util/list.h>
+#include <timer_session/connection.h>
+
+namespace Block {
+	class Scheduling_client;
+	class Scheduling_policy;
+	class Round_robin_policy;
+	class Weighted_policy;
+	class Deadline_policy;
+};
+
+
+/**
+ * Queue of requests competing for a driver, i.e., a block session
+ */
+class Block::Scheduling_client : public Genode::List<Scheduling_client>::Element,
+                                 public Genode::Interface
+{
+	public:
+
+		unsigned         weight      = 1; /* requests per round */
+		Genode::uint64_t deadline_us = 0; /* latency target of a request */
+
+		/*
+		 * Bookkeeping of the request dispatcher and the policies
+		 */
+		Genode::uint64_t waiting_since_us = 0; /* time the head got ready */
+		unsigned         credit           = 0; /* requests left in round */
+
+		/**
+		 * Return true if a request can be taken from the client
+		 */
+		virtual bool ready() = 0;
+
+		Genode::uint64_t deadline() const {
+			return waiting_since_us + deadline_us; }
+};
+
+
+/**
+ * Interface of a policy selecting the client to serve next
+ */
+class Block::Scheduling_policy : public Genode::Interface
+{
+	public:
+
+		typedef Genode::List<Scheduling_client> Clients;
+
+	protected:
+
+		/**
+		 * Return first ready client following 'prev' in cyclic order
+		 */
+		static Scheduling_client *_next_ready(Clients &clients,
+		                                      Scheduling_client *prev)
+		{
+			Scheduling_client *first = prev && prev->next() ? prev->next()
+			                                                : clients.first();
+
+			for (Scheduling_client *c = first; c; ) {
+				if (c->ready())
+					return c;
+
+				c = c->next() ? c->next() : clients.first();
+				if (c == first)
+					break;
+			}
+			return nullptr;
+		}
+
+	public:
+
+		/**
+		 * Select client to take the next request from
+		 *
+		 * \return ready client, or nullptr if no client is ready
+		 */
+		virtual Scheduling_client *select(Clients &clients) = 0;
+
+		/**
+		 * Called after a request was taken from the selected client
+		 */
+		virtual void taken(Scheduling_client &) { }
+
+		/**
+		 * Called if a taken request was handed back to the client
+		 */
+		virtual void handed_back(Scheduling_client &) { }
+
+		/**
+		 * Called before the client is removed from the list of clients
+		 */
+		virtual void removed(Scheduling_client &) { }
+
+		/**
+		 * Current time in microseconds, needed by time-based policies only
+		 */
+		virtual Genode::uint64_t now_us() { return 0; }
+};
+
+
+/**
+ * Serve one request of each ready client in turn
+ */
+class Block::Round_robin_policy : public Scheduling_policy
+{
+	private:
+
+		Scheduling_client *_last = nullptr;
+
+	public:
+
+		Round_robin_policy() { }
+
+		Scheduling_client *select(Clients &clients) override {
+			return _next_ready(clients, _last); }
+
+		void taken(Scheduling_client &client) override { _last = &client; }
+
+		void removed(Scheduling_client &client) override
+		{
+			if (_last == &client)
+				_last = nullptr;
+		}
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Round_robin_policy(Round_robin_policy const &);
+		Round_robin_policy &operator = (Round_robin_policy const &);
+};
+
+
+/**
+ * Serve up to 'weight' requests of each ready client in turn
+ */
+class Block::Weighted_policy : public Scheduling_policy
+{
+	private:
+
+		Scheduling_client *_current = nullptr;
+
+	public:
+
+		Weighted_policy() { }
+
+		Scheduling_client *select(Clients &clients) override
+		{
+			if (_current && _current->credit && _current->ready())
+				return _current;
+
+			_current = _next_ready(clients, _current);
+			if (_current)
+				_current->credit = _current->weight ? _current->weight : 1;
+
+			return _current;
+		}
+
+		void taken(Scheduling_client &client) override
+		{
+			if (client.credit)
+				client.credit--;
+		}
+
+		void handed_back(Scheduling_client &client) override
+		{
+			/* refund the credit consumed by 'taken' */
+			if (client.credit < (client.weight ? client.weight : 1))
+				client.credit++;
+		}
+
+		void removed(Scheduling_client &client) override
+		{
+			if (_current == &client)
+				_current = nullptr;
+		}
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Weighted_policy(Weighted_policy const &);
+		Weighted_policy &operator = (Weighted_policy const &);
+};
+
+
+/**
+ * Serve the ready client with the earliest deadline first
+ *
+ * The deadline of a client is the time its next request got ready plus the
+ * client's latency target. Clients without a latency target ('deadline_us'
+ * of 0) are served whenever their request waits longest.
+ */
+class Block::Deadline_policy : public Scheduling_policy
+{
+	private:
+
+		Timer::Connection &_timer;
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param timer  timer connection used in modern mode, i.e., for
+		 *               'curr_time' only
+		 */
+		Deadline_policy(Timer::Connection &timer) : _timer(timer) { }
+
+		Scheduling_client *select(Clients &clients) override
+		{
+			Scheduling_client *earliest = nullptr;
+			for (Scheduling_client *c = clients.first(); c; c = c->next())
+				if (c->ready() && (!earliest || c->deadline() < earliest->deadline()))
+					earliest = c;
+
+			return earliest;
+		}
+
+		Genode::uint64_t now_us() override {
+			return _timer.curr_time().trunc_to_plain_us().value; }
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Deadline_policy(Deadline_policy const &);
+		Deadline_policy &operator = (Deadline_policy const &);
+};
+
+#endif /* _INCLUDE__BLOCK__SCHEDULER_H_ */
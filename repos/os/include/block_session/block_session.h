@@ -36,12 +36,23 @@ namespace Block {
  * The data associated with the 'Packet_descriptor' is either
  * the data read from or written to the block indicated by
  * its number.
+ *
+ * 'SYNC' and 'TRIM' requests carry no data. 'SYNC' requests the blocks of
+ * the given range to be written to the medium. A block count of zero
+ * refers to the whole device. 'TRIM' informs the device that the content
+ * of the given blocks is no longer needed. The content of trimmed blocks
+ * is undefined until they are written again.
+ *
+ * Both operations are ordered with respect to the other requests of the
+ * session. They are executed not before all requests submitted earlier are
+ * completed, and requests submitted later are not executed before the
+ * 'SYNC' or 'TRIM' request is completed.
  */
 class Block::Packet_descriptor : public Genode::Packet_descriptor
 {
 	public:
 
-		enum Opcode    { READ, WRITE, END };
+		enum Opcode    { READ, WRITE, SYNC, TRIM, END };
 		enum Alignment { PACKET_ALIGNMENT = 11 };
 
 	private:
@@ -78,6 +89,12 @@ class Block::Packet_descriptor : public Genode::Packet_descriptor
 		Genode::size_t block_count()  const { return _block_count;  }
 		bool           succeeded()    const { return _success;      }
 
+		/**
+		 * Return true if the request is ordered with respect to all other
+		 * requests of the session
+		 */
+		bool barrier() const { return _op == SYNC || _op == TRIM; }
+
 		void succeeded(bool b) { _success = b ? 1 : 0; }
 };
 
@@ -149,6 +166,10 @@ struct Block::Session : public Genode::Session
 
 	/**
 	 * Synchronize with block device, like ensuring data to be written
+	 *
+	 * This call blocks the client until the synchronization is finished.
+	 * The 'SYNC' request of the packet stream is the non-blocking
+	 * alternative.
 	 */
 	virtual void sync() = 0;
 
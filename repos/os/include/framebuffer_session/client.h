@@ -38,6 +38,12 @@ struct Framebuffer::Session_client : Genode::Rpc_client<Session>
 
 	void refresh(int x, int y, int w, int h) override {
 		call<Rpc_refresh>(x, y, w, h); }
+
+	Genode::Dataspace_capability damage_dataspace() override {
+		return call<Rpc_damage_dataspace>(); }
+
+	Genode::Signal_context_capability damage_sigh() override {
+		return call<Rpc_damage_sigh>(); }
 };
 
 #endif /* _INCLUDE__FRAMEBUFFER_SESSION__CLIENT_H_ */
@@ -0,0 +1,179 @@
+/*
+ * \brief  Shared-memory ring of damaged framebuffer regions
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__FRAMEBUFFER_SESSION__DAMAGE_RING_H_
+#define _INCLUDE__FRAMEBUFFER_SESSION__DAMAGE_RING_H_
+
+#include <base/attached_dataspace.h>
+#include <cpu/memory_barrier.h>
+#include <util/reconstructible.h>
+#include <framebuffer_session/connection.h>
+
+namespace Framebuffer {
+
+	struct Damage_ring;
+	class  Damage_submitter;
+}
+
+
+/**
+ * Ring of rectangles written by the client and consumed by the server
+ *
+ * The ring is located at the start of the dataspace obtained via
+ * 'Session::damage_dataspace'. The client is the only writer of 'head' and
+ * 'overflows', the server is the only writer of 'tail'. If the ring is
+ * full, the client counts an overflow instead of adding the rectangle,
+ * which makes the server refresh the whole screen.
+ */
+struct Framebuffer::Damage_ring
+{
+	enum { CAPACITY = 128 };
+
+	struct Rect { int x, y, w, h; };
+
+	unsigned volatile head;
+	unsigned volatile tail;
+	unsigned volatile overflows;
+
+	Rect rects[CAPACITY];
+
+	/**
+	 * Add rectangle, called by the client
+	 */
+	void submit(int x, int y, int w, int h)
+	{
+		if (head - tail >= CAPACITY) {
+			overflows = overflows + 1;
+			return;
+		}
+
+		Rect &r = rects[head % CAPACITY];
+		r.x = x; r.y = y; r.w = w; r.h = h;
+
+		/* make the rectangle visible before the new head */
+		Genode::memory_barrier();
+		head = head + 1;
+	}
+
+	/**
+	 * Consume rectangles, called by the server
+	 *
+	 * A head more than 'CAPACITY' entries ahead of the tail, which only a
+	 * misbehaving client can cause, is handled as an overflow.
+	 *
+	 * \param overflows_seen  number of overflows already handled
+	 * \param fn              functor called with each 'Rect'
+	 *
+	 * \return true if the ring overflowed, i.e., the whole screen is damaged
+	 */
+	template <typename FN>
+	bool consume(unsigned &overflows_seen, FN const &fn)
+	{
+		unsigned const h = head;
+		Genode::memory_barrier();
+
+		unsigned const t_start = tail;
+		if (h - t_start > CAPACITY) {
+			tail = h;
+			overflows_seen = overflows;
+			return true;
+		}
+
+		for (unsigned t = t_start; t != h; t++) {
+			Rect const r = rects[t % CAPACITY];
+
+			/* release the entry only after reading it */
+			Genode::memory_barrier();
+			tail = t + 1;
+
+			fn(r);
+		}
+
+		unsigned const o = overflows;
+		bool const overflowed = (o != overflows_seen);
+		overflows_seen = o;
+		return overflowed;
+	}
+};
+
+
+/**
+ * Client-side utility for reporting damaged regions
+ *
+ * The regions are collected in the damage ring, and 'flush' notifies the
+ * server once for all regions. If the server provides no damage ring, each
+ * region is reported via 'refresh'.
+ */
+class Framebuffer::Damage_submitter
+{
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Damage_submitter(Damage_submitter const &);
+		Damage_submitter &operator = (Damage_submitter const &);
+
+		Connection &_connection;
+
+		Genode::Constructible<Genode::Attached_dataspace> _ds { };
+
+		Genode::Signal_context_capability _sigh { };
+
+		Damage_ring *_ring    = nullptr;
+		bool         _pending = false;
+
+	public:
+
+		Damage_submitter(Genode::Region_map &rm, Connection &connection)
+		: _connection(connection)
+		{
+			/* donate the capabilities consumed by the ring */
+			try { _connection.upgrade_caps(Session::DAMAGE_RING_CAP_QUOTA); }
+			catch (Genode::Out_of_ram)  { return; }
+			catch (Genode::Out_of_caps) { return; }
+
+			Genode::Dataspace_capability const ds = _connection.damage_dataspace();
+			if (!ds.valid())
+				return;
+
+			_ds.construct(rm, ds);
+			_sigh = _connection.damage_sigh();
+			_ring = _ds->local_addr<Damage_ring>();
+		}
+
+		void damage(int x, int y, int w, int h)
+		{
+			if (!_ring) {
+				_connection.refresh(x, y, w, h);
+				return;
+			}
+
+			_ring->submit(x, y, w, h);
+			_pending = true;
+		}
+
+		/**
+		 * Notify server about the regions damaged since the last call
+		 */
+		void flush()
+		{
+			if (!_pending)
+				return;
+
+			_pending = false;
+			Genode::Signal_transmitter(_sigh).submit();
+		}
+};
+
+#endif /* _INCLUDE__FRAMEBUFFER_SESSION__DAMAGE_RING_H_ */
@@ -36,12 +36,15 @@ struct Framebuffer::Mode
 
 		/**
 		 * Pixel formats
+		 *
+		 * 'RGB888' refers to 32-bit pixels with the upper 8 bits unused.
 		 */
-		enum Format { INVALID, RGB565 };
+		enum Format { INVALID, RGB565, RGB888 };
 
 		static Genode::size_t bytes_per_pixel(Format format)
 		{
 			if (format == RGB565) return 2;
+			if (format == RGB888) return 4;
 			return 0;
 		}
 
@@ -72,6 +75,7 @@ struct Framebuffer::Mode
 			Genode::print(out, _width, "x", _height, "@");
 			switch (_format) {
 			case RGB565: Genode::print(out, "RGB565");  break;
+			case RGB888: Genode::print(out, "RGB888");  break;
 			default:     Genode::print(out, "INVALID"); break;
 			}
 		}
@@ -92,6 +96,13 @@ struct Framebuffer::Session : Genode::Session
 	 */
 	enum { CAP_QUOTA = 3 };
 
+	/*
+	 * The damage ring consumes a dataspace capability and a signal-context
+	 * capability. A client donates them via a session upgrade before
+	 * requesting the ring.
+	 */
+	enum { DAMAGE_RING_CAP_QUOTA = 2 };
+
 	typedef Session_client Client;
 
 	virtual ~Session() { }
@@ -138,6 +149,26 @@ struct Framebuffer::Session : Genode::Session
 	 */
 	virtual void sync_sigh(Genode::Signal_context_capability) = 0;
 
+	/**
+	 * Request dataspace containing the ring of damaged regions
+	 *
+	 * The dataspace starts with a 'Damage_ring'. Instead of calling
+	 * 'refresh' for each region, the client adds the regions to the ring
+	 * and notifies the server once via the signal handler returned by
+	 * 'damage_sigh'.
+	 *
+	 * \return invalid capability if the server does not provide a
+	 *         damage ring
+	 */
+	virtual Genode::Dataspace_capability damage_dataspace() {
+		return Genode::Dataspace_capability(); }
+
+	/**
+	 * Request signal handler for notifying the server about damaged regions
+	 */
+	virtual Genode::Signal_context_capability damage_sigh() {
+		return Genode::Signal_context_capability(); }
+
 
 	/*********************
 	 ** RPC declaration **
@@ -148,9 +179,11 @@ struct Framebuffer::Session : Genode::Session
 	GENODE_RPC(Rpc_refresh, void, refresh, int, int, int, int);
 	GENODE_RPC(Rpc_mode_sigh, void, mode_sigh, Genode::Signal_context_capability);
 	GENODE_RPC(Rpc_sync_sigh, void, sync_sigh, Genode::Signal_context_capability);
+	GENODE_RPC(Rpc_damage_dataspace, Genode::Dataspace_capability, damage_dataspace);
+	GENODE_RPC(Rpc_damage_sigh, Genode::Signal_context_capability, damage_sigh);
 
 	GENODE_RPC_INTERFACE(Rpc_dataspace, Rpc_mode, Rpc_mode_sigh, Rpc_refresh,
-	                     Rpc_sync_sigh);
+	                     Rpc_sync_sigh, Rpc_damage_dataspace, Rpc_damage_sigh);
 };
 
 #endif /* _INCLUDE__FRAMEBUFFER_SESSION__FRAMEBUFFER_SESSION_H_ */
@@ -54,6 +54,17 @@ class Nic::Session_component : Communication_buffers, public Session_rpc_object
 		Genode::Entrypoint               &_ep;
 		Genode::Signal_context_capability _link_state_sigh { };
 
+		bool _offload = false;
+
+		/**
+		 * Enable the use of 'Offload_header' meta data
+		 *
+		 * Drivers that support offloading override this method.
+		 *
+		 * \return true if the packets of the session carry offload headers
+		 */
+		virtual bool _enable_offload() { return false; }
+
 
 		/**
 		 * Signal link-state change to client
@@ -146,6 +157,13 @@ class Nic::Session_component : Communication_buffers, public Session_rpc_object
 			_link_state_sigh = sigh;
 		}
 
+		/**
+		 * Respond to the client's request for offloading
+		 */
+		void request_offload() { _offload = _enable_offload(); }
+
+		bool offload() override { return _offload; }
+
 		/**
 		 * Return the current link state
 		 */
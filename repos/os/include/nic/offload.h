@@ -0,0 +1,199 @@
+/*
+ * \brief  Software fallback for checksum and segmentation offloading
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The last hop of a packet with 'Offload_header' meta data uses these
+ * utilities if the underlying device is unable to process the meta data.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__NIC__OFFLOAD_H_
+#define _INCLUDE__NIC__OFFLOAD_H_
+
+#include <nic_session/nic_session.h>
+#include <util/string.h>
+
+namespace Nic { struct Offload; }
+
+
+struct Nic::Offload
+{
+	typedef Genode::uint8_t  uint8_t;
+	typedef Genode::uint16_t uint16_t;
+	typedef Genode::uint32_t uint32_t;
+	typedef Genode::size_t   size_t;
+
+	enum {
+		ETH_HLEN       = 14,
+		VLAN_HLEN      = 4,
+		ETH_TYPE_VLAN  = 0x8100,
+		IPV6_HLEN      = 40,
+		IP_PROTO_TCP   = 6,
+		TCP_FLAG_FIN   = 0x01,
+		TCP_FLAG_PSH   = 0x08,
+		TCP_FLAG_CWR   = 0x80,
+	};
+
+	static uint16_t _get16(uint8_t const *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+
+	static uint32_t _get32(uint8_t const *p) {
+		return (uint32_t)_get16(p) << 16 | _get16(p + 2); }
+
+	static void _put16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xff; }
+
+	static void _put32(uint8_t *p, uint32_t v) {
+		_put16(p, v >> 16); _put16(p + 2, v & 0xffff); }
+
+	/**
+	 * Sum up data as 16-bit big-endian words
+	 */
+	static uint32_t _sum(uint8_t const *data, size_t len, uint32_t sum = 0)
+	{
+		for (; len > 1; data += 2, len -= 2)
+			sum += _get16(data);
+
+		if (len)
+			sum += (uint32_t)data[0] << 8;
+
+		return sum;
+	}
+
+	/**
+	 * Return one's complement of the folded sum
+	 */
+	static uint16_t _fold(uint32_t sum)
+	{
+		while (sum >> 16)
+			sum = (sum & 0xffff) + (sum >> 16);
+
+		return (uint16_t)~sum;
+	}
+
+	/**
+	 * Calculate the checksum requested by the 'CSUM_NEEDED' flag
+	 *
+	 * The checksum field initially holds the checksum of the pseudo
+	 * header. The data starting at 'csum_start' is added to it.
+	 */
+	static void complete_checksum(Offload_header const &hdr,
+	                              uint8_t *frame, size_t len)
+	{
+		if (!(hdr.flags & Offload_header::CSUM_NEEDED))
+			return;
+
+		size_t const pos = (size_t)hdr.csum_start + hdr.csum_offset;
+		if (hdr.csum_start >= len || pos + 2 > len)
+			return;
+
+		_put16(frame + pos, _fold(_sum(frame + hdr.csum_start,
+		                               len - hdr.csum_start)));
+	}
+
+	/**
+	 * Call 'fn' for each Ethernet frame contained in 'frame'
+	 *
+	 * \param buf       scratch buffer used for assembling the segments of
+	 *                  a super frame
+	 * \param buf_size  size of 'buf', must cover the headers of the frame
+	 *                  plus 'gso_size' bytes
+	 * \param fn        functor called with the frame base and size
+	 *
+	 * \return false if the frame cannot be segmented, e.g., because of an
+	 *         unsupported segmentation type
+	 *
+	 * A frame without segmentation is passed to 'fn' as is, with the
+	 * checksum completed if requested. TCP super frames over IPv4 and IPv6
+	 * are split into segments of 'gso_size' payload bytes each.
+	 */
+	template <typename FN>
+	static bool for_each_frame(Offload_header const &hdr,
+	                           uint8_t *frame, size_t len,
+	                           uint8_t *buf, size_t buf_size, FN const &fn)
+	{
+		unsigned const gso_type = hdr.gso_type & ~Offload_header::GSO_ECN;
+
+		if (gso_type == Offload_header::GSO_NONE) {
+			complete_checksum(hdr, frame, len);
+			fn(frame, len);
+			return true;
+		}
+
+		bool const ipv4 = (gso_type == Offload_header::GSO_TCPV4);
+		bool const ipv6 = (gso_type == Offload_header::GSO_TCPV6);
+
+		if ((!ipv4 && !ipv6) || hdr.gso_size == 0 || len < ETH_HLEN)
+			return false;
+
+		/* locate IP and TCP headers */
+		size_t const ip_off = ETH_HLEN + (_get16(frame + 12) == ETH_TYPE_VLAN
+		                                  ? VLAN_HLEN : 0);
+		if (ip_off + IPV6_HLEN > len)
+			return false;
+
+		size_t const ip_hlen = ipv4 ? (size_t)(frame[ip_off] & 0xf)*4
+		                            : (size_t)IPV6_HLEN;
+		size_t const tcp_off = ip_off + ip_hlen;
+		if (tcp_off + 20 > len)
+			return false;
+
+		size_t const tcp_hlen = (size_t)(frame[tcp_off + 12] >> 4)*4;
+		size_t const hdr_len  = tcp_off + tcp_hlen;
+		if (hdr_len > len || hdr_len + hdr.gso_size > buf_size)
+			return false;
+
+		size_t   const payload = len - hdr_len;
+		uint32_t const seq     = _get32(frame + tcp_off + 4);
+		uint16_t const id      = _get16(frame + ip_off + 4);
+
+		for (size_t off = 0, i = 0; off < payload; off += hdr.gso_size, i++) {
+
+			size_t const seg  = Genode::min((size_t)hdr.gso_size, payload - off);
+			bool   const last = (off + seg == payload);
+
+			Genode::memcpy(buf, frame, hdr_len);
+			Genode::memcpy(buf + hdr_len, frame + hdr_len + off, seg);
+
+			uint8_t * const ip  = buf + ip_off;
+			uint8_t * const tcp = buf + tcp_off;
+
+			size_t const tcp_len = tcp_hlen + seg;
+
+			uint32_t pseudo = 0;
+			if (ipv4) {
+				_put16(ip + 2, (uint16_t)(ip_hlen + tcp_len));
+				_put16(ip + 4, (uint16_t)(id + i));
+				_put16(ip + 10, 0);
+				_put16(ip + 10, _fold(_sum(ip, ip_hlen)));
+
+				pseudo = _sum(ip + 12, 8);
+			} else {
+				_put16(ip + 4, (uint16_t)tcp_len);
+
+				pseudo = _sum(ip + 8, 32);
+			}
+			pseudo += IP_PROTO_TCP + (uint32_t)tcp_len;
+
+			_put32(tcp + 4, seq + (uint32_t)off);
+
+			if (!last)
+				tcp[13] &= (uint8_t)~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+			if (i > 0)
+				tcp[13] &= (uint8_t)~TCP_FLAG_CWR;
+
+			_put16(tcp + 16, 0);
+			_put16(tcp + 16, _fold(_sum(tcp, tcp_len, pseudo)));
+
+			fn(buf, hdr_len + seg);
+		}
+		return true;
+	}
+};
+
+#endif /* _INCLUDE__NIC__OFFLOAD_H_ */
@@ -59,9 +59,14 @@ class Nic::Root : public Genode::Root_component<SESSION_COMPONENT,
 				throw Genode::Insufficient_ram_quota();
 			}
 
-			return new (Root::md_alloc())
+			SESSION_COMPONENT *session = new (Root::md_alloc())
 			            SESSION_COMPONENT(tx_buf_size, rx_buf_size,
 			                             _md_alloc, _env);
+
+			if (Arg_string::find_arg(args, "offload").bool_value(false))
+				session->request_offload();
+
+			return session;
 		}
 
 	public:
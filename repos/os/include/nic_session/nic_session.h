@@ -27,6 +27,7 @@ namespace Nic {
 	using Mac_address = Net::Mac_address;
 
 	struct Session;
+	struct Offload_header;
 
 	using Genode::Packet_stream_sink;
 	using Genode::Packet_stream_source;
@@ -35,6 +36,46 @@ namespace Nic {
 }
 
 
+/*
+ * Meta data of a packet of a session with offloading enabled
+ *
+ * A client may request the offloading of checksum calculation and
+ * segmentation by specifying the session argument 'offload="yes"'. If the
+ * server supports it, as indicated by 'Session::offload', each packet
+ * transmitted in either direction starts with an 'Offload_header' followed
+ * by the Ethernet frame. In this case, a frame may be a generic-segmentation
+ * super frame of up to 64 KiB that gets segmented at the last hop only.
+ *
+ * The layout corresponds to the 'virtio_net_hdr' structure. All values are
+ * in host byte order.
+ */
+struct Nic::Offload_header
+{
+	enum Flags {
+		CSUM_NEEDED = 1,  /* checksum must be calculated from 'csum_start' */
+		CSUM_VALID  = 2,  /* checksum was already validated */
+	};
+
+	enum Gso_type {
+		GSO_NONE  = 0,
+		GSO_TCPV4 = 1,
+		GSO_UDP   = 3,
+		GSO_TCPV6 = 4,
+		GSO_ECN   = 0x80,
+	};
+
+	Genode::uint8_t  flags       = 0;
+	Genode::uint8_t  gso_type    = GSO_NONE;
+	Genode::uint16_t hdr_len     = 0;  /* length of the headers of a segment */
+	Genode::uint16_t gso_size    = 0;  /* payload size of a segment */
+	Genode::uint16_t csum_start  = 0;  /* start of checksummed data */
+	Genode::uint16_t csum_offset = 0;  /* checksum position from 'csum_start' */
+
+	enum { MAX_FRAME_SIZE = 14 + 65535 };
+
+} __attribute__((packed));
+
+
 /*
  * NIC session interface
  *
@@ -116,6 +157,11 @@ struct Nic::Session : Genode::Session
 	 */
 	virtual void link_state_sigh(Genode::Signal_context_capability sigh) = 0;
 
+	/**
+	 * Return true if packets are preceded by an 'Offload_header'
+	 */
+	virtual bool offload() { return false; }
+
 	/*******************
 	 ** RPC interface **
 	 *******************/
@@ -126,9 +172,11 @@ struct Nic::Session : Genode::Session
 	GENODE_RPC(Rpc_link_state, bool, link_state);
 	GENODE_RPC(Rpc_link_state_sigh, void, link_state_sigh,
 	           Genode::Signal_context_capability);
+	GENODE_RPC(Rpc_offload, bool, offload);
 
 	GENODE_RPC_INTERFACE(Rpc_mac_address, Rpc_link_state,
-	                     Rpc_link_state_sigh, Rpc_tx_cap, Rpc_rx_cap);
+	                     Rpc_link_state_sigh, Rpc_tx_cap, Rpc_rx_cap,
+	                     Rpc_offload);
 };
 
 #endif /* _INCLUDE__NIC_SESSION__NIC_SESSION_H_ */
@@ -15,6 +15,7 @@
 #define _INCLUDE__NITPICKER_GFX__BOX_PAINTER_H_
 
 #include <os/surface.h>
+#include <nitpicker_gfx/pixel_span.h>
 
 
 struct Box_painter
@@ -37,19 +38,17 @@ struct Box_painter
 		if (!clipped.valid()) return;
 
 		PT pix(color.r, color.g, color.b);
-		PT *dst, *dst_line = surface.addr() + surface.size().w()*clipped.y1() + clipped.x1();
+		PT *dst_line = surface.addr() + surface.size().w()*clipped.y1() + clipped.x1();
 
 		int const alpha = color.a;
 
 		if (color.opaque())
-			for (int w, h = clipped.h() ; h--; dst_line += surface.size().w())
-				for (dst = dst_line, w = clipped.w(); w--; dst++)
-					*dst = pix;
+			for (int h = clipped.h() ; h--; dst_line += surface.size().w())
+				Pixel_span::fill(dst_line, clipped.w(), pix);
 
 		else if (!color.transparent())
-			for (int w, h = clipped.h() ; h--; dst_line += surface.size().w())
-				for (dst = dst_line, w = clipped.w(); w--; dst++)
-					*dst = PT::mix(*dst, pix, alpha);
+			for (int h = clipped.h() ; h--; dst_line += surface.size().w())
+				Pixel_span::mix(dst_line, clipped.w(), pix, alpha);
 
 		surface.flush_pixels(clipped);
 	}
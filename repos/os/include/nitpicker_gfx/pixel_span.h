@@ -0,0 +1,242 @@
+/*
+ * \brief  Operations on horizontal spans of pixels
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__NITPICKER_GFX__PIXEL_SPAN_H_
+#define _INCLUDE__NITPICKER_GFX__PIXEL_SPAN_H_
+
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
+
+
+/**
+ * Inner loops of the painters
+ *
+ * The generic functions process one pixel at a time using the operations of
+ * the pixel type. For 'Pixel_rgb565' and 'Pixel_rgb888', there exist
+ * overloads that process four pixels at once if the compiler targets a
+ * SIMD instruction set, i.e., SSE2 on x86_64 or NEON on ARM. The overloads
+ * implement the arithmetics of the pixel type lane by lane and therefore
+ * yield the same results as the generic functions.
+ */
+namespace Pixel_span {
+
+	/**
+	 * Set 'n' pixels to 'pixel'
+	 */
+	template <typename PT>
+	static inline void fill(PT *dst, unsigned n, PT pixel) {
+		for (; n--; dst++) *dst = pixel; }
+
+	/**
+	 * Mix 'n' pixels with 'pixel' at the ratio 'alpha'
+	 */
+	template <typename PT>
+	static inline void mix(PT *dst, unsigned n, PT pixel, int alpha) {
+		for (; n--; dst++) *dst = PT::mix(*dst, pixel, alpha); }
+
+	/**
+	 * Mix 'n' pixels with source pixels according to an alpha channel
+	 *
+	 * Destination pixels with an alpha value of 0 stay untouched.
+	 */
+	template <typename PT>
+	static inline void mix_alpha(PT *dst, PT const *src,
+	                             unsigned char const *alpha, unsigned n)
+	{
+		for (; n--; dst++, src++, alpha++)
+			if (*alpha) *dst = PT::mix(*dst, *src, *alpha);
+	}
+
+	/**
+	 * Set 'n' pixels to the average of the source pixels and 'pixel'
+	 */
+	template <typename PT>
+	static inline void avr(PT *dst, PT const *src, unsigned n, PT pixel) {
+		for (; n--; dst++, src++) *dst = PT::avr(pixel, *src); }
+
+	/**
+	 * Copy 'n' pixels except for those with a value of 0
+	 */
+	template <typename PT>
+	static inline void copy_masked(PT *dst, PT const *src, unsigned n) {
+		for (; n--; dst++, src++) if (src->pixel) *dst = *src; }
+}
+
+
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+
+namespace Pixel_span {
+
+	namespace Simd {
+
+		typedef Genode::uint32_t V __attribute__((vector_size(16)));
+
+		/* vector type for accessing memory of 32-bit alignment */
+		typedef V V_unaligned __attribute__((aligned(4)));
+
+		enum { LANES = sizeof(V) / sizeof(Genode::uint32_t) };
+
+		static inline V load(Genode::Pixel_rgb888 const *p) {
+			return *(V_unaligned const *)p; }
+
+		static inline void store(Genode::Pixel_rgb888 *p, V v) {
+			*(V_unaligned *)p = v; }
+
+		static inline V load(Genode::Pixel_rgb565 const *p) {
+			return V { p[0].pixel, p[1].pixel, p[2].pixel, p[3].pixel }; }
+
+		static inline void store(Genode::Pixel_rgb565 *p, V v)
+		{
+			p[0].pixel = (unsigned short)v[0]; p[1].pixel = (unsigned short)v[1];
+			p[2].pixel = (unsigned short)v[2]; p[3].pixel = (unsigned short)v[3];
+		}
+
+		static inline V load(unsigned char const *a) {
+			return V { a[0], a[1], a[2], a[3] }; }
+
+		static inline V select(V mask, V a, V b) { return (a & mask) | (b & ~mask); }
+
+		/*
+		 * Lane-wise counterparts of the pixel operations
+		 */
+
+		static inline V blend(Genode::Pixel_rgb888 const *, V p, V alpha)
+		{
+			return ((alpha * ((p & 0xff00) >> 8)) & 0xff00)
+			     | (((alpha * (p & 0xff00ff)) >> 8) & 0xff00ff);
+		}
+
+		static inline V mix(Genode::Pixel_rgb888 const *type, V p1, V p2, V alpha) {
+			return blend(type, p1, 255 - alpha) + blend(type, p2, alpha); }
+
+		static inline V avr(Genode::Pixel_rgb888 const *, V p1, V p2) {
+			return ((p1 & 0xfefefe) >> 1) + ((p2 & 0xfefefe) >> 1); }
+
+		static inline V blend(Genode::Pixel_rgb565 const *, V p, V alpha)
+		{
+			return ((((alpha >> 3) * (p & 0xf81f)) >> 5) & 0xf81f)
+			     | (((alpha * (p & 0x07c0)) >> 8) & 0x07c0);
+		}
+
+		static inline V mix(Genode::Pixel_rgb565 const *type, V p1, V p2, V alpha) {
+			return blend(type, p1, 264 - alpha) + blend(type, p2, alpha); }
+
+		static inline V avr(Genode::Pixel_rgb565 const *, V p1, V p2) {
+			return ((p1 & 0xf7df) >> 1) + ((p2 & 0xf7df) >> 1); }
+
+		static inline V broadcast(Genode::uint32_t value) {
+			return V { value, value, value, value }; }
+
+		template <typename PT>
+		static inline void fill(PT *dst, unsigned n, PT pixel)
+		{
+			V const v = broadcast(pixel.pixel);
+			for (; n >= LANES; n -= LANES, dst += LANES)
+				store(dst, v);
+
+			Pixel_span::fill<PT>(dst, n, pixel);
+		}
+
+		template <typename PT>
+		static inline void mix(PT *dst, unsigned n, PT pixel, int alpha)
+		{
+			V const p = broadcast(pixel.pixel), a = broadcast(alpha);
+			for (; n >= LANES; n -= LANES, dst += LANES)
+				store(dst, mix(dst, load(dst), p, a));
+
+			Pixel_span::mix<PT>(dst, n, pixel, alpha);
+		}
+
+		template <typename PT>
+		static inline void mix_alpha(PT *dst, PT const *src,
+		                             unsigned char const *alpha, unsigned n)
+		{
+			for (; n >= LANES; n -= LANES, dst += LANES, src += LANES, alpha += LANES) {
+
+				/* skip fully transparent parts, common at the edges of windows */
+				if (!(alpha[0] | alpha[1] | alpha[2] | alpha[3]))
+					continue;
+
+				V const a = load(alpha), d = load(dst);
+				store(dst, select((V)(a != 0), mix(dst, d, load(src), a), d));
+			}
+
+			Pixel_span::mix_alpha<PT>(dst, src, alpha, n);
+		}
+
+		template <typename PT>
+		static inline void avr(PT *dst, PT const *src, unsigned n, PT pixel)
+		{
+			V const p = broadcast(pixel.pixel);
+			for (; n >= LANES; n -= LANES, dst += LANES, src += LANES)
+				store(dst, avr(dst, p, load(src)));
+
+			Pixel_span::avr<PT>(dst, src, n, pixel);
+		}
+
+		template <typename PT>
+		static inline void copy_masked(PT *dst, PT const *src, unsigned n)
+		{
+			for (; n >= LANES; n -= LANES, dst += LANES, src += LANES) {
+				V const s = load(src);
+				store(dst, select((V)(s != 0), s, load(dst)));
+			}
+
+			Pixel_span::copy_masked<PT>(dst, src, n);
+		}
+	}
+
+	/*
+	 * Overloads for the pixel types supported by the vectorized functions
+	 */
+
+	static inline void fill(Genode::Pixel_rgb888 *dst, unsigned n, Genode::Pixel_rgb888 pixel) {
+		Simd::fill(dst, n, pixel); }
+
+	static inline void fill(Genode::Pixel_rgb565 *dst, unsigned n, Genode::Pixel_rgb565 pixel) {
+		Simd::fill(dst, n, pixel); }
+
+	static inline void mix(Genode::Pixel_rgb888 *dst, unsigned n, Genode::Pixel_rgb888 pixel, int alpha) {
+		Simd::mix(dst, n, pixel, alpha); }
+
+	static inline void mix(Genode::Pixel_rgb565 *dst, unsigned n, Genode::Pixel_rgb565 pixel, int alpha) {
+		Simd::mix(dst, n, pixel, alpha); }
+
+	static inline void mix_alpha(Genode::Pixel_rgb888 *dst, Genode::Pixel_rgb888 const *src,
+	                             unsigned char const *alpha, unsigned n) {
+		Simd::mix_alpha(dst, src, alpha, n); }
+
+	static inline void mix_alpha(Genode::Pixel_rgb565 *dst, Genode::Pixel_rgb565 const *src,
+	                             unsigned char const *alpha, unsigned n) {
+		Simd::mix_alpha(dst, src, alpha, n); }
+
+	static inline void avr(Genode::Pixel_rgb888 *dst, Genode::Pixel_rgb888 const *src,
+	                       unsigned n, Genode::Pixel_rgb888 pixel) {
+		Simd::avr(dst, src, n, pixel); }
+
+	static inline void avr(Genode::Pixel_rgb565 *dst, Genode::Pixel_rgb565 const *src,
+	                       unsigned n, Genode::Pixel_rgb565 pixel) {
+		Simd::avr(dst, src, n, pixel); }
+
+	static inline void copy_masked(Genode::Pixel_rgb888 *dst, Genode::Pixel_rgb888 const *src,
+	                               unsigned n) {
+		Simd::copy_masked(dst, src, n); }
+
+	static inline void copy_masked(Genode::Pixel_rgb565 *dst, Genode::Pixel_rgb565 const *src,
+	                               unsigned n) {
+		Simd::copy_masked(dst, src, n); }
+}
+
+#endif /* __SSE2__ || __ARM_NEON__ */
+
+#endif /* _INCLUDE__NITPICKER_GFX__PIXEL_SPAN_H_ */
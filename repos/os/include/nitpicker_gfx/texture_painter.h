@@ -16,6 +16,7 @@
 
 #include <blit/blit.h>
 #include <os/texture.h>
+#include <nitpicker_gfx/pixel_span.h>
 
 
 struct Texture_painter
@@ -74,10 +75,8 @@ struct Texture_painter
 
 		PT const mix_pixel(mix_color.r, mix_color.g, mix_color.b);
 
-		int i, j;
-		PT            const *s;
-		PT                  *d;
-		unsigned char const *a;
+		unsigned const w = clipped.w();
+		int j;
 
 		switch (mode) {
 
@@ -98,28 +97,80 @@ struct Texture_painter
 			 * Copy texture with alpha blending
 			 */
 			for (j = clipped.h(); j--; src += src_w, alpha += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, a = alpha, d = dst; i--; s++, d++, a++)
-					if (*a)
-						*d = PT::mix(*d, *s, *a);
+				Pixel_span::mix_alpha(dst, src, alpha, w);
 			break;
 
 		case MIXED:
 	
 			for (j = clipped.h(); j--; src += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, d = dst; i--; s++, d++)
-					*d = PT::avr(mix_pixel, *s);
+				Pixel_span::avr(dst, src, w, mix_pixel);
 			break;
 
 		case MASKED:
 
 			for (j = clipped.h(); j--; src += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, d = dst; i--; s++, d++)
-					if (s->pixel) *d = *s;
+				Pixel_span::copy_masked(dst, src, w);
 			break;
 		}
 
 		surface.flush_pixels(clipped);
 	}
+
+	/**
+	 * Paint texture with a pixel type different from the surface's
+	 *
+	 * Each texture pixel is converted to the pixel type of the surface.
+	 */
+	template <typename PT, typename TPT>
+	static inline void paint(Genode::Surface<PT>        &surface,
+	                         Genode::Texture<TPT> const &texture,
+	                         Genode::Color               mix_color,
+	                         Point                       position,
+	                         Mode                        mode,
+	                         bool                        allow_alpha)
+	{
+		Rect clipped = Rect::intersect(Rect(position, texture.size()),
+		                               surface.clip());
+
+		if (!clipped.valid()) return;
+
+		int const src_w = texture.size().w();
+		int const dst_w = surface.size().w();
+
+		unsigned long tex_start_offset = (clipped.y1() - position.y())*src_w
+		                               +  clipped.x1() - position.x();
+
+		TPT           const *src   = texture.pixel() + tex_start_offset;
+		unsigned char const *alpha = texture.alpha() + tex_start_offset;
+		PT                  *dst   = surface.addr() + clipped.y1()*dst_w + clipped.x1();
+
+		PT const mix_pixel(mix_color.r, mix_color.g, mix_color.b);
+
+		bool const blend = texture.alpha() && allow_alpha;
+
+		for (int j = clipped.h(); j--; src += src_w, alpha += src_w, dst += dst_w) {
+
+			TPT           const *s = src;
+			unsigned char const *a = alpha;
+			PT                  *d = dst;
+
+			for (int i = clipped.w(); i--; s++, d++, a++) {
+
+				PT const p(s->r(), s->g(), s->b());
+
+				switch (mode) {
+				case SOLID:
+					if (!blend) *d = p;
+					else if (*a) *d = PT::mix(*d, p, *a);
+					break;
+				case MIXED:  *d = PT::avr(mix_pixel, p); break;
+				case MASKED: if (s->pixel) *d = p;       break;
+				}
+			}
+		}
+
+		surface.flush_pixels(clipped);
+	}
 };
 
 #endif /* _INCLUDE__NITPICKER_GFX__TEXTURE_PAINTER_H_ */
@@ -41,6 +41,9 @@ class Genode::Reporter
 
 		bool _enabled = false;
 
+		/* size of the most recently submitted report */
+		size_t _submitted = 0;
+
 		struct Connection
 		{
 			Report::Connection report;
@@ -62,6 +65,34 @@ class Genode::Reporter
 		 */
 		char *_base() { return _enabled ? _conn->ds.local_addr<char>() : 0; }
 
+		void _submit(size_t length)
+		{
+			_conn->report.submit(length);
+			_submitted = length;
+		}
+
+		/**
+		 * Submit report unless it equals the previously submitted one
+		 *
+		 * The report buffer still holds the previous report.
+		 *
+		 * \throw Xml_generator::Buffer_exceeded
+		 */
+		void _submit_if_changed(char const *data, size_t length)
+		{
+			if (!_enabled)
+				return;
+
+			if (length == _submitted && memcmp(_base(), data, length) == 0)
+				return;
+
+			if (length > _size())
+				throw Genode::Xml_generator::Buffer_exceeded();
+
+			memcpy(_base(), data, length);
+			_submit(length);
+		}
+
 	public:
 
 		Reporter(Env &, char const *xml_name, char const *label = nullptr,
@@ -96,7 +127,8 @@ class Genode::Reporter
 			else
 				_conn.destruct();
 
-			_enabled = enabled;
+			_enabled   = enabled;
+			_submitted = 0;
 		}
 
 		/**
@@ -117,7 +149,11 @@ class Genode::Reporter
 		/**
 		 * Clear report buffer
 		 */
-		void clear() { memset(_base(), 0, _size()); }
+		void clear()
+		{
+			memset(_base(), 0, _size());
+			_submitted = 0;
+		}
 
 		/**
 		 * Report data buffer
@@ -133,7 +169,7 @@ class Genode::Reporter
 				return;
 
 			memcpy(base, data, length);
-			_conn->report.submit(length);
+			_submit(length);
 		}
 
 		/**
@@ -141,6 +177,13 @@ class Genode::Reporter
 		 */
 		struct Xml_generator : public Genode::Xml_generator
 		{
+			/**
+			 * Constructor
+			 *
+			 * The report is generated directly into the report buffer.
+			 *
+			 * \throw Buffer_exceeded
+			 */
 			template <typename FUNC>
 			Xml_generator(Reporter &reporter, FUNC const &func)
 			:
@@ -150,7 +193,31 @@ class Genode::Reporter
 				                      func)
 			{
 				if (reporter.enabled())
-					reporter._conn->report.submit(used());
+					reporter._submit(used());
+			}
+
+			/**
+			 * Constructor for generating the report in a single pass
+			 *
+			 * \param store  backing store that grows on demand
+			 *
+			 * The report is generated into the backing store and copied to
+			 * the report buffer afterwards. If the report is identical to
+			 * the previous one, the submission is skipped.
+			 *
+			 * \throw Buffer_exceeded  report does not fit into report buffer
+			 * \throw Out_of_memory    backing store could not be enlarged
+			 */
+			template <typename FUNC>
+			Xml_generator(Reporter &reporter,
+			              Genode::Xml_generator::Backing_store &store,
+			              FUNC const &func)
+			:
+				Genode::Xml_generator(store, reporter._size(),
+				                      reporter._xml_name.string(),
+				                      func)
+			{
+				reporter._submit_if_changed(content(), used());
 			}
 		};
 };
@@ -165,6 +232,9 @@ class Genode::Reporter
  * buffer as done by this class. Furthermore, in contrast to the regular
  * 'Reporter', which needs to be 'enabled', the 'Expanding_reporter' is
  * implicitly enabled at construction time.
+ *
+ * If constructed with an allocator, each report is generated in a single
+ * pass and a report equal to the previous one is not submitted.
  */
 class Genode::Expanding_reporter
 {
@@ -180,6 +250,9 @@ class Genode::Expanding_reporter
 		Node_type const _type;
 		Label     const _label;
 
+		/* valid if reports are generated in a single pass */
+		Constructible<Xml_generator::Backing_store> _store { };
+
 		Constructible<Reporter> _reporter { };
 
 		size_t _buffer_size = 4096;
@@ -195,6 +268,19 @@ class Genode::Expanding_reporter
 		Expanding_reporter(Env &env, Node_type const &type, Label const &label)
 		: _env(env), _type(type), _label(label) { _construct(); }
 
+		/**
+		 * Constructor
+		 *
+		 * \param alloc  allocator used for generating the reports
+		 */
+		Expanding_reporter(Env &env, Node_type const &type, Label const &label,
+		                   Allocator &alloc)
+		: _env(env), _type(type), _label(label)
+		{
+			_store.construct(alloc);
+			_construct();
+		}
+
 		template <typename FN>
 		void generate(FN const &fn)
 		{
@@ -202,8 +288,13 @@ class Genode::Expanding_reporter
 
 				/* attempt to generate a report, may throw */
 				[&] () {
-					Reporter::Xml_generator
-						xml(*_reporter, [&] () { fn(xml); }); },
+					if (_store.constructed()) {
+						Reporter::Xml_generator
+							xml(*_reporter, *_store, [&] () { fn(xml); });
+					} else {
+						Reporter::Xml_generator
+							xml(*_reporter, [&] () { fn(xml); });
+					} },
 
 				/* respond to exception by successively increasing the buffer */
 				[&] () {
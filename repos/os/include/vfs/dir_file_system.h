@@ -339,21 +339,19 @@ class Vfs::Dir_file_system : public File_system
 			else
 				node.attribute("name").value(_name, sizeof(_name));
 
-			for (unsigned i = 0; i < node.num_sub_nodes(); i++) {
-
-				Xml_node sub_node = node.sub_node(i);
+			node.for_each_sub_node([&] (Xml_node const &sub_node) {
 
 				/* traverse into <dir> nodes */
 				if (sub_node.has_type("dir")) {
 					_append_file_system(new (alloc)
 						Dir_file_system(env, alloc, sub_node, io_handler, fs_factory));
-					continue;
+					return;
 				}
 
 				File_system *fs = fs_factory.create(env, alloc, sub_node, io_handler);
 				if (fs) {
 					_append_file_system(fs);
-					continue;
+					return;
 				}
 
 				Genode::error("failed to create <", sub_node.type(), "> VFS node");
@@ -366,7 +364,7 @@ class Vfs::Dir_file_system : public File_system
 						Genode::error("\t", attr.name(), "=\"", value, "\"");
 					}
 				} catch (Xml_node::Nonexistent_attribute) { }
-			}
+			});
 		}
 
 		Dir_file_system(Genode::Env         &env,
@@ -782,19 +780,28 @@ class Vfs::Dir_file_system : public File_system
 		{
 			using namespace Genode;
 
+			/*
+			 * Walk the sub nodes sequentially because the indexed access via
+			 * 'sub_node(i)' re-parses all preceding nodes.
+			 */
 			File_system *curr = _first_file_system;
-			for (unsigned i = 0; i < node.num_sub_nodes(); i++, curr = curr->next) {
-				Xml_node const &sub_node = node.sub_node(i);
+			bool mismatch = false;
+			node.for_each_sub_node([&] (Xml_node const &sub_node) {
+
+				if (mismatch || !curr)
+					return;
 
 				/* check if type of XML node matches current file-system type */
 				if (sub_node.has_type(curr->type()) == false) {
 					Genode::error("VFS config update failed (node type '",
 					               sub_node.type(), "' != fs type '", curr->type(),"')");
+					mismatch = true;
 					return;
 				}
 
-				curr->apply_config(node.sub_node(i));
-			}
+				curr->apply_config(sub_node);
+				curr = curr->next;
+			});
 		}
 
 
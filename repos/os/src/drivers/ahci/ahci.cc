@@ -40,8 +40,9 @@ struct Ahci
 		void usleep(unsigned us) { Timer::Connection::usleep(us); }
 	} _delayer { env };
 
-	Ahci_root     &root;
-	Platform::Hba &platform_hba = Platform::init(env, _delayer);
+	Ahci_root         &root;
+	Timer::Connection &timer;
+	Platform::Hba     &platform_hba = Platform::init(env, _delayer);
 	Hba            hba          { env, platform_hba, _delayer };
 
 	enum { MAX_PORTS = 32 };
@@ -56,10 +57,11 @@ struct Ahci
 
 	Ahci(Genode::Env &env, Genode::Allocator &alloc,
 	     Ahci_root &root, bool support_atapi,
-	     Genode::Signal_context_capability device_identified)
+	     Genode::Signal_context_capability device_identified,
+	     Timer::Connection &timer)
 	:
 		env(env), alloc(alloc),
-		root(root), irq(root.entrypoint(), *this, &Ahci::handle_irq),
+		root(root), timer(timer), irq(root.entrypoint(), *this, &Ahci::handle_irq),
 		enable_atapi(support_atapi),
 		device_identified(device_identified)
 	{
@@ -140,7 +142,8 @@ struct Ahci
 					try {
 						ports[index] = new (&alloc)
 							Ata_driver(alloc, ram, root, ready_count, rm, hba,
-							           platform_hba, index, device_identified);
+							           platform_hba, index, device_identified,
+							           timer);
 						enabled = true;
 					} catch (...) { }
 
@@ -223,9 +226,10 @@ static Ahci *sata_ahci(Ahci *ahci = 0)
 
 void Ahci_driver::init(Genode::Env &env, Genode::Allocator &alloc,
                        Ahci_root &root, bool support_atapi,
-                       Genode::Signal_context_capability device_identified)
+                       Genode::Signal_context_capability device_identified,
+                       Timer::Connection &timer)
 {
-	static Ahci ahci(env, alloc, root, support_atapi, device_identified);
+	static Ahci ahci(env, alloc, root, support_atapi, device_identified, timer);
 	sata_ahci(&ahci);
 }
 
@@ -276,3 +280,24 @@ void Ahci_driver::report_ports(Genode::Reporter &reporter)
 		}
 	});
 }
+
+
+void Ahci_driver::report_statistics(Genode::Reporter &reporter)
+{
+	Genode::Reporter::Xml_generator xml(reporter, [&] () {
+		for (unsigned i = 0; i < Ahci::MAX_PORTS; ++i) {
+			Port_driver *port = sata_ahci()->port(i);
+			if (!port || !port->ready()) continue;
+
+			Ata_driver *ata = dynamic_cast<Ata_driver *>(port);
+			if (!ata) continue;
+
+			xml.node("port", [&] () {
+				xml.attribute("num", i);
+				xml.attribute("queued", ata->scheduler.count());
+				xml.attribute("in_flight", ata->slots_in_flight());
+				ata->stats.generate(xml);
+			});
+		}
+	});
+}
@@ -17,6 +17,7 @@
 #include <block/component.h>
 #include <os/attached_mmio.h>
 #include <os/reporter.h>
+#include <timer_session/connection.h>
 #include <util/retry.h>
 #include <util/reconstructible.h>
 
@@ -38,7 +39,8 @@ struct Ahci_root : Genode::Interface
 namespace Ahci_driver {
 
 	void init(Genode::Env &env, Genode::Allocator &alloc, Ahci_root &ep,
-	          bool support_atapi, Genode::Signal_context_capability device_identified);
+	          bool support_atapi, Genode::Signal_context_capability device_identified,
+	          Timer::Connection &timer);
 
 	bool avail(long device_num);
 	long device_number(char const *model_num, char const *serial_num);
@@ -46,6 +48,7 @@ namespace Ahci_driver {
 	Block::Driver *claim_port(long device_num);
 	void           free_port(long device_num);
 	void           report_ports(Genode::Reporter &reporter);
+	void           report_statistics(Genode::Reporter &reporter);
 
 	struct Missing_controller { };
 }
@@ -249,6 +252,27 @@ struct Command_fis : Genode::Mmio
 		/* packet command */
 		write<Command>(0xa0);
 	}
+
+	void flush_cache_ext()
+	{
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0xea);
+	}
+
+	/**
+	 * Data-set management command with the TRIM bit set
+	 *
+	 * \param range_blocks  number of 512-byte blocks of LBA range entries
+	 */
+	void trim(Genode::size_t range_blocks)
+	{
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0x06);
+		write<Features>(1);
+		write<Sector>(range_blocks);
+	}
 };
 
 
@@ -15,7 +15,9 @@
 #define _ATA_DRIVER_H_
 
 #include <base/log.h>
+#include <timer_session/connection.h>
 #include "ahci.h"
+#include "io_scheduler.h"
 
 using namespace Genode;
 
@@ -42,6 +44,11 @@ struct Identity : Genode::Mmio
 
 	struct Sector_count : Register<0xc8, 64> { };
 
+	struct Data_set_mgmt : Register<0x152, 16>
+	{
+		struct Trim : Bitfield<0, 1> { };
+	};
+
 	struct Logical_block  : Register<0xd4, 16>
 	{
 		struct Per_physical : Bitfield<0,  3> { }; /* 2^X logical per physical */
@@ -61,7 +68,8 @@ struct Identity : Genode::Mmio
 		using Genode::log;
 
 		log("  queue depth: ", read<Queue_depth::Max_depth>() + 1, " "
-		    "ncq: ", read<Sata_caps::Ncq_support>());
+		    "ncq: ", read<Sata_caps::Ncq_support>(), " "
+		    "trim: ", read<Data_set_mgmt::Trim>());
 		log("  numer of sectors: ", read<Sector_count>());
 		log("  multiple logical blocks per physical: ",
 		    read<Logical_block::Multiple>() ? "yes" : "no");
@@ -186,8 +194,46 @@ struct Ata_driver : Port_driver
 	Genode::Constructible<Serial_string> serial { };
 	Genode::Constructible<Model_string>  model  { };
 
-	Io_command               *io_cmd = nullptr;
-	Block::Packet_descriptor  pending[32];
+	Io_command *io_cmd = nullptr;
+
+	/* maximum number of requests merged into one command */
+	enum { MAX_MERGE = 16 };
+
+	/**
+	 * Requests processed by the command of a slot, sorted by block number
+	 */
+	struct Slot
+	{
+		Io_request requests[MAX_MERGE];
+		unsigned   count = 0;
+
+		Block::sector_t first() const { return requests[0].block_number; }
+		Block::sector_t end()   const { return requests[count - 1].end(); }
+	};
+
+	Slot slots[32];
+
+	/* bitmask of command slots in use, 'SYNC' and 'TRIM' packets are empty */
+	unsigned used_slots = 0;
+
+	Io_scheduler       scheduler { };
+	Io_statistics      stats     { };
+	Timer::Connection &timer;
+
+	/* DMA buffer holding the LBA range entries of a TRIM command */
+	Genode::Ram_dataspace_capability trim_ds   { };
+	addr_t                           trim_buf  = 0;
+	addr_t                           trim_phys = 0;
+
+	/*
+	 * One 512-byte block holds 64 LBA range entries, each covering up to
+	 * 65535 blocks. A larger TRIM is split into several commands.
+	 */
+	enum { TRIM_ENTRIES = 64, TRIM_ENTRY_BLOCKS = 0xffff };
+
+	/* part of the range of the TRIM packet in flight not issued yet */
+	Block::sector_t trim_next      = 0;
+	size_t          trim_remaining = 0;
 
 	Signal_context_capability device_identified;
 
@@ -199,11 +245,17 @@ struct Ata_driver : Port_driver
 	           Hba                 &hba,
 	           Platform::Hba       &platform_hba,
 	           unsigned             number,
-	           Genode::Signal_context_capability device_identified)
+	           Genode::Signal_context_capability device_identified,
+	           Timer::Connection   &timer)
 	: Port_driver(ram, root, sem, rm, hba, platform_hba, number),
-	  alloc(alloc), device_identified(device_identified)
+	  alloc(alloc), timer(timer), device_identified(device_identified)
 	{
 		Port::init();
+
+		trim_ds   = platform_hba.alloc_dma_buffer(0x1000);
+		trim_buf  = rm.attach(trim_ds);
+		trim_phys = Dataspace_client(trim_ds).phys_addr();
+
 		identify_device();
 	}
 
@@ -211,55 +263,165 @@ struct Ata_driver : Port_driver
 	{
 		if (io_cmd)
 			destroy(&alloc, io_cmd);
+
+		rm.detach((void *)trim_buf);
+		platform_hba.free_dma_buffer(trim_ds);
+	}
+
+	bool slot_used(unsigned slot) const { return used_slots & (1U << slot); }
+
+	unsigned slots_in_flight() const
+	{
+		unsigned n = 0;
+		for (unsigned bits = used_slots; bits; bits &= bits - 1)
+			n++;
+		return n;
 	}
 
 	unsigned find_free_cmd_slot()
 	{
 		for (unsigned slot = 0; slot < cmd_slots; slot++)
-			if (!pending[slot].size())
+			if (!slot_used(slot))
 				return slot;
 
 		throw Block::Driver::Request_congestion();
 	}
 
+	Genode::uint64_t now_us() {
+		return timer.curr_time().trunc_to_plain_us().value; }
+
 	void ack_packets()
 	{
-		unsigned slots =  Port::read<Ci>() | Port::read<Sact>();
+		/*
+		 * Determine finished slots up front, acknowledging a packet may
+		 * issue new commands
+		 */
+		unsigned const done = used_slots & ~(Port::read<Ci>() | Port::read<Sact>());
+		Genode::uint64_t const now = done ? now_us() : 0;
 
 		for (unsigned slot = 0; slot < cmd_slots; slot++) {
-			if ((slots & (1U << slot)) || !pending[slot].size())
+			if (!(done & (1U << slot)))
 				continue;
 
-			Block::Packet_descriptor p = pending[slot];
-			pending[slot] = Block::Packet_descriptor();
-			ack_packet(p, true);
+			Slot &s = slots[slot];
+
+			/* continue with the remainder of a TRIM */
+			if (trim_remaining && s.requests[0].packet.operation()
+			                   == Block::Packet_descriptor::TRIM) {
+				Block::Packet_descriptor packet = s.requests[0].packet;
+				s.count = 0;
+				used_slots &= ~(1U << slot);
+				issue_trim(packet);
+				continue;
+			}
+
+			for (unsigned i = 0; i < s.count; i++) {
+				if (s.requests[i].count)
+					stats.completed(s.requests[i], now);
+				ack_packet(s.requests[i].packet, true);
+			}
+
+			s.count = 0;
+			used_slots &= ~(1U << slot);
 		}
+
+		dispatch();
 	}
 
-	void overlap_check(Block::sector_t block_number,
-	                   size_t          count)
+	/**
+	 * Return true if the block range overlaps a command in flight
+	 */
+	bool busy(Block::sector_t block_number, size_t count) const
 	{
-		Block::sector_t end = block_number + count - 1;
-
 		for (unsigned slot = 0; slot < cmd_slots; slot++) {
-			if (!pending[slot].size())
+			if (!slot_used(slot) || !slots[slot].count)
 				continue;
 
-			Block::sector_t pending_start = pending[slot].block_number();
-			Block::sector_t pending_end   = pending_start + pending[slot].block_count() - 1;
-			/* check if a pending packet overlaps */
-			if ((block_number >= pending_start && block_number <= pending_end) ||
-			    (end          >= pending_start && end          <= pending_end) ||
-			    (pending_start >= block_number && pending_start <= end) ||
-			    (pending_end   >= block_number && pending_end   <= end)) {
-
-				Genode::warning("overlap: "
-				                "pending ", pending[slot].block_number(),
-				                " + ", pending[slot].block_count(), ", "
-				                "request: ", block_number, " + ", count);
-				throw Block::Driver::Request_congestion();
-			}
+			Slot const &s = slots[slot];
+			if (s.first() < block_number + count && block_number < s.end())
+				return true;
 		}
+		return false;
+	}
+
+	void issue(unsigned slot)
+	{
+		Slot             &s     = slots[slot];
+		Io_request const &first = s.requests[0];
+		size_t     const  count = s.end() - s.first();
+
+		used_slots |= 1U << slot;
+
+		/* setup fis, the buffers of merged requests are contiguous */
+		Command_table table(command_table_addr(slot), first.phys,
+		                    count * block_size());
+
+		/* set ATA command */
+		io_cmd->command(*this, table, first.read, first.block_number, count, slot);
+
+		/* set or clear write flag in command header */
+		Command_header header(command_header_addr(slot));
+		header.write<Command_header::Bits::W>(first.read ? 0 : 1);
+		header.clear_byte_count();
+
+		stats.issued(s.requests, s.count, slots_in_flight());
+
+		execute(slot);
+	}
+
+	/**
+	 * Keep command slots busy with queued requests
+	 */
+	void dispatch()
+	{
+		if (scheduler.empty())
+			return;
+
+		/* a command covers at most 0xffff blocks and one 4 MiB PRD */
+		size_t const bs         = block_size();
+		size_t const max_blocks = min((size_t)0xffff, (size_t)(4*1024*1024) / bs);
+
+		Genode::uint64_t const now = now_us();
+
+		while (!scheduler.empty()) {
+
+			unsigned slot = 0;
+			for (; slot < cmd_slots && slot_used(slot); slot++);
+			if (slot == cmd_slots)
+				return;
+
+			Slot &s = slots[slot];
+			s.count = scheduler.next(s.requests, MAX_MERGE, max_blocks, bs, now,
+			                         [&] (Block::sector_t nr, size_t cnt) {
+			                             return busy(nr, cnt); });
+			if (!s.count)
+				return;
+
+			issue(slot);
+		}
+	}
+
+	void enqueue(bool                            read,
+	             Block::sector_t                 block_number,
+	             size_t                          count,
+	             addr_t                          phys,
+	             Block::Packet_descriptor const &packet)
+	{
+		sanity_check(block_number, count);
+
+		if (scheduler.full())
+			throw Block::Driver::Request_congestion();
+
+		Io_request request;
+		request.packet       = packet;
+		request.read         = read;
+		request.block_number = block_number;
+		request.count        = count;
+		request.phys         = phys;
+		request.queued_us    = now_us();
+
+		scheduler.enqueue(request);
+		stats.submitted(scheduler.count());
 	}
 
 	void io(bool                      read,
@@ -268,27 +430,90 @@ struct Ata_driver : Port_driver
 	        addr_t                    phys,
 	        Block::Packet_descriptor &packet)
 	{
-		sanity_check(block_number, count);
-		overlap_check(block_number, count);
+		enqueue(read, block_number, count, phys, packet);
+		dispatch();
+	}
 
-		unsigned slot = find_free_cmd_slot();
-		pending[slot] = packet;
+	/**
+	 * Queue all requests of the batch before dispatching, which lets the
+	 * scheduler merge requests of the batch into one command
+	 */
+	Submit_status submit(Request const *requests, unsigned count,
+	                     unsigned &accepted) override
+	{
+		/* 'SYNC' and 'TRIM' are submitted alone */
+		if (count && requests[0].packet.barrier())
+			return Block::Driver::submit(requests, count, accepted);
+
+		Submit_status status = Submit_status::ACCEPTED;
+
+		for (accepted = 0; accepted < count; accepted++) {
+			Block::Packet_descriptor const &p = requests[accepted].packet;
+			try {
+				enqueue(p.operation() == Block::Packet_descriptor::READ,
+				        p.block_number(), p.block_count(),
+				        requests[accepted].phys, p);
+			}
+			catch (Block::Driver::Request_congestion) { status = Submit_status::CONGESTED; break; }
+			catch (Block::Driver::Io_error)           { status = Submit_status::REJECTED;  break; }
+		}
 
-		/* setup fis */
-		Command_table table(command_table_addr(slot), phys, count * block_size());
+		dispatch();
+		return status;
+	}
 
-		/* set ATA command */
-		io_cmd->command(*this, table, read, block_number, count, slot);
+	/**
+	 * Issue command that is not queued via NCQ
+	 *
+	 * The block-session component passes 'SYNC' and 'TRIM' requests only
+	 * if no other request is pending. Hence, the command does not
+	 * interfere with queued commands.
+	 */
+	template <typename FN>
+	void non_queued_command(Block::Packet_descriptor &packet,
+	                        size_t bytes, bool write, FN const &fn)
+	{
+		unsigned slot = find_free_cmd_slot();
+		slots[slot].requests[0]        = Io_request();
+		slots[slot].requests[0].packet = packet;
+		slots[slot].count              = 1;
+		used_slots |= 1U << slot;
+
+		Command_table table(command_table_addr(slot), trim_phys, bytes);
+		fn(table.fis);
 
-		/* set or clear write flag in command header */
 		Command_header header(command_header_addr(slot));
-		header.write<Command_header::Bits::W>(read ? 0 : 1);
+		header.write<Command_header::Bits::W>(write ? 1 : 0);
 		header.clear_byte_count();
 
 		execute(slot);
 	}
 
 
+	/**
+	 * Issue DATA SET MANAGEMENT command for the next part of a TRIM
+	 *
+	 * The packet is acknowledged after the command covering the end of
+	 * the range completed.
+	 */
+	void issue_trim(Block::Packet_descriptor &packet)
+	{
+		Genode::uint64_t * const entries = (Genode::uint64_t *)trim_buf;
+		memset(entries, 0, TRIM_ENTRIES*sizeof(Genode::uint64_t));
+
+		for (unsigned i = 0; i < TRIM_ENTRIES && trim_remaining; i++) {
+			size_t const n = min(trim_remaining, (size_t)TRIM_ENTRY_BLOCKS);
+			entries[i] = (Genode::uint64_t)trim_next
+			           | ((Genode::uint64_t)n << 48);
+			trim_next      += n;
+			trim_remaining -= n;
+		}
+
+		non_queued_command(packet, TRIM_ENTRIES*sizeof(Genode::uint64_t), true,
+		                   [&] (Command_fis &fis) { fis.trim(1); });
+	}
+
+
 	/*****************
 	 ** Port_driver **
 	 *****************/
@@ -328,6 +553,10 @@ struct Ata_driver : Port_driver
 
 		case READY:
 
+			/* completion of a non-queued command */
+			if (Port::Is::Dhrs::get(status))
+				ack_irq();
+
 			io_cmd->handle_irq(*this, status);
 			ack_packets();
 
@@ -338,6 +567,11 @@ struct Ata_driver : Port_driver
 		stop();
 	}
 
+	bool trim_support()
+	{
+		return info->read<Identity::Data_set_mgmt::Trim>();
+	}
+
 	bool ncq_support()
 	{
 		return info->read<Identity::Sata_caps::Ncq_support>() && hba.ncq();
@@ -378,9 +612,30 @@ struct Ata_driver : Port_driver
 		Block::Session::Operations o;
 		o.set_operation(Block::Packet_descriptor::READ);
 		o.set_operation(Block::Packet_descriptor::WRITE);
+		if (trim_support())
+			o.set_operation(Block::Packet_descriptor::TRIM);
 		return o;
 	}
 
+	void sync(Block::sector_t, size_t, Block::Packet_descriptor &packet) override
+	{
+		non_queued_command(packet, 0, false, [&] (Command_fis &fis) {
+			fis.flush_cache_ext(); });
+	}
+
+	void trim(Block::sector_t           block_number,
+	          size_t                    block_count,
+	          Block::Packet_descriptor &packet) override
+	{
+		if (!trim_support() || block_number + block_count > this->block_count())
+			throw Io_error();
+
+		trim_next      = block_number;
+		trim_remaining = block_count;
+
+		issue_trim(packet);
+	}
+
 	void read_dma(Block::sector_t           block_number,
 	              size_t                    block_count,
 	              addr_t                    phys,
@@ -0,0 +1,259 @@
+/*
+ * \brief  Ordering, merging, and accounting of block requests
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _AHCI__IO_SCHEDULER_H_
+#define _AHCI__IO_SCHEDULER_H_
+
+#include <block_session/block_session.h>
+#include <util/misc_math.h>
+#include <util/xml_generator.h>
+
+
+/**
+ * Block request waiting for or being processed by the device
+ */
+struct Io_request
+{
+	Block::Packet_descriptor packet       { };
+	bool                     read         = true;
+	Block::sector_t          block_number = 0;
+	Genode::size_t           count        = 0;
+	Genode::addr_t           phys         = 0;
+	Genode::uint64_t         queued_us    = 0; /* time of submission */
+
+	Block::sector_t end() const { return block_number + count; }
+
+	bool overlaps(Block::sector_t nr, Genode::size_t cnt) const {
+		return block_number < nr + cnt && nr < end(); }
+};
+
+
+/**
+ * Elevator for block requests
+ *
+ * Requests are dispatched in ascending block order, wrapping around at the
+ * highest pending block number (C-LOOK). A request waiting longer than
+ * 'MAX_WAIT_US' is dispatched first, which bounds the latency of requests
+ * far from the current position. Adjacent requests of the same direction
+ * with physically contiguous buffers are merged into one command. A request
+ * overlapping an earlier one is held back until the earlier one completed,
+ * which preserves the order of conflicting accesses.
+ */
+class Io_scheduler
+{
+	public:
+
+		enum { QUEUE_SIZE = Block::Session::TX_QUEUE_SIZE,
+		       MAX_WAIT_US = 100*1000 };
+
+	private:
+
+		/* pending requests in the order of their submission */
+		Io_request      _queue[QUEUE_SIZE];
+		unsigned        _count = 0;
+		Block::sector_t _head  = 0;   /* block following the last dispatch */
+
+		void _remove(unsigned i)
+		{
+			for (_count--; i < _count; i++)
+				_queue[i] = _queue[i + 1];
+		}
+
+		/**
+		 * Return true if request 'i' may be passed to the device
+		 */
+		template <typename BUSY>
+		bool _eligible(unsigned i, BUSY const &busy) const
+		{
+			Io_request const &r = _queue[i];
+			if (busy(r.block_number, r.count))
+				return false;
+
+			for (unsigned j = 0; j < i; j++)
+				if (_queue[j].overlaps(r.block_number, r.count))
+					return false;
+
+			return true;
+		}
+
+		template <typename BUSY>
+		bool _select(unsigned &out, Genode::uint64_t now_us, BUSY const &busy) const
+		{
+			/* the oldest request is due */
+			if (now_us - _queue[0].queued_us > MAX_WAIT_US && _eligible(0, busy)) {
+				out = 0;
+				return true;
+			}
+
+			bool ahead = false, found = false;
+			for (unsigned i = 0; i < _count; i++) {
+
+				Block::sector_t const nr = _queue[i].block_number;
+				bool const is_ahead = nr >= _head;
+
+				/* requests ahead of the head take precedence */
+				if (found && ahead && !is_ahead)
+					continue;
+				if (found && ahead == is_ahead && nr >= _queue[out].block_number)
+					continue;
+				if (!_eligible(i, busy))
+					continue;
+
+				out   = i;
+				ahead = is_ahead;
+				found = true;
+			}
+			return found;
+		}
+
+	public:
+
+		bool     empty() const { return _count == 0; }
+		bool     full()  const { return _count == QUEUE_SIZE; }
+		unsigned count() const { return _count; }
+
+		void enqueue(Io_request const &request) { _queue[_count++] = request; }
+
+		/**
+		 * Remove next command's worth of requests from the queue
+		 *
+		 * \param batch       destination for the requests of the command,
+		 *                    sorted by block number
+		 * \param max_batch   maximum number of requests to merge
+		 * \param max_blocks  maximum number of blocks per command
+		 * \param block_size  block size of the device
+		 * \param now_us      current time
+		 * \param busy        functor called with a block range, returns true
+		 *                    if the range conflicts with a request in flight
+		 *
+		 * \return number of requests stored in 'batch'
+		 */
+		template <typename BUSY>
+		unsigned next(Io_request *batch, unsigned max_batch,
+		              Genode::size_t max_blocks, Genode::size_t block_size,
+		              Genode::uint64_t now_us, BUSY const &busy)
+		{
+			unsigned i = 0;
+			if (empty() || !_select(i, now_us, busy))
+				return 0;
+
+			batch[0] = _queue[i];
+			_remove(i);
+
+			unsigned       n      = 1;
+			Genode::size_t blocks = batch[0].count;
+
+			for (bool merged = true; merged && n < max_batch; ) {
+
+				Io_request const &last = batch[n - 1];
+				Genode::addr_t const phys_end = last.phys + last.count*block_size;
+
+				merged = false;
+				for (unsigned j = 0; j < _count; j++) {
+					Io_request const &r = _queue[j];
+					if (r.read != last.read || r.block_number != last.end()
+					 || r.phys != phys_end || blocks + r.count > max_blocks
+					 || !_eligible(j, busy))
+						continue;
+
+					batch[n++] = r;
+					blocks    += r.count;
+					_remove(j);
+					merged = true;
+					break;
+				}
+			}
+
+			_head = batch[n - 1].end();
+			return n;
+		}
+};
+
+
+/**
+ * I/O statistics of a device
+ */
+struct Io_statistics
+{
+	enum {
+		MAX_DEPTH        = 32,
+		LATENCY_BUCKETS  = 16,
+		MIN_LATENCY_LOG2 = 4,  /* upper bound of first bucket is 16 us */
+	};
+
+	Genode::uint64_t requests     = 0;
+	Genode::uint64_t commands     = 0;
+	Genode::uint64_t merged       = 0; /* requests merged into others */
+	Genode::uint64_t read_blocks  = 0;
+	Genode::uint64_t write_blocks = 0;
+	unsigned         max_queued   = 0;
+
+	/* issued commands by number of commands in flight, including itself */
+	Genode::uint64_t depth[MAX_DEPTH + 1] { };
+
+	/* completed requests by latency from submission to acknowledgement */
+	Genode::uint64_t latency[LATENCY_BUCKETS] { };
+
+	void submitted(unsigned queued)
+	{
+		requests++;
+		max_queued = Genode::max(max_queued, queued);
+	}
+
+	void issued(Io_request const *batch, unsigned n, unsigned in_flight)
+	{
+		commands++;
+		merged += n - 1;
+		depth[Genode::min(in_flight, (unsigned)MAX_DEPTH)]++;
+
+		for (unsigned i = 0; i < n; i++)
+			(batch[i].read ? read_blocks : write_blocks) += batch[i].count;
+	}
+
+	void completed(Io_request const &request, Genode::uint64_t now_us)
+	{
+		Genode::uint64_t const us = now_us - request.queued_us;
+
+		unsigned bucket = 0;
+		while (bucket < LATENCY_BUCKETS - 1
+		    && us >= (1ULL << (MIN_LATENCY_LOG2 + bucket)))
+			bucket++;
+
+		latency[bucket]++;
+	}
+
+	void generate(Genode::Xml_generator &xml) const
+	{
+		xml.attribute("requests",     requests);
+		xml.attribute("commands",     commands);
+		xml.attribute("merged",       merged);
+		xml.attribute("read_blocks",  read_blocks);
+		xml.attribute("write_blocks", write_blocks);
+		xml.attribute("max_queued",   max_queued);
+
+		for (unsigned i = 1; i <= MAX_DEPTH; i++)
+			if (depth[i])
+				xml.node("depth", [&] () {
+					xml.attribute("in_flight", i);
+					xml.attribute("commands",  depth[i]); });
+
+		for (unsigned i = 0; i < LATENCY_BUCKETS; i++)
+			if (latency[i])
+				xml.node("latency", [&] () {
+					if (i < LATENCY_BUCKETS - 1)
+						xml.attribute("below_us", 1ULL << (MIN_LATENCY_LOG2 + i));
+					xml.attribute("requests", latency[i]); });
+	}
+};
+
+#endif /* _AHCI__IO_SCHEDULER_H_ */
@@ -175,13 +175,23 @@ struct Block::Main
 	Signal_handler<Main> device_identified {
 		env.ep(), *this, &Main::handle_device_identified };
 
+	/* time source of the request scheduler and the statistics report */
+	Timer::Connection timer { env };
+
+	Genode::Constructible<Genode::Reporter>              stats_reporter { };
+	Genode::Constructible<Timer::Periodic_timeout<Main>> stats_timeout  { };
+
+	void handle_stats_timeout(Genode::Duration) {
+		Ahci_driver::report_statistics(*stats_reporter); }
+
 	Main(Genode::Env &env)
 	: env(env), root(env, heap, config.xml())
 	{
 		Genode::log("--- Starting AHCI driver ---");
 		bool support_atapi  = config.xml().attribute_value("atapi", false);
 		try {
-			Ahci_driver::init(env, heap, root, support_atapi, device_identified);
+			Ahci_driver::init(env, heap, root, support_atapi, device_identified,
+			                  timer);
 		} catch (Ahci_driver::Missing_controller) {
 			Genode::error("no AHCI controller found");
 			env.parent().exit(~0);
@@ -189,6 +199,18 @@ struct Block::Main
 			Genode::error("hardware access denied");
 			env.parent().exit(~0);
 		}
+
+		try {
+			Xml_node report = config.xml().sub_node("report");
+			if (report.attribute_value("statistics", false)) {
+				unsigned long const ms =
+					report.attribute_value("statistics_interval_ms", 1000UL);
+				stats_reporter.construct(env, "statistics");
+				stats_reporter->enabled(true);
+				stats_timeout.construct(timer, *this, &Main::handle_stats_timeout,
+				                        Genode::Microseconds(ms*1000));
+			}
+		} catch (Genode::Xml_node::Nonexistent_sub_node) { }
 	}
 
 	void handle_device_identified()
@@ -224,6 +224,12 @@ struct Audio_out::Root_policy
 			throw Genode::Service_denied();
 		if (Audio_out::channel_acquired[channel_number])
 			throw Genode::Service_denied();
+		unsigned const sample_rate =
+			Arg_string::find_arg(args, "sample_rate").ulong_value(SAMPLE_RATE);
+		if (sample_rate != SAMPLE_RATE) {
+			Genode::error("unsupported sample rate ", sample_rate, " requested");
+			throw Genode::Service_denied();
+		}
 	}
 
 	void release() { }
@@ -15,7 +15,9 @@
 /* Genode includes */
 #include <base/attached_rom_dataspace.h>
 #include <base/component.h>
+#include <base/attached_ram_dataspace.h>
 #include <framebuffer_session/framebuffer_session.h>
+#include <framebuffer_session/damage_ring.h>
 #include <input/root.h>
 #include <timer_session/connection.h>
 
@@ -55,6 +57,68 @@ class Framebuffer::Session_component : public Rpc_object<Session>
 
 		Timer::Connection _timer;
 
+		Attached_ram_dataspace _damage_ds;
+		Damage_ring           &_damage_ring = *_damage_ds.local_addr<Damage_ring>();
+		unsigned               _damage_overflows = 0;
+
+		Signal_handler<Session_component> _damage_handler;
+
+		/**
+		 * Copy pixels of region from shared dataspace to sdl surface
+		 *
+		 * \param rect  clipped region, only valid if true is returned
+		 */
+		bool _copy(int x, int y, int w, int h, SDL_Rect &rect)
+		{
+			/* clip refresh area to screen boundaries */
+			int x1 = max(x, 0);
+			int y1 = max(y, 0);
+			int x2 = min(x + w - 1, _mode.width()  - 1);
+			int y2 = min(y + h - 1, _mode.height() - 1);
+
+			if (x1 > x2 || y1 > y2)
+				return false;
+
+			const int start_offset = _mode.bytes_per_pixel()*(y1*_mode.width() + x1);
+			const int line_len     = _mode.bytes_per_pixel()*(x2 - x1 + 1);
+			const int pitch        = _mode.bytes_per_pixel()*_mode.width();
+
+			char *src = (char *)_fb_ds_addr     + start_offset;
+			char *dst = (char *)_screen->pixels + start_offset;
+
+			for (int i = y1; i <= y2; i++, src += pitch, dst += pitch)
+				Genode::memcpy(dst, src, line_len);
+
+			rect.x = x1;
+			rect.y = y1;
+			rect.w = x2 - x1 + 1;
+			rect.h = y2 - y1 + 1;
+			return true;
+		}
+
+		/**
+		 * Flush regions reported via the damage ring at once
+		 */
+		void _handle_damage()
+		{
+			SDL_Rect rects[Damage_ring::CAPACITY];
+			int      n = 0;
+
+			bool const overflowed =
+				_damage_ring.consume(_damage_overflows,
+				                     [&] (Damage_ring::Rect const &r) {
+					if (n < Damage_ring::CAPACITY && _copy(r.x, r.y, r.w, r.h, rects[n]))
+						n++; });
+
+			if (overflowed) {
+				_copy(0, 0, _mode.width(), _mode.height(), rects[0]);
+				n = 1;
+			}
+
+			if (n)
+				SDL_UpdateRects(_screen, n, rects);
+		}
+
 	public:
 
 		/**
@@ -63,7 +127,9 @@ class Framebuffer::Session_component : public Rpc_object<Session>
 		Session_component(Env &env, Framebuffer::Mode mode,
 		                  Dataspace_capability fb_ds_cap, void *fb_ds_addr)
 		:
-			_mode(mode), _fb_ds_cap(fb_ds_cap), _fb_ds_addr(fb_ds_addr), _timer(env)
+			_mode(mode), _fb_ds_cap(fb_ds_cap), _fb_ds_addr(fb_ds_addr), _timer(env),
+			_damage_ds(env.ram(), env.rm(), sizeof(Damage_ring)),
+			_damage_handler(env.ep(), *this, &Session_component::_handle_damage)
 		{ }
 
 		void screen(SDL_Surface *screen) { _screen = screen; }
@@ -83,29 +149,16 @@ class Framebuffer::Session_component : public Rpc_object<Session>
 
 		void refresh(int x, int y, int w, int h) override
 		{
-			/* clip refresh area to screen boundaries */
-			int x1 = max(x, 0);
-			int y1 = max(y, 0);
-			int x2 = min(x + w - 1, _mode.width()  - 1);
-			int y2 = min(y + h - 1, _mode.height() - 1);
-
-			if (x1 <= x2 && y1 <= y2) {
-
-				/* copy pixels from shared dataspace to sdl surface */
-				const int start_offset = _mode.bytes_per_pixel()*(y1*_mode.width() + x1);
-				const int line_len     = _mode.bytes_per_pixel()*(x2 - x1 + 1);
-				const int pitch        = _mode.bytes_per_pixel()*_mode.width();
-
-				char *src = (char *)_fb_ds_addr     + start_offset;
-				char *dst = (char *)_screen->pixels + start_offset;
+			SDL_Rect rect;
+			if (_copy(x, y, w, h, rect))
+				SDL_UpdateRects(_screen, 1, &rect);
+		}
 
-				for (int i = y1; i <= y2; i++, src += pitch, dst += pitch)
-					Genode::memcpy(dst, src, line_len);
+		Dataspace_capability damage_dataspace() override {
+			return _damage_ds.cap(); }
 
-				/* flush pixels in sdl window */
-				SDL_UpdateRect(_screen, x1, y1, x2 - x1 + 1, y2 - y1 + 1);
-			}
-		}
+		Signal_context_capability damage_sigh() override {
+			return _damage_handler; }
 };
 
 
@@ -154,7 +207,12 @@ struct Fb_sdl::Main
 	int const _fb_width  = _config.xml().attribute_value("width", 1024UL);
 	int const _fb_height = _config.xml().attribute_value("height", 768UL);
 
-	Framebuffer::Mode _fb_mode { _fb_width, _fb_height, Framebuffer::Mode::RGB565 };
+	/* 32 bits per pixel select RGB888, any other depth RGB565 */
+	unsigned const _fb_depth = _config.xml().attribute_value("depth", 16U);
+
+	Framebuffer::Mode _fb_mode { _fb_width, _fb_height,
+	                             _fb_depth == 32 ? Framebuffer::Mode::RGB888
+	                                             : Framebuffer::Mode::RGB565 };
 
 	Attached_ram_dataspace _fb_ds { _env.ram(), _env.rm(),
 	                                _fb_mode.width()*_fb_mode.height()*_fb_mode.bytes_per_pixel() };
@@ -9,11 +9,24 @@
  *
  * - TAP device to connect to (default is tap0)
  * - MAC address (default is 02-00-00-00-00-01)
+ * - Number of TAP queues (default is 1)
  *
  * These can be set in the config section as follows:
  *  <config>
- *  	<nic mac="12:23:34:45:56:67" tap="tap1"/>
+ *  	<nic mac="12:23:34:45:56:67" tap="tap1" queues="4"/>
  *  </config>
+ *
+ * With more than one queue, the TAP device is opened with 'IFF_MULTI_QUEUE'.
+ * The host kernel distributes the received flows among the queues, which
+ * are all drained for the single NIC session served by the driver. The
+ * queues are not handed out to different sessions because all queues of a
+ * TAP device share one link, so each session would receive the traffic of
+ * the others.
+ *
+ * The driver supports sessions with offloading. The 'Offload_header' of
+ * such sessions corresponds to the virtio-net header of the TAP device
+ * ('IFF_VNET_HDR'). Hence, checksum calculation and segmentation are
+ * performed by the host kernel.
  */
 
 /*
@@ -37,12 +50,16 @@
 #include <base/thread.h>
 #include <base/log.h>
 #include <nic/root.h>
+#include <nic/offload.h>
 
 /* Linux */
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <net/if.h>
 #include <linux/if_tun.h>
 
@@ -57,38 +74,153 @@ class Linux_session_component : public Nic::Session_component
 {
 	private:
 
+		enum { MAX_QUEUES = 8 };
+
+		/*
+		 * Thread that signals the arrival of packets
+		 *
+		 * The fds of all queues are registered at an epoll instance in
+		 * one-shot mode. After submitting a signal, the thread does not wake
+		 * up again before the entrypoint drained the fds and re-armed the
+		 * registrations. This way, a batch of received packets costs a
+		 * single signal. The thread exits when woken up via 'stop'.
+		 */
 		struct Rx_signal_thread : Genode::Thread
 		{
-			int                               fd;
+			/*
+			 * Noncopyable
+			 */
+			Rx_signal_thread(Rx_signal_thread const &);
+			Rx_signal_thread &operator = (Rx_signal_thread const &);
+
+			int const       *fds;
+			unsigned  const  num_fds;
+			int       const  epoll_fd;
+			int       const  stop_fd;
+
 			Genode::Signal_context_capability sigh;
 
-			Rx_signal_thread(Genode::Env &env, int fd, Genode::Signal_context_capability sigh)
-			: Genode::Thread(env, "rx_signal", 0x1000), fd(fd), sigh(sigh) { }
+			static int _check(int fd, char const *what)
+			{
+				if (fd < 0) {
+					Genode::error("could not create ", what);
+					throw Genode::Exception();
+				}
+				return fd;
+			}
+
+			void _epoll_ctl(int op, int fd, unsigned events)
+			{
+				struct epoll_event ev;
+				Genode::memset(&ev, 0, sizeof(ev));
+				ev.events  = events;
+				ev.data.fd = fd;
+
+				if (epoll_ctl(epoll_fd, op, fd, &ev) != 0)
+					Genode::error("epoll_ctl: errno=", errno);
+			}
+
+			Rx_signal_thread(Genode::Env &env, int const *fds, unsigned num_fds,
+			                 Genode::Signal_context_capability sigh)
+			:
+				Genode::Thread(env, "rx_signal", 0x1000),
+				fds(fds), num_fds(num_fds),
+				epoll_fd(_check(epoll_create1(0), "epoll instance")),
+				stop_fd(_check(eventfd(0, 0), "eventfd")),
+				sigh(sigh)
+			{
+				_epoll_ctl(EPOLL_CTL_ADD, stop_fd, EPOLLIN);
+
+				for (unsigned i = 0; i < num_fds; i++)
+					_epoll_ctl(EPOLL_CTL_ADD, fds[i], EPOLLIN | EPOLLONESHOT);
+			}
+
+			~Rx_signal_thread()
+			{
+				close(epoll_fd);
+				close(stop_fd);
+			}
+
+			/**
+			 * Re-enable the signalling of packet arrivals
+			 */
+			void arm()
+			{
+				for (unsigned i = 0; i < num_fds; i++)
+					_epoll_ctl(EPOLL_CTL_MOD, fds[i], EPOLLIN | EPOLLONESHOT);
+			}
+
+			/**
+			 * Terminate the thread, called by the entrypoint
+			 */
+			void stop()
+			{
+				Genode::uint64_t const value = 1;
+				if (write(stop_fd, &value, sizeof(value)) != sizeof(value))
+					Genode::error("could not stop RX signal thread");
+
+				join();
+			}
 
 			void entry()
 			{
 				while (true) {
-					/* wait for packet arrival on fd */
-					int    ret;
-					fd_set rfds;
+					/* wait for packet arrival on any fd, retry on EINTR */
+					struct epoll_event ev;
+					if (epoll_wait(epoll_fd, &ev, 1, -1) <= 0)
+						continue;
 
-					FD_ZERO(&rfds);
-					FD_SET(fd, &rfds);
-					do { ret = select(fd + 1, &rfds, 0, 0, 0); } while (ret < 0);
+					if (ev.data.fd == stop_fd)
+						return;
 
-					/* signal incoming packet */
+					/* signal incoming packets */
 					Genode::Signal_transmitter(sigh).submit();
 				}
 			}
 		};
 
+		typedef Nic::Offload_header Offload_header;
+
 		Genode::Attached_rom_dataspace _config_rom;
 
 		Nic::Mac_address _mac_addr { };
-		int              _tap_fd;
+
+		/* true if the TAP device prepends a virtio-net header to frames */
+		bool _vnet_hdr = false;
+
+		/* true if the host kernel passes super frames to the driver */
+		bool _rx_gso = false;
+
+		/* true if the RX buffer cannot take another packet */
+		bool _rx_blocked = false;
+
+		unsigned const _num_queues;
+
+		/* one fd per queue, the first one is used for sending */
+		int  _tap_fds[MAX_QUEUES];
+		bool _queue_empty[MAX_QUEUES];
+
+		int const _tap_fd = _setup_tap_fds();
+
 		Rx_signal_thread _rx_thread;
 
-		int _setup_tap_fd()
+		/*
+		 * Buffer for the software segmentation of super frames if the TAP
+		 * device lacks virtio-net header support
+		 */
+		Genode::uint8_t _segment_buf[Nic::Packet_allocator::DEFAULT_PACKET_SIZE];
+
+		static unsigned _queues(Genode::Xml_node config)
+		{
+			unsigned queues = 1;
+			try {
+				queues = config.sub_node("nic").attribute_value("queues", 1U); }
+			catch (...) { }
+
+			return Genode::max(1U, Genode::min(queues, (unsigned)MAX_QUEUES));
+		}
+
+		int _setup_tap_fd(bool multi_queue)
 		{
 			/* open TAP device */
 			int ret;
@@ -104,11 +236,11 @@ class Linux_session_component : public Nic::Session_component
 			/* set fd to non-blocking */
 			if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
 				Genode::error("could not set /dev/net/tun to non-blocking");
+				close(fd);
 				throw Genode::Exception();
 			}
 
 			Genode::memset(&ifr, 0, sizeof(ifr));
-			ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
 
 			/* get tap device from config */
 			try {
@@ -121,17 +253,103 @@ class Linux_session_component : public Nic::Session_component
 				Genode::log("no config provided, using tap0");
 			}
 
+			short const flags = IFF_TAP | IFF_NO_PI
+			                  | (multi_queue ? IFF_MULTI_QUEUE : 0);
+
+			ifr.ifr_flags = flags | IFF_VNET_HDR;
 			ret = ioctl(fd, TUNSETIFF, (void *) &ifr);
+			_vnet_hdr = (ret == 0);
+
+			/* fall back to plain frames */
+			if (ret != 0) {
+				ifr.ifr_flags = flags;
+				ret = ioctl(fd, TUNSETIFF, (void *) &ifr);
+			}
+
 			if (ret != 0) {
 				Genode::error("could not configure /dev/net/tun: no virtual network emulation");
 				close(fd);
-				/* this error is fatal */
-				throw Genode::Exception();
+				throw Genode::Service_denied();
 			}
 
 			return fd;
 		}
 
+		/**
+		 * Open all queues of the TAP device, return fd of the first one
+		 */
+		int _setup_tap_fds()
+		{
+			unsigned i = 0;
+			try {
+				for (; i < _num_queues; i++) {
+					_tap_fds[i]     = _setup_tap_fd(_num_queues > 1);
+					_queue_empty[i] = false;
+				}
+			} catch (...) {
+				while (i--)
+					close(_tap_fds[i]);
+				throw;
+			}
+			return _tap_fds[0];
+		}
+
+		void _writev(struct iovec const *iov, int iovcnt)
+		{
+			int ret;
+
+			/* non-blocking-write packet to TAP */
+			do {
+				ret = writev(_tap_fd, iov, iovcnt);
+				/* drop packet if write would block */
+				if (ret < 0 && errno == EAGAIN)
+					continue;
+
+				if (ret < 0) Genode::error("write: errno=", errno);
+			} while (ret < 0);
+		}
+
+		void _write_frame(void *frame, Genode::size_t size)
+		{
+			/* prepend empty virtio-net header if needed */
+			Offload_header hdr;
+			struct iovec const iov[2] = { { &hdr, sizeof(hdr) }, { frame, size } };
+
+			if (_vnet_hdr)
+				_writev(iov, 2);
+			else
+				_writev(&iov[1], 1);
+		}
+
+		void _write_offload_packet(char *content, Genode::size_t size)
+		{
+			if (size < sizeof(Offload_header)) {
+				Genode::warning("invalid tx packet");
+				return;
+			}
+
+			/* the header matches the virtio-net header of the TAP device */
+			if (_vnet_hdr) {
+				struct iovec const iov { content, size };
+				_writev(&iov, 1);
+				return;
+			}
+
+			Offload_header const hdr = *(Offload_header const *)content;
+
+			Genode::uint8_t * const frame = (Genode::uint8_t *)content + sizeof(hdr);
+
+			bool const ok =
+				Nic::Offload::for_each_frame(hdr, frame, size - sizeof(hdr),
+				                             _segment_buf, sizeof(_segment_buf),
+				                             [&] (Genode::uint8_t *frame,
+				                                  Genode::size_t   size) {
+					_write_frame(frame, size); });
+
+			if (!ok)
+				Genode::warning("dropping tx packet with unsupported offload type");
+		}
+
 		bool _send()
 		{
 			using namespace Genode;
@@ -148,37 +366,90 @@ class Linux_session_component : public Nic::Session_component
 				return true;
 			}
 
-			int ret;
+			char * const content = _tx.sink()->packet_content(packet);
 
-			/* non-blocking-write packet to TAP */
-			do {
-				ret = write(_tap_fd, _tx.sink()->packet_content(packet), packet.size());
-				/* drop packet if write would block */
-				if (ret < 0 && errno == EAGAIN)
-					continue;
-
-				if (ret < 0) Genode::error("write: errno=", errno);
-			} while (ret < 0);
+			if (_offload)
+				_write_offload_packet(content, packet.size());
+			else
+				_write_frame(content, packet.size());
 
 			_tx.sink()->acknowledge_packet(packet);
 
 			return true;
 		}
 
-		bool _receive()
+		/**
+		 * Return maximum size of a received packet
+		 */
+		Genode::size_t _rx_packet_size() const
+		{
+			if (!_offload)
+				return Nic::Packet_allocator::DEFAULT_PACKET_SIZE;
+
+			return sizeof(Offload_header)
+			     + (_rx_gso ? (Genode::size_t)Offload_header::MAX_FRAME_SIZE
+			                : (Genode::size_t)Nic::Packet_allocator::DEFAULT_PACKET_SIZE);
+		}
+
+		/**
+		 * Receive packet from queue
+		 *
+		 * \return false if the queue is empty or the RX buffer is exhausted
+		 */
+		bool _receive(unsigned queue)
 		{
-			unsigned const max_size = Nic::Packet_allocator::DEFAULT_PACKET_SIZE;
+			Genode::size_t const max_size = _rx_packet_size();
 
-			if (!_rx.source()->ready_to_submit())
+			if (!_rx.source()->ready_to_submit()) {
+				_rx_blocked = true;
 				return false;
+			}
 
 			Nic::Packet_descriptor p;
 			try {
 				p = _rx.source()->alloc_packet(max_size);
-			} catch (Session::Rx::Source::Packet_alloc_failed) { return false; }
+			} catch (Session::Rx::Source::Packet_alloc_failed) {
+				_rx_blocked = true;
+				return false;
+			}
+
+			char * const content = _rx.source()->packet_content(p);
+
+			/*
+			 * The virtio-net header of the TAP device is passed to sessions
+			 * with offloading. Otherwise, it is read into a local variable.
+			 * Sessions with offloading on a TAP device without virtio-net
+			 * header support receive an empty header.
+			 */
+			Offload_header hdr;
+
+			bool const skip_hdr = _offload && !_vnet_hdr;
+			if (skip_hdr)
+				*(Offload_header *)content = hdr;
+
+			Genode::size_t const hdr_size = skip_hdr ? sizeof(hdr) : 0;
+
+			struct iovec iov[2] = { { &hdr, sizeof(hdr) },
+			                        { content + hdr_size, max_size - hdr_size } };
 
-			int size = read(_tap_fd, _rx.source()->packet_content(p), max_size);
-			if (size <= 0) {
+			bool const local_hdr = _vnet_hdr && !_offload;
+
+			int size;
+			do {
+				size = (int)readv(_tap_fds[queue], local_hdr ? &iov[0] : &iov[1],
+				                  local_hdr ? 2 : 1);
+			} while (size < 0 && errno == EINTR);
+
+			if (size < 0 && errno != EAGAIN)
+				Genode::error("read: errno=", errno);
+
+			/* the queue is re-armed once all queues are drained */
+			if (size < 0)
+				_queue_empty[queue] = true;
+
+			size += (int)hdr_size - (local_hdr ? (int)sizeof(hdr) : 0);
+
+			if (size <= (int)hdr_size) {
 				_rx.source()->release_packet(p);
 				return false;
 			}
@@ -198,7 +469,60 @@ class Linux_session_component : public Nic::Session_component
 				_rx.source()->release_packet(_rx.source()->get_acked_packet());
 
 			while (_send()) ;
-			while (_receive()) ;
+
+			/*
+			 * Drain all pending packets of the queues in turn. The signalling
+			 * of further packet arrivals is re-enabled unless the RX buffer
+			 * is exhausted. In this case, the draining is resumed once the
+			 * client acknowledges packets.
+			 */
+			_rx_blocked = false;
+			for (unsigned i = 0; i < _num_queues; i++)
+				_queue_empty[i] = false;
+
+			for (bool progress = true; progress && !_rx_blocked; ) {
+				progress = false;
+				for (unsigned i = 0; i < _num_queues && !_rx_blocked; i++)
+					if (!_queue_empty[i] && _receive(i))
+						progress = true;
+			}
+
+			if (!_rx_blocked)
+				_rx_thread.arm();
+		}
+
+		/**
+		 * Return true if the client's RX buffer can hold enough super frames
+		 *
+		 * Otherwise, the allocation of a packet for a super frame fails
+		 * while no packet is in flight, which stalls the reception.
+		 */
+		bool _rx_buffer_suits_gso()
+		{
+			enum { MIN_RX_PACKETS = 4 };
+
+			return _rx.source()->bulk_buffer_size()
+			     >= MIN_RX_PACKETS*(sizeof(Offload_header)
+			                        + (Genode::size_t)Offload_header::MAX_FRAME_SIZE);
+		}
+
+		bool _enable_offload() override
+		{
+			/*
+			 * Let the host kernel pass super frames and partial checksums.
+			 * With a small RX buffer, the received packets stay MTU-sized.
+			 */
+			if (_vnet_hdr) {
+				bool const gso = _rx_buffer_suits_gso();
+				unsigned const flags = TUN_F_CSUM
+				                     | (gso ? TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN : 0);
+
+				bool const ok = ioctl(_tap_fd, TUNSETOFFLOAD, flags) == 0;
+
+				_rx_gso = gso && ok;
+			}
+
+			return true;
 		}
 
 	public:
@@ -210,7 +534,8 @@ class Linux_session_component : public Nic::Session_component
 		:
 			Session_component(tx_buf_size, rx_buf_size, rx_block_md_alloc, env),
 			_config_rom(env, "config"),
-			_tap_fd(_setup_tap_fd()), _rx_thread(env, _tap_fd, _packet_stream_dispatcher)
+			_num_queues(_queues(_config_rom.xml())),
+			_rx_thread(env, _tap_fds, _num_queues, _packet_stream_dispatcher)
 		{
 			/* try using configured MAC address */
 			try {
@@ -230,6 +555,14 @@ class Linux_session_component : public Nic::Session_component
 			_rx_thread.start();
 		}
 
+		~Linux_session_component()
+		{
+			_rx_thread.stop();
+
+			for (unsigned i = 0; i < _num_queues; i++)
+				close(_tap_fds[i]);
+		}
+
 	bool link_state() override              { return true; }
 	Nic::Mac_address mac_address() override { return _mac_addr; }
 };
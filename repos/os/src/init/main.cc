@@ -133,7 +133,7 @@ struct Init::Main : State_reporter::Producer, Child::Default_route_accessor,
 	 */
 	Cap_quota default_caps() override { return _default_caps; }
 
-	State_reporter _state_reporter { _env, *this };
+	State_reporter _state_reporter { _env, _heap, *this };
 
 	Signal_handler<Main> _resource_avail_handler {
 		_env.ep(), *this, &Main::_handle_resource_avail };
@@ -37,6 +37,11 @@ class Init::State_reporter : public Report_update_trigger
 
 		Env &_env;
 
+		Allocator &_alloc;
+
+		/* buffer for generating the report, kept across reports */
+		Xml_generator::Backing_store _report_store { _alloc };
+
 		Producer &_producer;
 
 		Constructible<Reporter> _reporter { };
@@ -69,8 +74,16 @@ class Init::State_reporter : public Report_update_trigger
 		{
 			_scheduled = false;
 
+			if (!_reporter.constructed() || !_reporter->enabled())
+				return;
+
+			/*
+			 * The report is generated in one pass into a growing buffer.
+			 * Periodic reports that do not differ from the previous one are
+			 * not submitted.
+			 */
 			try {
-				Reporter::Xml_generator xml(*_reporter, [&] () {
+				Reporter::Xml_generator xml(*_reporter, _report_store, [&] () {
 
 					if (_version.valid())
 						xml.attribute("version", _version);
@@ -89,13 +102,15 @@ class Init::State_reporter : public Report_update_trigger
 				}
 				catch (...) { }
 			}
+			catch (Out_of_ram)  { warning("state report skipped, out of RAM"); }
+			catch (Out_of_caps) { warning("state report skipped, out of caps"); }
 		}
 
 	public:
 
-		State_reporter(Env &env, Producer &producer)
+		State_reporter(Env &env, Allocator &alloc, Producer &producer)
 		:
-			_env(env), _producer(producer)
+			_env(env), _alloc(alloc), _producer(producer)
 		{ }
 
 		void apply_config(Xml_node config)
@@ -0,0 +1,138 @@
+/*
+ * \brief  Blitting utilities for x86_64
+ * \author Sebastian Sumpf
+ * \author agent
+ * \date   2009-10-26
+ */
+
+/*
+ * Copyright (C) 2009-2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__SPEC__X86_64__BLIT_HELPER_H_
+#define _LIB__BLIT__SPEC__X86_64__BLIT_HELPER_H_
+
+/*
+ * SSE2 is part of the x86_64 base architecture. AVX is not used because the
+ * kernels save only the SSE part of the FPU state on a context switch.
+ */
+
+
+/**
+ * Copy single 16bit column
+ */
+static inline void copy_16bit_column(char const *src, int src_w,
+                                     char *dst, int dst_w, int h)
+{
+	for (; h-- > 0; src += src_w, dst += dst_w)
+		*(short *)dst = *(short const *)src;
+}
+
+
+/**
+ * Copy pixel block 32bit-wise
+ *
+ * \param src    source address
+ * \param dst    32bit-aligned destination address
+ * \param w      number of 32bit words to copy per line
+ * \param h      number of lines to copy
+ * \param src_w  width of source buffer in bytes
+ * \param dst_w  width of destination buffer in bytes
+ */
+static inline void copy_block_32bit(char const *src, int src_w,
+                                    char *dst, int dst_w,
+                                    int w, int h)
+{
+	long d0, d1, d2;
+
+	for (; h--; src += src_w, dst += dst_w )
+		asm volatile ("cld; rep movsl"
+		 : "=S" (d0), "=D" (d1), "=c" (d2)
+		 : "S" (src), "D" (dst), "c" (w)
+		 : "memory");
+}
+
+
+/**
+ * Copy 32byte chunks to a 16byte-aligned destination via SSE2
+ *
+ * The destination is written with non-temporal stores, which do not pollute
+ * the cache with framebuffer content.
+ */
+static inline void copy_32byte_chunks_aligned(void const *src, void *dst, int size)
+{
+	asm volatile (
+		"xor     %%rcx,%%rcx              \n\t"
+		".align 16                        \n\t"
+		"0:                               \n\t"
+		"movdqu  (%%rsi,%%rcx),%%xmm0     \n\t"
+		"movdqu  16(%%rsi,%%rcx),%%xmm1   \n\t"
+		"movntdq %%xmm0,(%%rdi,%%rcx)     \n\t"
+		"movntdq %%xmm1,16(%%rdi,%%rcx)   \n\t"
+		"add     $0x20, %%rcx             \n\t"
+		"dec     %0                       \n\t"
+		"jnz     0b                       \n\t"
+		: "=r"(size)
+		: "S" (src), "D" (dst), "0" (size)
+		: "rcx", "xmm0", "xmm1", "memory"
+	);
+}
+
+
+/**
+ * Copy 32byte chunks to an unaligned destination via SSE2
+ */
+static inline void copy_32byte_chunks_unaligned(void const *src, void *dst, int size)
+{
+	asm volatile (
+		"xor     %%rcx,%%rcx              \n\t"
+		".align 16                        \n\t"
+		"0:                               \n\t"
+		"movdqu  (%%rsi,%%rcx),%%xmm0     \n\t"
+		"movdqu  16(%%rsi,%%rcx),%%xmm1   \n\t"
+		"movdqu  %%xmm0,(%%rdi,%%rcx)     \n\t"
+		"movdqu  %%xmm1,16(%%rdi,%%rcx)   \n\t"
+		"add     $0x20, %%rcx             \n\t"
+		"dec     %0                       \n\t"
+		"jnz     0b                       \n\t"
+		: "=r"(size)
+		: "S" (src), "D" (dst), "0" (size)
+		: "rcx", "xmm0", "xmm1", "memory"
+	);
+}
+
+
+/**
+ * Copy block with a size of multiple of 32 bytes
+ *
+ * \param w  width in 32 byte chunks to copy per line
+ * \param h  number of lines of copy
+ */
+static inline void copy_block_32byte(char const *src, int src_w,
+                                     char *dst, int dst_w,
+                                     int w, int h)
+{
+	if (!w)
+		return;
+
+	bool non_temporal = false;
+
+	/* depending on 'dst_w', some lines may be aligned while others are not */
+	for (int i = h; i--; src += src_w, dst += dst_w) {
+		if ((long)dst & 15) {
+			copy_32byte_chunks_unaligned(src, dst, w);
+		} else {
+			copy_32byte_chunks_aligned(src, dst, w);
+			non_temporal = true;
+		}
+	}
+
+	/* order the non-temporal stores before subsequent stores */
+	if (non_temporal)
+		asm volatile ("sfence" : : : "memory");
+}
+
+#endif /* _LIB__BLIT__SPEC__X86_64__BLIT_HELPER_H_ */
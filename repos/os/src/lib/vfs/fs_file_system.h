@@ -587,7 +587,8 @@ class Vfs::Fs_file_system : public File_system
 			_fs(env, _fs_packet_alloc,
 			    _label.string(), _root.string(),
 			    config.attribute_value("writeable", true),
-			    ::File_system::DEFAULT_TX_BUF_SIZE)
+			    config.attribute_value("buffer_size",
+			                           Genode::Number_of_bytes(::File_system::DEFAULT_TX_BUF_SIZE)))
 		{
 			_fs.sigh_ack_avail(_ack_handler);
 			_fs.sigh_ready_to_submit(_ready_handler);
@@ -157,6 +157,12 @@ class Driver : public Block::Driver
 		 */
 		inline void _handle_reply(Block::Packet_descriptor &srv, Request *r)
 		{
+			/* 'SYNC' and 'TRIM' requests are passed through */
+			if (r->cli.barrier()) {
+				ack_packet(r->cli, srv.succeeded());
+				return;
+			}
+
 			try {
 			if (r->cli.operation() == Block::Packet_descriptor::READ)
 				read(r->cli.block_number(), r->cli.block_count(),
@@ -260,6 +266,30 @@ class Driver : public Block::Driver
 			}
 		}
 
+		/*
+		 * Pass 'SYNC' or 'TRIM' request to the backend device
+		 *
+		 * The backend device executes the request after the write requests
+		 * submitted before.
+		 */
+		void _forward(Block::Packet_descriptor::Opcode op,
+		              Block::sector_t                  block_number,
+		              Genode::size_t                   block_count,
+		              Block::Packet_descriptor        &packet)
+		{
+			if (!_blk.tx()->ready_to_submit())
+				throw Request_congestion();
+
+			try {
+				Block::Packet_descriptor p(_blk.tx()->alloc_packet(0), op,
+				                           block_number, block_count);
+				_r_list.insert(new (&_r_slab) Request(p, packet, nullptr));
+				_blk.tx()->submit_packet(p);
+			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+				throw Request_congestion();
+			}
+		}
+
 		/*
 		 * Synchronize dirty chunks with backend device
 		 */
@@ -421,4 +451,37 @@ class Driver : public Block::Driver
 		}
 
 		void sync() { _sync(); }
+
+		void sync(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet) override
+		{
+			/* write back dirty chunks before the backend syncs */
+			_sync();
+
+			/* fall back to the blocking RPC of a backend without 'SYNC' */
+			if (!_ops.supported(Block::Packet_descriptor::SYNC)) {
+				_blk.sync();
+				ack_packet(packet);
+				return;
+			}
+
+			_forward(Block::Packet_descriptor::SYNC, block_number, block_count,
+			         packet);
+		}
+
+		/*
+		 * Cached content of trimmed blocks is kept because the content of
+		 * such blocks is undefined anyway.
+		 */
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet) override
+		{
+			if (!_ops.supported(Block::Packet_descriptor::TRIM))
+				throw Io_error();
+
+			_forward(Block::Packet_descriptor::TRIM, block_number, block_count,
+			         packet);
+		}
 };
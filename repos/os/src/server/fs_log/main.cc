@@ -33,10 +33,17 @@ namespace Fs_log {
 
 	class  Root_component;
 
+	typedef File_system::Session::Tx_policy Tx_policy;
+
+	/*
+	 * A packet holds as much output as a session's ring. The buffer also
+	 * hosts the submit and acknowledgement queues.
+	 */
 	enum {
-		PACKET_SIZE = Log_session::String::MAX_SIZE,
-		 QUEUE_SIZE = File_system::Session::TX_QUEUE_SIZE,
-		TX_BUF_SIZE = PACKET_SIZE * (QUEUE_SIZE+2)
+		PACKET_SIZE = sizeof(Log_ring::data),
+		NUM_PACKETS = File_system::Session::TX_QUEUE_SIZE - 1,
+		TX_BUF_SIZE = PACKET_SIZE * (NUM_PACKETS+2)
+		            + sizeof(Tx_policy::Submit_queue) + sizeof(Tx_policy::Ack_queue)
 	};
 
 	typedef Genode::Path<File_system::MAX_PATH_LEN> Path;
@@ -69,7 +76,7 @@ class Fs_log::Root_component :
 
 			size_t ram_quota =
 				Arg_string::find_arg(args, "ram_quota").aligned_size();
-			if (ram_quota < sizeof(Session_component))
+			if (ram_quota < sizeof(Session_component) + sizeof(Log_ring))
 				throw Insufficient_ram_quota();
 
 			Path dir_path;
@@ -148,7 +155,8 @@ class Fs_log::Root_component :
 					                 File_system::WRITE_ONLY, true));
 				}
 
-				return new (md_alloc()) Session_component(_fs, *handle, label_prefix);
+				return new (md_alloc())
+					Session_component(_env, _fs, *handle, label_prefix);
 			}
 			catch (Permission_denied) {
 				errstr = "permission denied"; }
@@ -171,6 +179,11 @@ class Fs_log::Root_component :
 			throw Service_denied();
 		}
 
+		void _upgrade_session(Session_component *s, const char *args) override
+		{
+			s->upgrade(Genode::cap_quota_from_args(args));
+		}
+
 	public:
 
 		/**
@@ -185,7 +198,7 @@ class Fs_log::Root_component :
 
 			/* fill the ack queue with packets so sessions never need to alloc */
 			File_system::Session::Tx::Source &source = *_fs.tx();
-			for (int i = 0; i < QUEUE_SIZE-1; ++i)
+			for (int i = 0; i < NUM_PACKETS; ++i)
 				source.submit_packet(source.alloc_packet(PACKET_SIZE));
 
 			env.parent().announce(env.ep().manage(*this));
@@ -19,7 +19,10 @@
 
 /* Genode includes */
 #include <log_session/log_session.h>
+#include <log_session/log_ring.h>
 #include <file_system_session/file_system_session.h>
+#include <base/attached_ram_dataspace.h>
+#include <util/reconstructible.h>
 #include <base/rpc_server.h>
 #include <base/snprintf.h>
 #include <base/log.h>
@@ -41,14 +44,119 @@ class Fs_log::Session_component : public Genode::Rpc_object<Genode::Log_session>
 		File_system::Session          &_fs;
 		File_system::File_handle const _handle;
 
+		Genode::Env &_env;
+
+		/*
+		 * The ring is allocated not before the client donated the
+		 * capabilities it consumes
+		 */
+		Genode::size_t _ring_caps = 0;
+
+		Genode::Constructible<Genode::Attached_ram_dataspace> _ring_ds { };
+
+		Genode::Constructible<Genode::Signal_handler<Session_component> > _ring_handler { };
+
+		/*
+		 * Packet filled with output until it is full or the output
+		 * consumed at once is complete
+		 */
+		File_system::Packet_descriptor _packet { };
+		Genode::size_t                 _packet_len = 0;
+		bool                           _packet_acquired = false;
+
+		/* true if the next character starts a new line */
+		bool _line_start = true;
+
+		File_system::Session::Tx::Source &_source() { return *_fs.tx(); }
+
+		void _acquire_packet()
+		{
+			_packet = _source().get_acked_packet();
+
+			if (_packet.operation() == File_system::Packet_descriptor::SYNC)
+				_fs.close(_packet.handle());
+
+			_packet_len      = 0;
+			_packet_acquired = true;
+		}
+
+		void _submit_packet()
+		{
+			if (!_packet_acquired)
+				return;
+
+			_source().submit_packet(File_system::Packet_descriptor(
+				_packet, _handle, File_system::Packet_descriptor::WRITE,
+				_packet_len, File_system::SEEK_TAIL));
+
+			_packet_acquired = false;
+		}
+
+		void _append(char const *s, Genode::size_t len)
+		{
+			while (len) {
+
+				if (!_packet_acquired)
+					_acquire_packet();
+
+				Genode::size_t const n =
+					Genode::min(len, _packet.size() - _packet_len);
+
+				Genode::memcpy(_source().packet_content(_packet) + _packet_len, s, n);
+				_packet_len += n;
+				s   += n;
+				len -= n;
+
+				if (_packet_len == _packet.size())
+					_submit_packet();
+			}
+		}
+
+		/**
+		 * Append output with each line prefixed by the label
+		 */
+		void _output(char const *s, Genode::size_t len)
+		{
+			while (len) {
+
+				if (_line_start && _label_len)
+					_append(_label_buf, _label_len);
+
+				Genode::size_t n = 0;
+				while (n < len && s[n++] != '\n');
+
+				_append(s, n);
+				_line_start = (s[n - 1] == '\n');
+
+				s   += n;
+				len -= n;
+			}
+		}
+
+		void _consume_ring()
+		{
+			if (!_ring_ds.constructed())
+				return;
+
+			_ring_ds->local_addr<Genode::Log_ring>()->consume(
+				[&] (char const *s, Genode::size_t len) { _output(s, len); });
+		}
+
+		void _handle_ring()
+		{
+			_consume_ring();
+			_submit_packet();
+		}
+
 	public:
 
-		Session_component(File_system::Session     &fs,
+		Session_component(Genode::Env              &env,
+		                  File_system::Session     &fs,
 		                  File_system::File_handle  handle,
 		                  char               const *label)
 		:
 			_label_len(Genode::strlen(label) ? Genode::strlen(label)+3 : 0),
-			_fs(fs), _handle(handle)
+			_fs(fs), _handle(handle), _env(env)
 		{
 			if (_label_len)
 				Genode::snprintf(_label_buf, MAX_LABEL_LEN, "[%s] ", label);
@@ -56,9 +164,12 @@ class Fs_log::Session_component : public Genode::Rpc_object<Genode::Log_session>
 
 		~Session_component()
 		{
+			/* write output left in the ring */
+			_handle_ring();
+
 			/* sync */
 
-			File_system::Session::Tx::Source &source = *_fs.tx();
+			File_system::Session::Tx::Source &source = _source();
 
 			File_system::Packet_descriptor packet = source.get_acked_packet();
 
@@ -71,6 +182,8 @@ class Fs_log::Session_component : public Genode::Rpc_object<Genode::Log_session>
 			source.submit_packet(packet);
 		}
 
+		void upgrade(Genode::Cap_quota caps) { _ring_caps += caps.value; }
+
 
 		/*****************
 		 ** Log session **
@@ -87,43 +200,43 @@ class Fs_log::Session_component : public Genode::Rpc_object<Genode::Log_session>
 
 			size_t msg_len = strlen(msg.string());
 
-			File_system::Session::Tx::Source &source = *_fs.tx();
-
-			File_system::Packet_descriptor packet = source.get_acked_packet();
-
-			if (packet.operation() == File_system::Packet_descriptor::SYNC)
-				_fs.close(packet.handle());
-
-			packet = File_system::Packet_descriptor(
-				packet, _handle, File_system::Packet_descriptor::WRITE,
-				msg_len, File_system::SEEK_TAIL);
+			/* preserve the order with respect to the output in the ring */
+			_consume_ring();
 
-			char *buf = source.packet_content(packet);
-
-			if (_label_len) {
-				memcpy(buf, _label_buf, _label_len);
+			_output(msg.string(), msg_len);
+			_submit_packet();
+			return msg_len;
+		}
 
-				if (_label_len+msg_len > Log_session::String::MAX_SIZE) {
-					packet.length(msg_len);
-					source.submit_packet(packet);
+		Genode::Dataspace_capability ring_dataspace() override
+		{
+			using namespace Genode;
 
-					packet =  File_system::Packet_descriptor(
-						source.get_acked_packet(),
-				       _handle, File_system::Packet_descriptor::WRITE,
-				       msg_len, File_system::SEEK_TAIL);
+			if (_ring_ds.constructed())
+				return _ring_ds->cap();
 
-					buf = source.packet_content(packet);
+			if (_ring_caps < Log_session::RING_CAP_QUOTA)
+				return Dataspace_capability();
 
-				} else {
-					buf += _label_len;
-					packet.length(_label_len+msg_len);
-				}
+			try {
+				_ring_ds.construct(_env.ram(), _env.rm(), sizeof(Log_ring));
+				_ring_handler.construct(_env.ep(), *this,
+				                        &Session_component::_handle_ring);
+			}
+			catch (...) {
+				_ring_ds.destruct();
+				return Dataspace_capability();
 			}
 
-			memcpy(buf, msg.string(), msg_len);
+			return _ring_ds->cap();
+		}
 
-			source.submit_packet(packet);
-			return msg_len;
+		Genode::Signal_context_capability ring_sigh() override
+		{
+			if (!_ring_handler.constructed())
+				return Genode::Signal_context_capability();
+
+			return *_ring_handler;
 		}
 };
 
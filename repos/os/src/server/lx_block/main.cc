@@ -25,6 +25,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
 #include <stdio.h> /* perror */
 
 
@@ -89,6 +90,7 @@ class Lx_block_driver : public Block::Driver
 			_block_ops.set_operation(Block::Packet_descriptor::READ);
 			if (writeable) {
 				_block_ops.set_operation(Block::Packet_descriptor::WRITE);
+				_block_ops.set_operation(Block::Packet_descriptor::TRIM);
 			}
 
 			Genode::log("Provide '", file.string(), "' as block device "
@@ -151,7 +153,36 @@ class Lx_block_driver : public Block::Driver
 			ack_packet(packet);
 		}
 
-		void sync() { }
+		void sync() override
+		{
+			if (fdatasync(_fd) == -1)
+				perror("fdatasync");
+		}
+
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet) override
+		{
+			if (!_block_ops.supported(Block::Packet_descriptor::TRIM)) {
+				throw Io_error();
+			}
+
+			off_t const offset = block_number * _block_size;
+			off_t const count  = block_count  * _block_size;
+
+			/*
+			 * Release the space of the range in the backing file. If the
+			 * file system of the host does not support this, the content
+			 * is simply left in place.
+			 */
+			if (fallocate(_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+			              offset, count) == -1 && errno != EOPNOTSUPP) {
+				perror("fallocate");
+				throw Io_error();
+			}
+
+			ack_packet(packet);
+		}
 };
 
 
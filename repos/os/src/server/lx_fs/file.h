@@ -135,6 +135,9 @@ class Lx_fs::File : public Node
 			return ret == -1 ? 0 : ret;
 		}
 
+		/* 'pread' and 'pwrite' leave no state shared with the entrypoint */
+		bool concurrent_io() const override { return true; }
+
 		Status status() override
 		{
 			Status s;
@@ -0,0 +1,193 @@
+/*
+ * \brief  Threads performing file I/O on behalf of the entrypoint
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _IO_POOL_H_
+#define _IO_POOL_H_
+
+/* Genode includes */
+#include <base/thread.h>
+#include <base/semaphore.h>
+#include <base/lock.h>
+#include <util/fifo.h>
+#include <util/reconstructible.h>
+
+/* local includes */
+#include <node.h>
+
+namespace Lx_fs {
+
+	struct Io_job;
+	class  Io_pool;
+}
+
+
+/**
+ * Operation of a packet executed by an I/O thread
+ *
+ * Besides reads and writes, a job may carry a packet that the entrypoint
+ * handles once the preceding jobs of the same file are completed.
+ */
+struct Lx_fs::Io_job : Genode::Fifo<Io_job>::Element
+{
+	typedef File_system::Packet_descriptor Packet_descriptor;
+
+	/**
+	 * Interface for receiving completed jobs, called by the I/O thread
+	 */
+	struct Owner : Genode::Interface
+	{
+		virtual void io_job_done(Io_job &) = 0;
+	};
+
+	Owner             *owner   = nullptr;
+	Node              *node    = nullptr;
+	char              *content = nullptr;
+	Packet_descriptor  packet { };
+
+	/* false if the packet must not be acknowledged */
+	bool ack = true;
+
+	void execute()
+	{
+		size_t const length = packet.length();
+
+		ack = true;
+
+		switch (packet.operation()) {
+
+		case Packet_descriptor::READ:
+			{
+				size_t const res = node->read(content, length, packet.position());
+
+				/* read data or EOF is a success */
+				packet.length(res);
+				packet.succeeded(res || (packet.position() >= node->status().size));
+				break;
+			}
+
+		case Packet_descriptor::WRITE:
+			{
+				size_t const res = node->write(content, length, packet.position());
+
+				/* file system session can't handle partial writes */
+				if (res != length) {
+					Genode::error("partial write detected ", res, " vs ", length);
+					ack = false;
+				}
+				packet.length(res);
+				packet.succeeded(true);
+				break;
+			}
+
+		default:
+			/* executed by the entrypoint on completion */
+			break;
+		}
+	}
+};
+
+
+/**
+ * Pool of threads executing 'Io_job' objects
+ *
+ * Each job is assigned to a thread according to a key supplied by the
+ * submitter. Jobs with the same key are executed in the order of their
+ * submission whereas jobs with different keys may complete in any order.
+ * With no threads, jobs are executed directly by the submitter.
+ */
+class Lx_fs::Io_pool
+{
+	public:
+
+		enum { MAX_THREADS = 16 };
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Io_pool(Io_pool const &);
+		Io_pool &operator = (Io_pool const &);
+
+		class Worker : public Genode::Thread
+		{
+			private:
+
+				Genode::Lock         _lock  { };
+				Genode::Fifo<Io_job> _queue { };
+				Genode::Semaphore    _avail { };
+
+				void entry() override
+				{
+					for (;;) {
+						_avail.down();
+
+						Io_job *job = nullptr;
+						{
+							Genode::Lock_guard<Genode::Lock> guard(_lock);
+							job = _queue.dequeue();
+						}
+
+						job->execute();
+						job->owner->io_job_done(*job);
+					}
+				}
+
+			public:
+
+				enum { STACK_SIZE = 8*1024*sizeof(long) };
+
+				Worker(Genode::Env &env)
+				:
+					Genode::Thread(env, "io", STACK_SIZE, Location(),
+					               Weight(), env.cpu())
+				{ }
+
+				void submit(Io_job &job)
+				{
+					{
+						Genode::Lock_guard<Genode::Lock> guard(_lock);
+						_queue.enqueue(&job);
+					}
+					_avail.up();
+				}
+		};
+
+		unsigned const _threads;
+
+		Genode::Constructible<Worker> _workers[MAX_THREADS];
+
+	public:
+
+		Io_pool(Genode::Env &env, unsigned threads)
+		: _threads(Genode::min(threads, (unsigned)MAX_THREADS))
+		{
+			for (unsigned i = 0; i < _threads; i++) {
+				_workers[i].construct(env);
+				_workers[i]->start();
+			}
+		}
+
+		void submit(Io_job &job, unsigned long key)
+		{
+			if (_threads == 0) {
+				job.execute();
+				job.owner->io_job_done(job);
+				return;
+			}
+
+			_workers[key % _threads]->submit(job);
+		}
+};
+
+#endif /* _IO_POOL_H_ */
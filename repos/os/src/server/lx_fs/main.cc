@@ -19,10 +19,12 @@
 #include <file_system_session/rpc_object.h>
 #include <os/session_policy.h>
 #include <util/xml_node.h>
+#include <util/list.h>
 
 /* local includes */
 #include <directory.h>
 #include <open_node.h>
+#include <io_pool.h>
 
 namespace Lx_fs {
 
@@ -36,7 +38,9 @@ namespace Lx_fs {
 }
 
 
-class Lx_fs::Session_component : public Session_rpc_object
+class Lx_fs::Session_component : public Session_rpc_object,
+                                  public  Genode::List<Session_component>::Element,
+                                  private Io_job::Owner
 {
 	private:
 
@@ -47,10 +51,124 @@ class Lx_fs::Session_component : public Session_rpc_object
 		Directory                   &_root;
 		Id_space<File_system::Node>  _open_node_registry { };
 		bool                         _writable;
+		Io_pool                     &_io_pool;
 
 		Signal_handler<Session_component> _process_packet_dispatcher;
 
 
+		/*********************************
+		 ** Asynchronous read and write **
+		 *********************************/
+
+		/*
+		 * Reads and writes of files are executed by the I/O pool. The
+		 * acknowledgements are sent by the entrypoint in the order of
+		 * completion. Packets that must observe the effects of the reads
+		 * and writes in flight pass the I/O pool as well and are handled
+		 * on completion. So the entrypoint never waits for an I/O thread.
+		 */
+
+		Io_job       _jobs[TX_QUEUE_SIZE];
+		Fifo<Io_job> _free_jobs { };
+
+		/* members shared with the I/O threads */
+		Genode::Lock _jobs_lock { };
+		Fifo<Io_job> _completed_jobs { };
+		unsigned     _jobs_in_flight = 0;
+
+		/* valid once the session is closed while jobs are in flight */
+		Signal_context_capability _retired_sigh { };
+
+		/**
+		 * Io_job::Owner interface, called by an I/O thread
+		 */
+		void io_job_done(Io_job &job) override
+		{
+			Genode::Lock_guard<Genode::Lock> guard(_jobs_lock);
+
+			_completed_jobs.enqueue(&job);
+			_jobs_in_flight--;
+
+			Signal_transmitter(_process_packet_dispatcher).submit();
+		}
+
+		void _submit_job(Packet_descriptor const &packet, Node &node)
+		{
+			Io_job &job = *_free_jobs.dequeue();
+
+			job.owner   = this;
+			job.node    = &node;
+			job.content = tx_sink()->packet_content(packet);
+			job.packet  = packet;
+
+			node.io_job_submitted();
+
+			{
+				Genode::Lock_guard<Genode::Lock> guard(_jobs_lock);
+				_jobs_in_flight++;
+			}
+
+			/* keep the operations on the same file in order */
+			_io_pool.submit(job, node.inode());
+		}
+
+		/**
+		 * Return true if the packet must wait for the jobs of the node
+		 */
+		static bool _after_jobs(Packet_descriptor const &packet, Node const &node)
+		{
+			switch (packet.operation()) {
+			case Packet_descriptor::CONTENT_CHANGED:
+			case Packet_descriptor::SYNC:
+				return node.io_jobs() > 0;
+			default:
+				return false;
+			}
+		}
+
+		void _complete_jobs()
+		{
+			for (;;) {
+
+				bool const retired = _retired_sigh.valid();
+
+				/* completing a job may acknowledge a packet */
+				if (!retired && !tx_sink()->ready_to_ack())
+					return;
+
+				Io_job *job = nullptr;
+				{
+					Genode::Lock_guard<Genode::Lock> guard(_jobs_lock);
+					job = _completed_jobs.dequeue();
+				}
+
+				if (!job)
+					return;
+
+				Node &node = *job->node;
+
+				if (!retired) {
+					switch (job->packet.operation()) {
+					case Packet_descriptor::READ:
+					case Packet_descriptor::WRITE:
+						if (job->ack)
+							tx_sink()->acknowledge_packet(job->packet);
+						break;
+					default:
+						_process_deferred_packet(job->packet);
+					}
+				}
+
+				node.io_job_completed();
+
+				if (node.closed() && !node.io_jobs())
+					destroy(_md_alloc, &node);
+
+				_free_jobs.enqueue(job);
+			}
+		}
+
+
 		/******************************
 		 ** Packet-stream processing **
 		 ******************************/
@@ -73,6 +191,12 @@ class Lx_fs::Session_component : public Session_rpc_object
 
 			case Packet_descriptor::READ:
 				if (content && (packet.length() <= packet.size())) {
+
+					if (open_node.node().concurrent_io()) {
+						_submit_job(packet, open_node.node());
+						return;
+					}
+
 					res_length = open_node.node().read((char *)content, length,
 					                                   packet.position());
 
@@ -83,6 +207,12 @@ class Lx_fs::Session_component : public Session_rpc_object
 
 			case Packet_descriptor::WRITE:
 				if (content && (packet.length() <= packet.size())) {
+
+					if (open_node.node().concurrent_io()) {
+						_submit_job(packet, open_node.node());
+						return;
+					}
+
 					res_length = open_node.node().write((char const *)content,
 					                                    length,
 					                                    packet.position());
@@ -135,7 +265,11 @@ class Lx_fs::Session_component : public Session_rpc_object
 			packet.succeeded(false);
 
 			auto process_packet_fn = [&] (Open_node &open_node) {
-				_process_packet_op(packet, open_node);
+
+				if (_after_jobs(packet, open_node.node()))
+					_submit_job(packet, open_node.node());
+				else
+					_process_packet_op(packet, open_node);
 			};
 
 			try {
@@ -146,12 +280,40 @@ class Lx_fs::Session_component : public Session_rpc_object
 			}
 		}
 
+		/**
+		 * Process packet that waited for the completion of the preceding jobs
+		 */
+		void _process_deferred_packet(Packet_descriptor packet)
+		{
+			/* assume failure by default */
+			packet.succeeded(false);
+
+			auto process_packet_fn = [&] (Open_node &open_node) {
+				_process_packet_op(packet, open_node); };
+
+			/* the node may have been closed in the meantime */
+			try {
+				_open_node_registry.apply<Open_node>(packet.handle(), process_packet_fn);
+			} catch (Id_space<File_system::Node>::Unknown_id const &) {
+				tx_sink()->acknowledge_packet(packet);
+			}
+		}
+
 		/**
 		 * Called by signal dispatcher, executed in the context of the main
 		 * thread (not serialized with the RPC functions)
 		 */
 		void _process_packets()
 		{
+			_complete_jobs();
+
+			/* a closed session waits for the completion of its jobs */
+			if (_retired_sigh.valid()) {
+				if (idle())
+					Signal_transmitter(_retired_sigh).submit();
+				return;
+			}
+
 			while (tx_sink()->packet_avail()) {
 
 				/*
@@ -169,6 +331,13 @@ class Lx_fs::Session_component : public Session_rpc_object
 				if (!tx_sink()->ready_to_ack())
 					return;
 
+				/*
+				 * If all jobs are in flight, we resume the processing
+				 * once a job is completed.
+				 */
+				if (_free_jobs.empty())
+					return;
+
 				_process_packet();
 			}
 		}
@@ -193,15 +362,20 @@ class Lx_fs::Session_component : public Session_rpc_object
 		                  Genode::Env &env,
 		                  char const  *root_dir,
 		                  bool         writable,
-		                  Allocator   &md_alloc)
+		                  Allocator   &md_alloc,
+		                  Io_pool     &io_pool)
 		:
 			Session_rpc_object(env.ram().alloc(tx_buf_size), env.rm(), env.ep().rpc_ep()),
 			_env(env),
 			_md_alloc(md_alloc),
 			_root(*new (&_md_alloc) Directory(_md_alloc, root_dir, false)),
 			_writable(writable),
+			_io_pool(io_pool),
 			_process_packet_dispatcher(env.ep(), *this, &Session_component::_process_packets)
 		{
+			for (unsigned i = 0; i < TX_QUEUE_SIZE; i++)
+				_free_jobs.enqueue(&_jobs[i]);
+
 			/*
 			 * Register '_process_packets' dispatch function as signal
 			 * handler for packet-avail and ready-to-ack signals.
@@ -221,6 +395,23 @@ class Lx_fs::Session_component : public Session_rpc_object
 		}
 
 
+		/**
+		 * Return true if no I/O thread refers to the session
+		 */
+		bool idle()
+		{
+			Genode::Lock_guard<Genode::Lock> guard(_jobs_lock);
+			return !_jobs_in_flight && _completed_jobs.empty();
+		}
+
+		/**
+		 * Stop packet processing after the session got closed
+		 *
+		 * \param sigh  handler notified once the session became idle
+		 */
+		void retire(Signal_context_capability sigh) { _retired_sigh = sigh; }
+
+
 		/***************************
 		 ** File_system interface **
 		 ***************************/
@@ -303,7 +494,12 @@ class Lx_fs::Session_component : public Session_rpc_object
 			auto close_fn = [&] (Open_node &open_node) {
 				Node &node = open_node.node();
 				destroy(_md_alloc, &open_node);
-				destroy(_md_alloc, &node);
+
+				/* a node in use by an I/O thread is destroyed on completion */
+				if (node.io_jobs())
+					node.mark_as_closed();
+				else
+					destroy(_md_alloc, &node);
 			};
 
 			try {
@@ -367,8 +563,43 @@ class Lx_fs::Root : public Root_component<Session_component>
 
 		Genode::Attached_rom_dataspace _config { _env, "config" };
 
+		Io_pool _io_pool { _env, _config.xml().attribute_value("io_threads", 4U) };
+
+		/*
+		 * Sessions closed while I/O threads refer to them are destroyed
+		 * once they became idle
+		 */
+		Genode::List<Session_component> _retired_sessions { };
+
+		void _destroy_retired_sessions()
+		{
+			Session_component *session = _retired_sessions.first();
+			while (session) {
+				Session_component *next = session->next();
+				if (session->idle()) {
+					_retired_sessions.remove(session);
+					Genode::destroy(md_alloc(), session);
+				}
+				session = next;
+			}
+		}
+
+		Signal_handler<Root> _retired_handler {
+			_env.ep(), *this, &Root::_destroy_retired_sessions };
+
 	protected:
 
+		void _destroy_session(Session_component *session) override
+		{
+			if (session->idle()) {
+				Genode::destroy(md_alloc(), session);
+				return;
+			}
+
+			session->retire(_retired_handler);
+			_retired_sessions.insert(session);
+		}
+
 		Session_component *_create_session(const char *args)
 		{
 			/*
@@ -448,7 +679,8 @@ class Lx_fs::Root : public Root_component<Session_component>
 
 			try {
 				return new (md_alloc())
-				       Session_component(tx_buf_size, _env, root_dir, writeable, *md_alloc());
+				       Session_component(tx_buf_size, _env, root_dir, writeable,
+				                         *md_alloc(), _io_pool);
 			}
 			catch (Lookup_failed) {
 				Genode::error("session root directory \"", Genode::Cstring(root), "\" "
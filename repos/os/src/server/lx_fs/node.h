@@ -36,6 +36,10 @@ class Lx_fs::Node : public File_system::Node_base
 		Name                _name;
 		unsigned long const _inode;
 
+		/* state of the asynchronous I/O, accessed by the entrypoint only */
+		unsigned _io_jobs = 0;
+		bool     _closed  = false;
+
 	public:
 
 		Node(unsigned long inode) : _inode(inode) { _name[0] = 0; }
@@ -53,6 +57,21 @@ class Lx_fs::Node : public File_system::Node_base
 
 		virtual Status status() = 0;
 
+		/**
+		 * Return true if 'read' and 'write' may be called by an I/O thread
+		 */
+		virtual bool concurrent_io() const { return false; }
+
+		/*
+		 * Accounting of the I/O jobs in flight, a closed node is destroyed
+		 * after its last job completed
+		 */
+		void     io_job_submitted()     { _io_jobs++; }
+		void     io_job_completed()     { _io_jobs--; }
+		unsigned io_jobs()        const { return _io_jobs; }
+		void     mark_as_closed()       { _closed = true; }
+		bool     closed()         const { return _closed; }
+
 		/*
 		 * File functionality
 		 */
@@ -14,6 +14,11 @@
  * in the output queue the mixer sums the corresponding packets from all input
  * sessions up. The volume level of an input packet is applied in a linear way
  * (sample_value * volume_level) and the output packet is clipped at [1.0,-1.0].
+ *
+ * Sessions that were created with a sample rate different from the rate of
+ * the output session are converted once per stream. The converted packets
+ * are staged in a stream of their own (Session_elem::mix_stream), which is
+ * then mixed like the stream of any other session.
  */
 
 /*
@@ -37,6 +42,10 @@
 #include <base/heap.h>
 #include <base/component.h>
 #include <base/log.h>
+#include <util/construct_at.h>
+
+/* local includes */
+#include <resampler.h>
 
 
 typedef Mixer::Channel Channel;
@@ -113,17 +122,135 @@ struct Audio_out::Session_elem : Audio_out::Session_rpc_object,
 
 	using Genode::List<Session_elem>::Element::next;
 
+	/*
+	 * Noncopyable
+	 */
+	Session_elem(Session_elem const &);
+	Session_elem &operator = (Session_elem const &);
+
 	Label           label;
 	Channel::Number number { Channel::INVALID };
 	float           volume { 0.f };
 	bool            muted  { true };
 
+	/*
+	 * Backing store of the staging stream and the resampler, only present
+	 * if the sample rate of the session differs from the output rate
+	 */
+	Genode::Constructible<Genode::Attached_ram_dataspace> _conversion_ds { };
+
+	Stream    *_staging   = nullptr;
+	Resampler *_resampler = nullptr;
+
+	/* position of the next client packet to convert */
+	unsigned _convert_pos = 0;
+
+	/**
+	 * Size of the conversion backing store needed for a given sample rate
+	 */
+	static Genode::size_t conversion_size(unsigned sample_rate)
+	{
+		return sample_rate == SAMPLE_RATE
+		       ? 0 : sizeof(Stream) + sizeof(Resampler);
+	}
+
 	Session_elem(Genode::Env & env,
-	             char const *label, Genode::Signal_context_capability data_cap)
-	: Session_rpc_object(env, data_cap), label(label) { }
+	             char const *label, Genode::Signal_context_capability data_cap,
+	             unsigned sample_rate)
+	: Session_rpc_object(env, data_cap), label(label)
+	{
+		if (!conversion_size(sample_rate))
+			return;
+
+		_conversion_ds.construct(env.ram(), env.rm(), conversion_size(sample_rate));
+
+		_staging   = _conversion_ds->local_addr<Stream>();
+		_resampler = Genode::construct_at<Resampler>(_staging + 1, sample_rate,
+		                                             (unsigned)SAMPLE_RATE);
+	}
+
+	~Session_elem()
+	{
+		if (_resampler)
+			_resampler->~Resampler();
+	}
+
+	/**
+	 * Stream that is mixed into the output
+	 */
+	Stream *mix_stream() { return _staging ? _staging : stream(); }
 
 	Packet *get_packet(unsigned offset) {
-		return stream()->get(stream()->pos() + offset); }
+		return mix_stream()->get(mix_stream()->pos() + offset); }
+
+	/**
+	 * Synchronize the session's streams with the output position
+	 */
+	void position(unsigned pos)
+	{
+		stream()->pos(pos);
+
+		if (!_staging)
+			return;
+
+		/* the client starts allocating packets right after 'pos' */
+		_convert_pos = (pos + 1) % QUEUE_SIZE;
+
+		_staging->invalidate_all();
+		_staging->pos(pos);
+		_staging->reset();
+		_resampler->reset();
+	}
+
+	/**
+	 * Convert submitted client packets into the staging stream
+	 *
+	 * A client packet is converted only if the staging stream has room for
+	 * all output periods it may complete. Otherwise, it stays in the
+	 * client's queue until staged packets are played, which keeps the
+	 * client from running ahead of the playback.
+	 */
+	void convert()
+	{
+		if (!_staging || stopped())
+			return;
+
+		Stream * const in   = stream();
+		bool     const full = in->full();
+		bool     progress   = false;
+
+		unsigned const needed = _resampler->max_output_periods();
+
+		for (Packet *p = in->get(_convert_pos);
+		     p->valid() && QUEUE_SIZE - 1 - _staging->queued() >= needed;
+		     p = in->get(_convert_pos)) {
+
+			_resampler->process(p->content(), [&] (float *samples) {
+				try {
+					Packet *out = _staging->alloc();
+					out->content(samples, PERIOD);
+					_staging->submit(out);
+				} catch (Stream::Alloc_failed) {
+					Genode::warning("staging stream of '", label, "' is full"); }
+			});
+
+			p->invalidate();
+			p->mark_as_played();
+
+			_convert_pos = (_convert_pos + 1) % QUEUE_SIZE;
+			progress     = true;
+		}
+
+		if (!progress)
+			return;
+
+		/* release converted packets to the client */
+		in->pos((_convert_pos + QUEUE_SIZE - 1) % QUEUE_SIZE);
+
+		progress_submit();
+
+		if (full) alloc_submit();
+	}
 };
 
 
@@ -278,8 +405,8 @@ class Audio_out::Mixer
 		{
 			if (session->stopped()) return;
 
-			Stream *stream  = session->stream();
-			bool const full = stream->full();
+			Stream *stream  = session->mix_stream();
+			bool const full = session->stream()->full();
 
 			/* mark packets as played and icrement position pointer */
 			while (stream->pos() != pos) {
@@ -417,12 +544,24 @@ class Audio_out::Mixer
 			});
 		}
 
+		/*
+		 * Convert the packets of all sessions that require sample-rate
+		 * conversion
+		 */
+		void _convert()
+		{
+			_for_each_channel([&] (Channel::Number, Session_channel *sc) {
+				sc->for_each_session([&] (Session_elem &session) {
+					session.convert(); }); });
+		}
+
 		/**
 		 * Handle progress signals from Audio_out session and data available signals
 		 * from each mixer client
 		 */
 		void _handle()
 		{
+			_convert();
 			_advance_position();
 			_mix();
 		}
@@ -646,8 +785,9 @@ class Audio_out::Session_component : public Audio_out::Session_elem
 		Session_component(Genode::Env     &env,
 		                  char const      *label,
 		                  Channel::Number  number,
+		                  unsigned         sample_rate,
 		                  Mixer           &mixer)
-		: Session_elem(env, label, mixer.sig_cap()), _mixer(mixer)
+		: Session_elem(env, label, mixer.sig_cap(), sample_rate), _mixer(mixer)
 		{
 			Session_elem::number = number;
 			_mixer.add_session(Session_elem::number, *this);
@@ -662,7 +802,7 @@ class Audio_out::Session_component : public Audio_out::Session_elem
 		void start()
 		{
 			Session_rpc_object::start();
-			stream()->pos(_mixer.pos(Session_elem::number));
+			position(_mixer.pos(Session_elem::number));
 			_mixer.report_channels();
 		}
 
@@ -706,12 +846,22 @@ class Audio_out::Root : public Audio_out::Root_component
 			size_t ram_quota =
 				Arg_string::find_arg(args, "ram_quota").ulong_value(0);
 
+			unsigned const sample_rate =
+				Arg_string::find_arg(args, "sample_rate").ulong_value(SAMPLE_RATE);
+
+			if (!valid_sample_rate(sample_rate)) {
+				Genode::error("invalid sample rate ", sample_rate, " requested");
+				throw Genode::Service_denied();
+			}
+
 			size_t session_size = align_addr(sizeof(Session_component), 12);
+			size_t stream_size  = sizeof(Stream)
+			                    + Session_elem::conversion_size(sample_rate);
 
 			if ((ram_quota < session_size) ||
-			    (sizeof(Stream) > ram_quota - session_size)) {
+			    (stream_size > ram_quota - session_size)) {
 				Genode::error("insufficient 'ram_quota', got ", ram_quota, ", "
-				              "need ", sizeof(Stream) + session_size);
+				              "need ", stream_size + session_size);
 				throw Insufficient_ram_quota();
 			}
 
@@ -720,7 +870,8 @@ class Audio_out::Root : public Audio_out::Root_component
 				throw Genode::Service_denied();
 
 			Session_component *session = new (md_alloc())
-				Session_component(_env, label.string(), (Channel::Number)ch, _mixer);
+				Session_component(_env, label.string(), (Channel::Number)ch,
+				                  sample_rate, _mixer);
 
 			if (++_sessions == 1) _mixer.start();
 			return session;
@@ -0,0 +1,237 @@
+/*
+ * \brief  Sample-rate converter used by the mixer
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The resampler implements a polyphase windowed-sinc filter. The filter
+ * coefficients are computed once per stream for a fixed number of phases.
+ * For each output sample, the two phases adjacent to the fractional input
+ * position are applied and the results are interpolated linearly. The inner
+ * loops operate on contiguous arrays of a compile-time constant length, which
+ * allows the compiler to vectorize them.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _MIXER__RESAMPLER_H_
+#define _MIXER__RESAMPLER_H_
+
+/* Genode includes */
+#include <audio_out_session/audio_out_session.h>
+#include <util/string.h>
+
+namespace Audio_out { class Resampler; }
+
+
+class Audio_out::Resampler
+{
+	public:
+
+		enum {
+			TAPS       = 32,  /* filter length per phase */
+			PHASE_BITS = 7,
+			PHASES     = 1 << PHASE_BITS,
+		};
+
+	private:
+
+		typedef Genode::uint64_t uint64_t;
+		typedef Genode::uint32_t uint32_t;
+
+		enum {
+			FRAC_BITS  = 32,
+			INTERP_BITS = FRAC_BITS - PHASE_BITS,
+		};
+
+		unsigned const _in_rate;
+		unsigned const _out_rate;
+
+		/* step width in input samples per output sample, 32.32 fixed point */
+		uint64_t const _step = ((uint64_t)_in_rate << FRAC_BITS) / _out_rate;
+
+		/* read position within '_in', 32.32 fixed point */
+		uint64_t _pos = 0;
+
+		/* filter coefficients, one additional phase for interpolation */
+		float _coeff[PHASES + 1][TAPS];
+
+		/* filter history followed by not yet consumed input samples */
+		float    _in[TAPS + PERIOD];
+		unsigned _in_fill = TAPS - 1;
+
+		/* output packet under construction */
+		float    _out[PERIOD];
+		unsigned _out_fill = 0;
+
+		static constexpr double PI = 3.14159265358979323846;
+
+		/**
+		 * Sine approximation
+		 *
+		 * The argument is reduced to [-pi, pi] and the Taylor series is
+		 * evaluated up to the 17th order, which is accurate to well below
+		 * the resolution of 'float'.
+		 */
+		static double _sin(double x)
+		{
+			double const two_pi = 2*PI;
+
+			long const n = (long)(x / two_pi + (x < 0 ? -0.5 : 0.5));
+			x -= (double)n * two_pi;
+
+			double const x2 = x*x;
+			double term = x, sum = x;
+			for (int i = 1; i <= 8; i++) {
+				term *= -x2 / ((2*i) * (2*i + 1));
+				sum  += term;
+			}
+			return sum;
+		}
+
+		static double _cos(double x) { return _sin(x + PI/2); }
+
+		/**
+		 * Windowed sinc at distance 'd' from the filter center
+		 *
+		 * \param cutoff  cutoff frequency relative to the input Nyquist
+		 *                frequency
+		 */
+		static double _kernel(double d, double cutoff)
+		{
+			double const half = TAPS/2;
+
+			if (d <= -half || d >= half)
+				return 0;
+
+			/* Blackman window */
+			double const w = 0.42 + 0.5*_cos(PI*d/half) + 0.08*_cos(2*PI*d/half);
+
+			double const x = PI*cutoff*d;
+			double const sinc = (x > -1e-9 && x < 1e-9) ? 1.0 : _sin(x)/x;
+
+			return cutoff*sinc*w;
+		}
+
+		void _init_coefficients()
+		{
+			/* lower the cutoff frequency when downsampling to avoid aliasing */
+			double const cutoff = _out_rate < _in_rate
+			                    ? 0.97 * (double)_out_rate / _in_rate : 0.97;
+
+			for (unsigned p = 0; p <= PHASES; p++) {
+
+				double const frac = (double)p / PHASES;
+
+				double sum = 0;
+				for (unsigned k = 0; k < TAPS; k++) {
+					double const c = _kernel((double)k - (TAPS/2 - 1) - frac, cutoff);
+					_coeff[p][k] = (float)c;
+					sum += c;
+				}
+
+				/* normalize DC gain of each phase to 1 */
+				for (unsigned k = 0; k < TAPS; k++)
+					_coeff[p][k] = (float)(_coeff[p][k] / sum);
+			}
+		}
+
+		/*
+		 * The products are accumulated in 'LANES' independent partial sums
+		 * so that the compiler is free to map the loop to SIMD registers
+		 * without reassociating floating-point operations.
+		 */
+		enum { LANES = 8 };
+
+		static float _dot(float const * __restrict__ in,
+		                  float const * __restrict__ coeff)
+		{
+			float sum[LANES] { };
+			for (unsigned k = 0; k < TAPS; k += LANES)
+				for (unsigned j = 0; j < LANES; j++)
+					sum[j] += in[k + j] * coeff[k + j];
+
+			float result = 0;
+			for (unsigned j = 0; j < LANES; j++)
+				result += sum[j];
+			return result;
+		}
+
+	public:
+
+		Resampler(unsigned in_rate, unsigned out_rate)
+		: _in_rate(in_rate), _out_rate(out_rate)
+		{
+			Genode::memset(_in, 0, sizeof(_in));
+			_init_coefficients();
+		}
+
+		unsigned in_rate()  const { return _in_rate; }
+		unsigned out_rate() const { return _out_rate; }
+
+		/**
+		 * Maximum number of output periods completed by one input period
+		 */
+		unsigned max_output_periods() const {
+			return (_out_rate + _in_rate - 1) / _in_rate + 1; }
+
+		/**
+		 * Feed one period of input samples
+		 *
+		 * \param in  'PERIOD' samples at the input rate
+		 * \param fn  functor called with a pointer to 'PERIOD' samples at
+		 *            the output rate whenever an output period is complete
+		 */
+		template <typename FN>
+		void process(float const *in, FN const &fn)
+		{
+			Genode::memcpy(&_in[_in_fill], in, PERIOD * SAMPLE_SIZE);
+			_in_fill += PERIOD;
+
+			for (;;) {
+				unsigned const idx = (unsigned)(_pos >> FRAC_BITS);
+				if (idx + TAPS > _in_fill)
+					break;
+
+				uint32_t const frac  = (uint32_t)_pos;
+				unsigned const phase = frac >> INTERP_BITS;
+				float    const t     = (float)(frac & ((1U << INTERP_BITS) - 1))
+				                     / (float)(1U << INTERP_BITS);
+
+				float const a = _dot(&_in[idx], _coeff[phase]);
+				float const b = _dot(&_in[idx], _coeff[phase + 1]);
+
+				_out[_out_fill++] = a + (b - a)*t;
+
+				if (_out_fill == PERIOD) {
+					fn(_out);
+					_out_fill = 0;
+				}
+
+				_pos += _step;
+			}
+
+			/* drop consumed samples but keep the filter history */
+			unsigned const consumed = (unsigned)(_pos >> FRAC_BITS);
+			Genode::memmove(_in, &_in[consumed], (_in_fill - consumed) * SAMPLE_SIZE);
+			_in_fill -= consumed;
+			_pos     -= (uint64_t)consumed << FRAC_BITS;
+		}
+
+		/**
+		 * Discard buffered samples, e.g., when the stream was stopped
+		 */
+		void reset()
+		{
+			Genode::memset(_in, 0, sizeof(_in));
+			_in_fill  = TAPS - 1;
+			_out_fill = 0;
+			_pos      = 0;
+		}
+};
+
+#endif /* _MIXER__RESAMPLER_H_ */
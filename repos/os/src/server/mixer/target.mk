@@ -1,3 +1,6 @@
 TARGET = mixer
 SRC_CC = mixer.cc
 LIBS = base
+
+# let the compiler vectorize the inner loops of the resampler
+CC_OPT_mixer += -ftree-vectorize
@@ -246,6 +246,7 @@ void Domain::report(Xml_generator &xml)
 		if (bytes) {
 			xml.attribute("rx_bytes", _tx_bytes);
 			xml.attribute("tx_bytes", _rx_bytes);
+			xml.attribute("tx_dropped", _tx_dropped);
 		}
 		if (config) {
 			xml.attribute("ipv4", String<19>(ip_config().interface));
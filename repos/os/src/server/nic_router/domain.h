@@ -104,6 +104,7 @@ class Net::Domain : public Domain_base
 		Link_side_tree                        _udp_links           { };
 		Genode::size_t                        _tx_bytes            { 0 };
 		Genode::size_t                        _rx_bytes            { 0 };
+		Genode::size_t                        _tx_dropped          { 0 };
 
 		void _read_forward_rules(Genode::Cstring  const &protocol,
 		                         Domain_tree            &domains,
@@ -150,6 +151,8 @@ class Net::Domain : public Domain_base
 
 		void raise_tx_bytes(Genode::size_t bytes) { _tx_bytes += bytes; }
 
+		void raise_tx_dropped() { _tx_dropped++; }
+
 		void report(Genode::Xml_generator &xml);
 
 
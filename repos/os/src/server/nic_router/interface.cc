@@ -932,6 +932,17 @@ void Interface::_handle_eth(void              *const  eth_base,
 
 void Interface::send(Ethernet_frame &eth, size_t eth_size)
 {
+	/*
+	 * The sessions of the router carry no offload meta data. So, a super
+	 * frame cannot be segmented at the egress interface and is dropped.
+	 */
+	if (eth_size > MAX_FRAME_SIZE) {
+		_domain.raise_tx_dropped();
+		if (_config().verbose()) {
+			log("(", _domain, " <- router) drop frame of ", eth_size,
+			    " bytes, exceeds MTU"); }
+		return;
+	}
 	send(eth_size, [&] (void *pkt_base) {
 		Genode::memcpy(pkt_base, (void *)&eth, eth_size);
 	});
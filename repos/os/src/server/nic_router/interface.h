@@ -63,6 +63,12 @@ class Net::Interface : private Genode::List<Interface>::Element
 
 	private:
 
+		/*
+		 * Largest frame without offload meta data, i.e., 1500 bytes of
+		 * payload plus Ethernet header and VLAN tag
+		 */
+		enum { MAX_FRAME_SIZE = 1518 };
+
 		Timer::Connection    &_timer;
 		Genode::Allocator    &_alloc;
 		Domain               &_domain;
@@ -52,6 +52,9 @@ Main::Main(Env &env)
 	_root(env.ep(), _timer, _heap, _uplink.router_mac(), _config,
 	      env.ram(), env.rm())
 {
+	/* links and ARP waiters are small and short-lived */
+	_heap.enable_size_classes();
+
 	env.parent().announce(env.ep().manage(_root));
 }
 
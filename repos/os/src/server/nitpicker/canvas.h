@@ -17,13 +17,53 @@
 #include <nitpicker_gfx/box_painter.h>
 #include <nitpicker_gfx/text_painter.h>
 #include <nitpicker_gfx/texture_painter.h>
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
 
 /* local includes */
 #include "types.h"
 
 namespace Nitpicker {
+
 	struct Canvas_base;
 	template <typename PT> class Canvas;
+
+	template <typename PT>
+	static inline void paint_texture(Surface<PT> &, Point, Texture_base const &,
+	                                 Surface_base::Pixel_format,
+	                                 Texture_painter::Mode, Color, bool);
+}
+
+
+/**
+ * Paint texture of the specified pixel format
+ *
+ * A texture of the surface's pixel type is blitted as is, a texture of
+ * another pixel type is converted pixel by pixel.
+ */
+template <typename PT>
+static inline void Nitpicker::paint_texture(Surface<PT> &surface, Point pos,
+                                            Texture_base const &texture,
+                                            Surface_base::Pixel_format format,
+                                            Texture_painter::Mode mode,
+                                            Color mix_color, bool allow_alpha)
+{
+	switch (format) {
+
+	case Surface_base::RGB565:
+		Texture_painter::paint(surface,
+		                       static_cast<Texture<Pixel_rgb565> const &>(texture),
+		                       mix_color, pos, mode, allow_alpha);
+		break;
+
+	case Surface_base::RGB888:
+		Texture_painter::paint(surface,
+		                       static_cast<Texture<Pixel_rgb888> const &>(texture),
+		                       mix_color, pos, mode, allow_alpha);
+		break;
+
+	default: break;
+	}
 }
 
 
@@ -34,6 +74,8 @@ struct Nitpicker::Canvas_base : Interface
 {
 	virtual Area size() const = 0;
 
+	virtual Surface_base::Pixel_format pixel_format() const = 0;
+
 	virtual Rect clip() const = 0;
 
 	virtual void clip(Rect) = 0;
@@ -42,7 +84,9 @@ struct Nitpicker::Canvas_base : Interface
 
 	virtual void draw_box(Rect, Color) = 0;
 
-	virtual void draw_texture(Point, Texture_base const &, Texture_painter::Mode,
+	virtual void draw_texture(Point, Texture_base const &,
+	                          Surface_base::Pixel_format,
+	                          Texture_painter::Mode,
 	                          Color mix_color, bool allow_alpha) = 0;
 
 	virtual void draw_text(Point, Text_painter::Font const &, Color,
@@ -74,6 +118,8 @@ class Nitpicker::Canvas : public Canvas_base, public Surface_base::Flusher
 
 		Area size() const { return _surface.size(); }
 
+		Surface_base::Pixel_format pixel_format() const { return PT::format(); }
+
 		Rect clip() const { return _surface.clip(); }
 
 		void clip(Rect rect) { _surface.clip(rect); }
@@ -83,13 +129,13 @@ class Nitpicker::Canvas : public Canvas_base, public Surface_base::Flusher
 			Box_painter::paint(_surface, rect, color);
 		}
 
-		void draw_texture(Point pos, Texture_base const &texture_base,
+		void draw_texture(Point pos, Texture_base const &texture,
+		                  Surface_base::Pixel_format format,
 		                  Texture_painter::Mode mode, Color mix_color,
 		                  bool allow_alpha)
 		{
-			Texture<PT> const &texture = static_cast<Texture<PT> const &>(texture_base);
-			Texture_painter::paint(_surface, texture, mix_color, pos, mode,
-			                       allow_alpha);
+			paint_texture(_surface, pos, texture, format, mode, mix_color,
+			              allow_alpha);
 		}
 
 		void draw_text(Point pos, Text_painter::Font const &font,
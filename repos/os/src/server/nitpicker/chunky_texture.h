@@ -25,8 +25,11 @@ class Nitpicker::Chunky_texture : public Buffer, public Texture<PT>
 {
 	private:
 
-		Framebuffer::Mode::Format _format() {
-			return Framebuffer::Mode::RGB565; }
+		static Framebuffer::Mode::Format _format()
+		{
+			return PT::format() == Surface_base::RGB888 ? Framebuffer::Mode::RGB888
+			                                            : Framebuffer::Mode::RGB565;
+		}
 
 		/**
 		 * Return base address of alpha channel or 0 if no alpha channel exists
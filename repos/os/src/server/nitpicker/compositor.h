@@ -0,0 +1,195 @@
+/*
+ * \brief  Tile-parallel composition of the view stack
+ * \author agent
+ * \date   2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _COMPOSITOR_H_
+#define _COMPOSITOR_H_
+
+/* Genode includes */
+#include <base/thread.h>
+#include <base/semaphore.h>
+#include <util/reconstructible.h>
+
+/* local includes */
+#include "canvas.h"
+
+namespace Nitpicker { class Compositor; }
+
+
+/**
+ * Distributor of the redraw work among a pool of worker threads
+ *
+ * The screen is divided into horizontal tiles of 'TILE_HEIGHT' pixel rows.
+ * Tile 'k' is painted by worker 'k % threads', where worker 0 is the
+ * caller of 'compose'. Each worker paints the parts of all dirty rectangles
+ * that fall into its tiles, in the order of the rectangles. Because each
+ * pixel is always painted by the same worker in the same order as by a
+ * single thread, the output does not depend on the number of workers.
+ *
+ * Each worker uses its own canvas because the clipping state of a canvas
+ * is modified while drawing.
+ */
+class Nitpicker::Compositor
+{
+	public:
+
+		enum { MAX_THREADS = 8, TILE_HEIGHT = 64, MAX_RECTS = 8 };
+
+		/**
+		 * Interface for painting a screen area
+		 *
+		 * The implementation must not modify any state shared among the
+		 * workers.
+		 */
+		struct Painter : Genode::Interface
+		{
+			virtual void paint(Canvas_base &, Rect) const = 0;
+		};
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Compositor(Compositor const &);
+		Compositor &operator = (Compositor const &);
+
+		class Worker : public Genode::Thread
+		{
+			private:
+
+				Compositor        &_compositor;
+				unsigned     const _index;
+				Genode::Semaphore  _start { };
+
+				void entry() override
+				{
+					for (;;) {
+						_start.down();
+						_compositor._compose_share(_index);
+						_compositor._done.up();
+					}
+				}
+
+			public:
+
+				enum { STACK_SIZE = 16*1024*sizeof(long) };
+
+				Worker(Genode::Env &env, Compositor &compositor, unsigned index,
+				       Genode::Affinity::Location location)
+				:
+					Genode::Thread(env, "compositor", STACK_SIZE, location,
+					               Weight(), env.cpu()),
+					_compositor(compositor), _index(index)
+				{ }
+
+				void wake_up() { _start.up(); }
+		};
+
+		unsigned const _threads;
+
+		Genode::Constructible<Worker> _workers[MAX_THREADS];
+
+		Genode::Semaphore _done { };
+
+		/*
+		 * Current job, valid during 'compose'
+		 */
+		Painter     const *_painter  = nullptr;
+		Canvas_base      **_canvases = nullptr;
+		Rect               _rects[MAX_RECTS];
+		unsigned           _num_rects = 0;
+
+		void _compose_share(unsigned index)
+		{
+			Canvas_base &canvas = *_canvases[index];
+
+			for (unsigned i = 0; i < _num_rects; i++) {
+
+				Rect const &rect = _rects[i];
+
+				int const first = rect.y1() / TILE_HEIGHT,
+				          last  = rect.y2() / TILE_HEIGHT;
+
+				for (int k = first; k <= last; k++) {
+
+					if ((unsigned)k % _threads != index)
+						continue;
+
+					Rect const tile(Point(rect.x1(), k*TILE_HEIGHT),
+					                Area(rect.w(), TILE_HEIGHT));
+
+					Rect const clipped = Rect::intersect(rect, tile);
+					if (clipped.valid())
+						_painter->paint(canvas, clipped);
+				}
+			}
+		}
+
+		static unsigned _clamped(unsigned threads) {
+			return Genode::max(1U, Genode::min(threads, (unsigned)MAX_THREADS)); }
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param threads  number of threads painting in parallel, including
+		 *                 the caller of 'compose'
+		 */
+		Compositor(Genode::Env &env, unsigned threads)
+		: _threads(_clamped(threads))
+		{
+			Genode::Affinity::Space space = env.cpu().affinity_space();
+
+			for (unsigned i = 1; i < _threads; i++) {
+				_workers[i].construct(env, *this, i, space.location_of_index(i));
+				_workers[i]->start();
+			}
+		}
+
+		unsigned threads() const { return _threads; }
+
+		/**
+		 * Paint rectangles
+		 *
+		 * \param canvases  one canvas per thread, all referring to the screen
+		 * \param rects     rectangles to paint, in painting order
+		 */
+		void compose(Painter const &painter, Canvas_base **canvases,
+		             Rect const *rects, unsigned num_rects)
+		{
+			_painter   = &painter;
+			_canvases  = canvases;
+			_num_rects = 0;
+
+			for (unsigned i = 0; i < num_rects; i++) {
+				if (_num_rects < MAX_RECTS)
+					_rects[_num_rects++] = rects[i];
+				else
+					_rects[MAX_RECTS - 1] = Rect::compound(_rects[MAX_RECTS - 1], rects[i]);
+			}
+
+			if (_num_rects == 0)
+				return;
+
+			for (unsigned i = 1; i < _threads; i++)
+				_workers[i]->wake_up();
+
+			_compose_share(0);
+
+			for (unsigned i = 1; i < _threads; i++)
+				_done.down();
+		}
+};
+
+#endif /* _COMPOSITOR_H_ */
@@ -21,6 +21,7 @@
 #include <root/component.h>
 #include <input_session/connection.h>
 #include <framebuffer_session/connection.h>
+#include <framebuffer_session/damage_ring.h>
 #include <os/session_policy.h>
 
 /* local includes */
@@ -35,7 +36,7 @@ namespace Nitpicker {
 
 	struct Focus_updater : Interface { virtual void update_focus() = 0; };
 
-	template <typename> class Root;
+	class Root;
 	struct Main;
 }
 
@@ -68,7 +69,6 @@ void Framebuffer::Session_component::refresh(int x, int y, int w, int h)
  ** Implementation of Nitpicker service **
  *****************************************/
 
-template <typename PT>
 class Nitpicker::Root : public Root_component<Session_component>,
                         public Visibility_controller
 {
@@ -197,12 +197,13 @@ struct Nitpicker::Main : Focus_updater
 
 	Framebuffer::Connection _framebuffer { _env, Framebuffer::Mode() };
 
+	/* dirty regions are reported to the driver with one signal per redraw */
+	Framebuffer::Damage_submitter _damage { _env.rm(), _framebuffer };
+
 	Input::Connection _input { _env };
 
 	Attached_dataspace _ev_ds { _env.rm(), _input.dataspace() };
 
-	typedef Pixel_rgb565 PT;  /* physical pixel type */
-
 	/*
 	 * Initialize framebuffer
 	 *
@@ -211,13 +212,54 @@ struct Nitpicker::Main : Focus_updater
 	 */
 	struct Framebuffer_screen
 	{
+		/*
+		 * Noncopyable
+		 */
+		Framebuffer_screen(Framebuffer_screen const &);
+		Framebuffer_screen &operator = (Framebuffer_screen const &);
+
 		Framebuffer::Session &framebuffer;
 
 		Framebuffer::Mode const mode = framebuffer.mode();
 
 		Attached_dataspace fb_ds;
 
-		Canvas<PT> screen = { fb_ds.local_addr<PT>(), Area(mode.width(), mode.height()) };
+		/*
+		 * Canvases matching the pixel format of the framebuffer, client
+		 * textures of the same format are blitted without conversion
+		 *
+		 * Each compositor thread draws via a canvas of its own.
+		 */
+		enum { MAX_CANVASES = Compositor::MAX_THREADS };
+
+		Constructible<Canvas<Pixel_rgb565> > _canvas_rgb565[MAX_CANVASES];
+		Constructible<Canvas<Pixel_rgb888> > _canvas_rgb888[MAX_CANVASES];
+
+		Canvas_base *canvases[MAX_CANVASES] { };
+
+		template <typename PT>
+		Canvas_base &_construct(Constructible<Canvas<PT> > *canvas)
+		{
+			for (unsigned i = 0; i < MAX_CANVASES; i++) {
+				canvas[i].construct(fb_ds.local_addr<PT>(),
+				                    Area(mode.width(), mode.height()));
+				canvases[i] = &*canvas[i];
+			}
+			return *canvases[0];
+		}
+
+		Canvas_base &_init_screen()
+		{
+			if (mode.format() == Framebuffer::Mode::RGB888)
+				return _construct(_canvas_rgb888);
+
+			if (mode.format() != Framebuffer::Mode::RGB565)
+				warning("unsupported framebuffer mode ", mode, ", assuming RGB565");
+
+			return _construct(_canvas_rgb565);
+		}
+
+		Canvas_base &screen = _init_screen();
 
 		Area size = screen.size();
 
@@ -278,7 +320,18 @@ struct Nitpicker::Main : Focus_updater
 
 	Constructible<Attached_rom_dataspace> _focus_rom { };
 
-	Root<PT> _root = { _env, _config_rom, _session_list, *_domain_registry,
+	/*
+	 * The number of compositor threads is evaluated at startup only
+	 */
+	static unsigned _compositor_threads(Xml_node config)
+	{
+		return config.has_sub_node("compositor")
+		     ? config.sub_node("compositor").attribute_value("threads", 1U) : 1;
+	}
+
+	Compositor _compositor { _env, _compositor_threads(_config_rom.xml()) };
+
+	Root _root = { _env, _config_rom, _session_list, *_domain_registry,
 	                   _global_keys, _view_stack, _user_state, _pointer_origin,
 	                   _builtin_background, _sliced_heap, _framebuffer,
 	                   _focus_reporter, *this };
@@ -350,9 +403,10 @@ struct Nitpicker::Main : Focus_updater
 	 */
 	void _draw_and_flush()
 	{
-		_view_stack.draw(_fb_screen->screen).flush([&] (Rect const &rect) {
-			_framebuffer.refresh(rect.x1(), rect.y1(),
-			                     rect.w(),  rect.h()); });
+		_view_stack.draw(_compositor, _fb_screen->canvases).flush([&] (Rect const &rect) {
+			_damage.damage(rect.x1(), rect.y1(), rect.w(), rect.h()); });
+
+		_damage.flush();
 	}
 
 	Main(Env &env) : _env(env)
@@ -446,9 +500,7 @@ void Nitpicker::Main::_handle_input()
 		_view_stack.geometry(_pointer_origin, Rect(_user_state.pointer_pos(), Area()));
 
 	/* perform redraw and flush pixels to the framebuffer */
-	_view_stack.draw(_fb_screen->screen).flush([&] (Rect const &rect) {
-		_framebuffer.refresh(rect.x1(), rect.y1(),
-		                     rect.w(),  rect.h()); });
+	_draw_and_flush();
 
 	_view_stack.mark_all_views_as_clean();
 
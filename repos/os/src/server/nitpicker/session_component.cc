@@ -16,20 +16,32 @@
 using namespace Nitpicker;
 
 
+template <typename PT>
+void Session_component::_destroy_texture(Texture_base const *texture)
+{
+	Chunky_texture<PT> const *cdt = static_cast<Chunky_texture<PT> const *>(texture);
+
+	destroy(&_session_alloc, const_cast<Chunky_texture<PT> *>(cdt));
+}
+
+
 void Session_component::_release_buffer()
 {
 	if (!_texture)
 		return;
 
-	typedef Pixel_rgb565 PT;
-
-	Chunky_texture<PT> const *cdt = static_cast<Chunky_texture<PT> const *>(_texture);
+	Texture_base const * const texture = _texture;
 
 	_texture    = nullptr;
 	_uses_alpha = false;
 	_input_mask = nullptr;
 
-	destroy(&_session_alloc, const_cast<Chunky_texture<PT> *>(cdt));
+	if (_texture_format == Surface_base::RGB888)
+		_destroy_texture<Pixel_rgb888>(texture);
+	else
+		_destroy_texture<Pixel_rgb565>(texture);
+
+	_texture_format = Surface_base::UNKNOWN;
 
 	_session_alloc.upgrade(_buffer_size);
 	_buffer_size = 0;
@@ -386,13 +398,22 @@ Framebuffer::Mode Session_component::mode()
 
 	Area const session_area = screen_area(phys_area);
 
+	/*
+	 * The virtual framebuffer defaults to RGB565 independent from the
+	 * physical pixel format. RGB888 buffers must be requested explicitly.
+	 */
 	return Framebuffer::Mode(session_area.w(), session_area.h(),
-	                         _framebuffer.mode().format());
+	                         Framebuffer::Mode::RGB565);
 }
 
 
 void Session_component::buffer(Framebuffer::Mode mode, bool use_alpha)
 {
+	/* buffers of unspecified format use the default format */
+	if (mode.format() != Framebuffer::Mode::RGB888)
+		mode = Framebuffer::Mode(mode.width(), mode.height(),
+		                         Framebuffer::Mode::RGB565);
+
 	/* check if the session quota suffices for the specified mode */
 	if (_session_alloc.quota() < ram_quota(mode, use_alpha))
 		throw Out_of_ram();
@@ -434,8 +455,16 @@ void Session_component::session_control(Label suffix, Session_control control)
 
 Buffer *Session_component::realloc_buffer(Framebuffer::Mode mode, bool use_alpha)
 {
-	typedef Pixel_rgb565 PT;
+	if (mode.format() == Framebuffer::Mode::RGB888)
+		return _realloc_buffer<Pixel_rgb888>(mode, use_alpha);
 
+	return _realloc_buffer<Pixel_rgb565>(mode, use_alpha);
+}
+
+
+template <typename PT>
+Buffer *Session_component::_realloc_buffer(Framebuffer::Mode mode, bool use_alpha)
+{
 	Area const size(mode.width(), mode.height());
 
 	_buffer_size = Chunky_texture<PT>::calc_num_bytes(size, use_alpha);
@@ -444,12 +473,12 @@ Buffer *Session_component::realloc_buffer(Framebuffer::Mode mode, bool use_alpha
 	 * Preserve the content of the original buffer if nitpicker has
 	 * enough lack memory to temporarily keep the original pixels.
 	 */
-	Texture<PT> const *src_texture = nullptr;
+	Texture_base const *src_texture = nullptr;
 	if (texture()) {
 
 		enum { PRESERVED_RAM = 128*1024 };
 		if (_env.ram().avail_ram().value > _buffer_size + PRESERVED_RAM) {
-			src_texture = static_cast<Texture<PT> const *>(texture());
+			src_texture = texture();
 		} else {
 			warning("not enough RAM to preserve buffer content during resize");
 			_release_buffer();
@@ -465,8 +494,8 @@ Buffer *Session_component::realloc_buffer(Framebuffer::Mode mode, bool use_alpha
 		Surface<PT> surface(texture->pixel(),
 		                    texture->Texture_base::size());
 
-		Texture_painter::paint(surface, *src_texture, Color(), Point(0, 0),
-		                       Texture_painter::SOLID, false);
+		paint_texture(surface, Point(0, 0), *src_texture, _texture_format,
+		              Texture_painter::SOLID, Color(), false);
 		_release_buffer();
 	}
 
@@ -476,9 +505,10 @@ Buffer *Session_component::realloc_buffer(Framebuffer::Mode mode, bool use_alpha
 		return nullptr;
 	}
 
-	_texture    = texture;
-	_uses_alpha = use_alpha;
-	_input_mask = texture->input_mask_buffer();
+	_texture        = texture;
+	_texture_format = PT::format();
+	_uses_alpha     = use_alpha;
+	_input_mask     = texture->input_mask_buffer();
 
 	return texture;
 }
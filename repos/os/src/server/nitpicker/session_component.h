@@ -20,6 +20,7 @@
 #include <os/session_policy.h>
 #include <os/reporter.h>
 #include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
 #include <nitpicker_session/nitpicker_session.h>
 #include <base/allocator_guard.h>
 
@@ -73,6 +74,7 @@ class Nitpicker::Session_component : public  Rpc_object<Session>,
 
 		Domain_registry::Entry const *_domain     = nullptr;
 		Texture_base           const *_texture    = nullptr;
+		Surface_base::Pixel_format    _texture_format = Surface_base::UNKNOWN;
 		View_component               *_background = nullptr;
 
 		/*
@@ -146,6 +148,12 @@ class Nitpicker::Session_component : public  Rpc_object<Session>,
 
 		void _release_buffer();
 
+		template <typename PT>
+		void _destroy_texture(Texture_base const *);
+
+		template <typename PT>
+		Buffer *_realloc_buffer(Framebuffer::Mode, bool use_alpha);
+
 		/**
 		 * Helper for performing sanity checks in OP_TO_FRONT and OP_TO_BACK
 		 *
@@ -260,6 +268,9 @@ class Nitpicker::Session_component : public  Rpc_object<Session>,
 
 		Texture_base const *texture() const override { return _texture; }
 
+		Surface_base::Pixel_format texture_format() const override {
+			return _texture_format; }
+
 		bool uses_alpha() const override { return _texture && _uses_alpha; }
 
 		unsigned layer() const override { return _domain ? _domain->layer() : ~0UL; }
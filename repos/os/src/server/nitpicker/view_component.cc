@@ -128,8 +128,8 @@ void View_component::draw(Canvas_base &canvas, Focus const &focus) const
 
 	Texture_base const *texture = _owner.texture();
 	if (texture) {
-		canvas.draw_texture(_buffer_off + view_rect.p1(), *texture, op,
-		                    mix_color, allow_alpha);
+		canvas.draw_texture(_buffer_off + view_rect.p1(), *texture,
+		                    _owner.texture_format(), op, mix_color, allow_alpha);
 	} else {
 		canvas.draw_box(view_rect, black());
 	}
@@ -153,6 +153,23 @@ void View_component::apply_origin_policy(View_component &pointer_origin)
 }
 
 
+bool View_component::shows_buffer_as_is(Focus const &focus, Rect rect) const
+{
+	Texture_base const *texture = _owner.texture();
+
+	if (!texture || uses_alpha() || _owner.label_visible()
+	 || texture_painter_mode(focus, _owner) != Texture_painter::SOLID)
+		return false;
+
+	Rect const view_rect = abs_geometry();
+	Rect const visible   = Rect::intersect(view_rect,
+	                                       Rect(view_rect.p1() + _buffer_off,
+	                                            texture->size()));
+
+	return visible.contains(rect.p1()) && visible.contains(rect.p2());
+}
+
+
 bool View_component::input_response_at(Point p) const
 {
 	Rect const view_rect = abs_geometry();
@@ -261,6 +261,14 @@ class Nitpicker::View_component : private Same_buffer_list_elem,
 		bool  background()  const { return _background; }
 		Rect  label_rect()  const { return _label_rect; }
 		bool  uses_alpha()  const;
+
+		/**
+		 * Return true if the view shows the client buffer unmodified in 'rect'
+		 *
+		 * This is the case if the buffer is opaque, covers 'rect', and is
+		 * neither tinted nor labeled.
+		 */
+		bool shows_buffer_as_is(Focus const &, Rect rect) const;
 		Point buffer_off()  const { return _buffer_off; }
 
 		template <typename FN>
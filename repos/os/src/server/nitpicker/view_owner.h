@@ -82,6 +82,12 @@ struct Nitpicker::View_owner : Interface
 	 */
 	virtual Texture_base const *texture() const { return nullptr; }
 
+	/**
+	 * Return pixel format of the texture
+	 */
+	virtual Surface_base::Pixel_format texture_format() const {
+		return Surface_base::UNKNOWN; }
+
 	/**
 	 * Return input-mask value at given position
 	 */
@@ -52,6 +52,33 @@ Nitpicker::Rect View_stack::_outline(View_component const &view) const
 }
 
 
+bool View_stack::_scan_out_view(Surface_base::Pixel_format format,
+                               Scan_out &scan_out) const
+{
+	Rect const screen(Point(0, 0), _size);
+
+	for (View_component const *view = _first_view(); view; view = _next_view(*view)) {
+
+		/* skip views without content on screen */
+		if (!Rect::intersect(_outline(*view), screen).valid())
+			continue;
+
+		if (view->owner().texture_format() == format
+		 && view->shows_buffer_as_is(_focus, screen)) {
+			scan_out.view = view;
+			return true;
+		}
+
+		/* view in front of the scan-out candidate, e.g., the pointer */
+		if (scan_out.num_overlays == MAX_OVERLAYS)
+			return false;
+
+		scan_out.overlays[scan_out.num_overlays++] = view;
+	}
+	return false;
+}
+
+
 View_component const *View_stack::_target_stack_position(View_component const *neighbor, bool behind)
 {
 	if (behind) {
@@ -17,6 +17,8 @@
 #include "view_component.h"
 #include "session_component.h"
 #include "canvas.h"
+#include "compositor.h"
+#include "clip_guard.h"
 
 namespace Nitpicker { class View_stack; }
 
@@ -40,6 +42,30 @@ class Nitpicker::View_stack
 		 */
 		Rect _outline(View_component const &view) const;
 
+		enum { MAX_OVERLAYS = 2 };
+
+		/**
+		 * View that covers the whole screen with opaque content along with
+		 * the views in front of it, e.g., the pointer
+		 */
+		struct Scan_out
+		{
+			View_component const *view = nullptr;
+			View_component const *overlays[MAX_OVERLAYS] { };
+			unsigned              num_overlays = 0;
+		};
+
+		/**
+		 * Find view that can be copied to the screen as is
+		 *
+		 * \param format  pixel format of the screen
+		 *
+		 * \return false if no view covers the whole screen with untransformed
+		 *         content, or if more than 'MAX_OVERLAYS' views are in front
+		 *         of it
+		 */
+		bool _scan_out_view(Surface_base::Pixel_format format, Scan_out &) const;
+
 		/**
 		 * Return top-most view of the view stack
 		 */
@@ -130,6 +156,73 @@ class Nitpicker::View_stack
 			return result;
 		}
 
+		/**
+		 * Draw dirty areas using the threads of the compositor
+		 *
+		 * \param canvases  one canvas per compositor thread
+		 */
+		Dirty_rect draw(Compositor &compositor, Canvas_base **canvases) const
+		{
+			Dirty_rect result = _dirty_rect;
+
+			Rect     rects[Compositor::MAX_RECTS];
+			unsigned num_rects = 0;
+			_dirty_rect.flush([&] (Rect const &rect) {
+				if (num_rects < Compositor::MAX_RECTS)
+					rects[num_rects++] = rect; });
+
+			struct Stack_painter : Compositor::Painter
+			{
+				View_stack const &stack;
+
+				Stack_painter(View_stack const &stack) : stack(stack) { }
+
+				void paint(Canvas_base &canvas, Rect rect) const override {
+					stack.draw_rec(canvas, stack._first_view(), rect); }
+			};
+
+			/*
+			 * Copy the content of a view that hides all others directly,
+			 * bypassing the traversal of the view stack, and draw the few
+			 * views in front of it on top, from bottom to top
+			 */
+			struct Scan_out_painter : Compositor::Painter
+			{
+				View_stack const &stack;
+				Scan_out   const &scan_out;
+
+				Scan_out_painter(View_stack const &stack, Scan_out const &scan_out)
+				: stack(stack), scan_out(scan_out) { }
+
+				void paint(Canvas_base &canvas, Rect rect) const override
+				{
+					Clip_guard clip_guard(canvas, rect);
+
+					scan_out.view->draw(canvas, stack._focus);
+
+					for (unsigned i = scan_out.num_overlays; i--; ) {
+						View_component const &view = *scan_out.overlays[i];
+
+						if (!Rect::intersect(stack._outline(view), rect).valid())
+							continue;
+
+						view.frame(canvas, stack._focus);
+						view.draw(canvas, stack._focus);
+					}
+				}
+			};
+
+			Scan_out scan_out { };
+
+			if (_scan_out_view(canvases[0]->pixel_format(), scan_out))
+				compositor.compose(Scan_out_painter(*this, scan_out),
+				                   canvases, rects, num_rects);
+			else
+				compositor.compose(Stack_painter(*this), canvases, rects, num_rects);
+
+			return result;
+		}
+
 		/**
 		 * Trigger redraw of the whole view stack
 		 */
@@ -17,8 +17,11 @@
 #include <base/exception.h>
 #include <base/component.h>
 #include <os/session_policy.h>
+#include <region_map/client.h>
+#include <rm_session/connection.h>
 #include <root/component.h>
 #include <block_session/rpc_object.h>
+#include <util/retry.h>
 
 #include "gpt.h"
 
@@ -26,8 +29,25 @@ namespace Block {
 
 	using namespace Genode;
 
-	class Session_component;
-	class Root;
+	struct Session_buffer;
+	class  Session_component;
+	class  Root;
+};
+
+
+/**
+ * Communication buffer of a session
+ *
+ * In zero-copy mode, the buffer is a managed dataspace. The pages holding
+ * the packet queues are backed by RAM, the remaining pages by a window of
+ * the backend session's bulk buffer.
+ */
+struct Block::Session_buffer
+{
+	Ram_dataspace_capability  ram    { }; /* whole buffer or queue pages */
+	Capability<Region_map>    rm     { }; /* valid in zero-copy mode     */
+	Dataspace_capability      ds     { }; /* buffer handed to the client */
+	Block::Driver::Window    *window { nullptr };
 };
 
 
@@ -45,8 +65,7 @@ class Block::Session_component : public  Block::Session_rpc_object,
 		Session_component(Session_component const &);
 		Session_component &operator = (Session_component const &);
 
-		Ram_dataspace_capability          _rq_ds;
-		addr_t                            _rq_phys;
+		Session_buffer                    _buffer;
 		Partition                        *_partition;
 		Signal_handler<Session_component> _sink_ack;
 		Signal_handler<Session_component> _sink_submit;
@@ -57,6 +76,13 @@ class Block::Session_component : public  Block::Session_rpc_object,
 		Block::Driver                    &_driver;
 		bool                              _writeable;
 
+		/*
+		 * A 'SYNC' request for a backend without 'SYNC' support is deferred
+		 * until all preceding requests of the session are acknowledged.
+		 * Meanwhile, no subsequent request is handled.
+		 */
+		bool                              _sync_deferred = false;
+
 		/**
 		 * Acknowledge a packet already handled
 		 */
@@ -72,8 +98,29 @@ class Block::Session_component : public  Block::Session_rpc_object,
 		/**
 		 * Range check packet request
 		 */
-		inline bool _range_check(Packet_descriptor &p) {
-			return p.block_number() + p.block_count() <= _partition->sectors; }
+		inline bool _range_check(Packet_descriptor &p)
+		{
+			if (p.operation() == Packet_descriptor::SYNC && !p.block_count())
+				return p.block_number() < _partition->sectors;
+
+			return p.block_number() + p.block_count() <= _partition->sectors;
+		}
+
+		/**
+		 * Return true if the backend device does not process 'SYNC' requests
+		 */
+		bool _sync_unsupported() const {
+			return !_driver.ops().supported(Packet_descriptor::SYNC); }
+
+		/**
+		 * Complete 'SYNC' request via the blocking RPC of the backend
+		 */
+		void _sync_backend(Packet_descriptor &packet)
+		{
+			_driver.session().sync();
+			packet.succeeded(true);
+			_ack_packet(packet);
+		}
 
 		/**
 		 * Handle a single request
@@ -83,24 +130,45 @@ class Block::Session_component : public  Block::Session_rpc_object,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
-			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
+			/* ignore invalid packets, only 'SYNC' and 'TRIM' carry no data */
+			if ((!packet.size() && !packet.barrier())
+			 || !_range_check(_p_to_handle)) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
-			bool write   = _p_to_handle.operation() == Packet_descriptor::WRITE;
+			Packet_descriptor::Opcode const op = _p_to_handle.operation();
+
+			bool write   = op == Packet_descriptor::WRITE;
 			sector_t off = _p_to_handle.block_number() + _partition->lba;
 			size_t cnt   = _p_to_handle.block_count();
 			void* addr   = tx_sink()->packet_content(_p_to_handle);
 
-			if (write && !_writeable) {
+			if ((write || packet.barrier()) && !_writeable) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
+			/* a 'SYNC' of zero blocks extends to the end of the partition */
+			if (op == Packet_descriptor::SYNC && cnt == 0)
+				cnt = _partition->sectors - _p_to_handle.block_number();
+
+			/*
+			 * Fall back to the blocking RPC of a backend without 'SYNC'. The
+			 * RPC covers only requests already acknowledged by the backend.
+			 * '_p_in_fly' does not yet account for the current packet.
+			 */
+			if (op == Packet_descriptor::SYNC && _sync_unsupported()) {
+				if (_p_in_fly)
+					_sync_deferred = true;
+				else
+					_sync_backend(_p_to_handle);
+				return;
+			}
+
 			try {
-				_driver.io(write, off, cnt, addr, *this, _p_to_handle);
+				_driver.io(op, off, cnt, addr, *this, _p_to_handle,
+				           _buffer.window);
 			} catch (Block::Session::Tx::Source::Packet_alloc_failed) {
 				if (!_req_queue_full) {
 					_req_queue_full = true;
@@ -121,7 +189,8 @@ class Block::Session_component : public  Block::Session_rpc_object,
 			 * them, and the driver's request queue isn't full,
 			 * direct the packet request to the driver backend
 			 */
-			for (; !_req_queue_full && tx_sink()->packet_avail() &&
+			for (; !_req_queue_full && !_sync_deferred &&
+			       tx_sink()->packet_avail() &&
 					 !_ack_queue_full; _p_in_fly++,
 					 _ack_queue_full = _p_in_fly >= tx_sink()->ack_slots_free())
 					_handle_packet(tx_sink()->get_packet());
@@ -137,15 +206,14 @@ class Block::Session_component : public  Block::Session_rpc_object,
 		/**
 		 * Constructor
 		 */
-		Session_component(Ram_dataspace_capability  rq_ds,
+		Session_component(Session_buffer            buffer,
 		                  Partition                *partition,
 		                  Genode::Entrypoint       &ep,
 		                  Genode::Region_map       &rm,
 		                  Block::Driver            &driver,
 		                  bool                      writeable)
-		: Session_rpc_object(rm, rq_ds, ep.rpc_ep()),
-		  _rq_ds(rq_ds),
-		  _rq_phys(Dataspace_client(_rq_ds).phys_addr()),
+		: Session_rpc_object(rm, buffer.ds, ep.rpc_ep()),
+		  _buffer(buffer),
 		  _partition(partition),
 		  _sink_ack(ep, *this, &Session_component::_ready_to_ack),
 		  _sink_submit(ep, *this, &Session_component::_packet_avail),
@@ -167,12 +235,14 @@ class Block::Session_component : public  Block::Session_rpc_object,
 				wait_queue().remove(this);
 		}
 
-		Ram_dataspace_capability const rq_ds() const { return _rq_ds; }
+		Session_buffer const &buffer() const { return _buffer; }
 		Partition *partition() { return _partition; }
 
 		void dispatch(Packet_descriptor &request, Packet_descriptor &reply)
 		{
-			if (request.operation() == Block::Packet_descriptor::READ) {
+			bool const shared = _buffer.window && _buffer.window->contains(request);
+
+			if (request.operation() == Block::Packet_descriptor::READ && !shared) {
 				void *src =
 					_driver.session().tx()->packet_content(reply);
 				Genode::size_t sz =
@@ -182,7 +252,14 @@ class Block::Session_component : public  Block::Session_rpc_object,
 			request.succeeded(reply.succeeded());
 			_ack_packet(request);
 
-			if (_ack_queue_full)
+			/* issue the deferred 'SYNC' once it is the only pending request */
+			bool const sync_issued = _sync_deferred && _p_in_fly == 1;
+			if (sync_issued) {
+				_sync_deferred = false;
+				_sync_backend(_p_to_handle);
+			}
+
+			if (_ack_queue_full || sync_issued)
 				_packet_avail();
 		}
 
@@ -222,6 +299,10 @@ class Block::Session_component : public  Block::Session_rpc_object,
 				ops->set_operation(Opcode::READ);
 			if (_writeable && driver_ops.supported(Opcode::WRITE))
 				ops->set_operation(Opcode::WRITE);
+			if (_writeable)
+				ops->set_operation(Opcode::SYNC);
+			if (_writeable && driver_ops.supported(Opcode::TRIM))
+				ops->set_operation(Opcode::TRIM);
 		}
 
 		void sync() { _driver.session().sync(); }
@@ -241,13 +322,88 @@ class Block::Root :
 		Block::Driver          &_driver;
 		Block::Partition_table &_table;
 
+		Constructible<Rm_connection> _rm { };
+
+		void _free_buffer(Session_buffer const &buffer)
+		{
+			if (buffer.rm.valid())
+				_rm->destroy(buffer.rm);
+			if (buffer.ram.valid())
+				_env.ram().free(buffer.ram);
+			if (buffer.window)
+				_driver.release_window(*buffer.window);
+		}
+
+		/**
+		 * Map the client's bulk buffer onto a window of the backend buffer
+		 */
+		Session_buffer _alloc_shared_buffer(size_t size)
+		{
+			enum { PAGE_SIZE_LOG2 = 12 };
+
+			size_t const bulk_offset  = sizeof(Session::Tx_policy::Submit_queue)
+			                          + sizeof(Session::Tx_policy::Ack_queue);
+			size_t const ds_size      = align_addr(size, PAGE_SIZE_LOG2);
+			size_t const private_size = align_addr(bulk_offset, PAGE_SIZE_LOG2);
+
+			Session_buffer buffer;
+			if (ds_size <= private_size)
+				return buffer;
+
+			buffer.window = _driver.alloc_window(private_size, ds_size);
+			if (!buffer.window) {
+				warning("backend buffer exhausted, session buffer is not shared");
+				return buffer;
+			}
+
+			try {
+				buffer.ram = _env.ram().alloc(private_size);
+
+				retry<Out_of_ram>(
+					[&] () { buffer.rm = _rm->create(ds_size); },
+					[&] () { _rm->upgrade_ram(8*1024); });
+
+				Region_map_client rm(buffer.rm);
+				off_t const window_offset =
+					buffer.window->backend_offset(private_size);
+
+				retry<Out_of_ram>(
+					[&] () {
+						rm.attach_at(buffer.ram, 0);
+						rm.attach_at(_driver.dataspace(), private_size,
+						             ds_size - private_size, window_offset); },
+					[&] () { _rm->upgrade_ram(8*1024); });
+
+				buffer.ds = rm.dataspace();
+			} catch (...) {
+				warning("failed to set up shared session buffer");
+				_free_buffer(buffer);
+				buffer = Session_buffer();
+			}
+			return buffer;
+		}
+
+		Session_buffer _alloc_buffer(size_t size)
+		{
+			if (_driver.zero_copy()) {
+				Session_buffer buffer = _alloc_shared_buffer(size);
+				if (buffer.ds.valid())
+					return buffer;
+			}
+
+			Session_buffer buffer;
+			buffer.ram = _env.ram().alloc(size);
+			buffer.ds  = buffer.ram;
+			return buffer;
+		}
+
 	protected:
 
 		void _destroy_session(Session_component *session) override
 		{
-			Ram_dataspace_capability rq_ds = session->rq_ds();
+			Session_buffer const buffer = session->buffer();
 			Genode::Root_component<Session_component>::_destroy_session(session);
-			_env.ram().free(rq_ds);
+			_free_buffer(buffer);
 		}
 
 		/**
@@ -313,10 +469,9 @@ class Block::Root :
 			if (writeable)
 				writeable = Arg_string::find_arg(args, "writeable").bool_value(true);
 
-			Ram_dataspace_capability ds_cap;
-			ds_cap = _env.ram().alloc(tx_buf_size);
+			Session_buffer const buffer = _alloc_buffer(tx_buf_size);
 			Session_component *session = new (md_alloc())
-				Session_component(ds_cap, _table.partition(num),
+				Session_component(buffer, _table.partition(num),
 				                  _env.ep(), _env.rm(), _driver,
 				                  writeable);
 
@@ -329,7 +484,11 @@ class Block::Root :
 		Root(Genode::Env &env, Genode::Xml_node config, Genode::Heap &heap,
 		     Block::Driver &driver, Block::Partition_table &table)
 		: Root_component(env.ep(), heap), _env(env), _config(config),
-		  _driver(driver), _table(table) { }
+		  _driver(driver), _table(table)
+		{
+			if (_driver.zero_copy())
+				_rm.construct(_env);
+		}
 };
 
 #endif /* _PART_BLK__COMPONENT_H_ */
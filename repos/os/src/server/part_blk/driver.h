@@ -47,38 +47,144 @@ class Block::Driver
 {
 	public:
 
+	/**
+	 * Part of the backend's bulk buffer shared with a client session
+	 *
+	 * Client packets located within the window are forwarded to the backend
+	 * by translating their offset, without copying their content.
+	 */
+	class Window
+	{
+		private:
+
+			friend class Driver;
+
+			Genode::addr_t const _alloc_base; /* allocation in backend buffer */
+			Genode::off_t  const _base;       /* backend minus client offset  */
+			Genode::size_t const _first;      /* first shared client offset   */
+			Genode::size_t const _end;        /* end of client bulk buffer    */
+
+			unsigned _pending  = 0; /* translated packets in flight */
+			bool     _released = false;
+
+		public:
+
+			Window(Genode::addr_t alloc_base, Genode::off_t base,
+			       Genode::size_t first, Genode::size_t end)
+			: _alloc_base(alloc_base), _base(base), _first(first), _end(end) { }
+
+			/**
+			 * Return true if the client packet can be forwarded without copy
+			 */
+			bool contains(Packet_descriptor const &p) const
+			{
+				return p.size() && (Genode::size_t)p.offset() >= _first
+				    && (Genode::size_t)p.offset() + p.size() <= _end;
+			}
+
+			/**
+			 * Return backend bulk-buffer offset of a client offset
+			 */
+			Genode::off_t backend_offset(Genode::off_t client_offset) const {
+				return client_offset + _base; }
+	};
+
 	class Request : public Genode::List<Request>::Element
 	{
 		private:
 
-			Block_dispatcher &_dispatcher;
+			Block_dispatcher *_dispatcher;
 			Packet_descriptor _cli;
 			Packet_descriptor _srv;
+			Window           *_window;
 
 		public:
 
 			Request(Block_dispatcher &d,
 			        Packet_descriptor &cli,
-			        Packet_descriptor &srv)
-			: _dispatcher(d), _cli(cli), _srv(srv) {}
+			        Packet_descriptor &srv,
+			        Window            *window)
+			: _dispatcher(&d), _cli(cli), _srv(srv), _window(window) {}
 
-			bool handle(Packet_descriptor& reply)
+			bool matches(Packet_descriptor const &reply) const
 			{
-				bool ret =  reply == _srv;
-				if (ret) _dispatcher.dispatch(_cli, reply);
-				return ret;
+				return reply == _srv && reply.offset() == _srv.offset()
+				                     && reply.size()   == _srv.size();
 			}
 
-			bool same_dispatcher(Block_dispatcher &same) {
-				return &same == &_dispatcher; }
+			void dispatch(Packet_descriptor &reply)
+			{
+				if (_dispatcher) _dispatcher->dispatch(_cli, reply);
+			}
+
+			/**
+			 * Detach request from the dispatcher of a closed session
+			 *
+			 * The request stays pending until the backend acknowledged it.
+			 */
+			void orphan() { _dispatcher = nullptr; }
+
+			bool same_dispatcher(Block_dispatcher &same) const {
+				return &same == _dispatcher; }
+
+			Packet_descriptor const &srv()    const { return _srv;    }
+			Window                  *window() const { return _window; }
 	};
 
 	private:
 
+		/**
+		 * Outstanding requests, indexed by the offset of the backend packet
+		 */
+		class Request_index
+		{
+			private:
+
+				enum { BUCKETS_LOG2 = 6, BUCKETS = 1 << BUCKETS_LOG2 };
+
+				Genode::List<Request> _buckets[BUCKETS];
+
+				static unsigned _hash(Packet_descriptor const &p)
+				{
+					Genode::uint32_t const key = (Genode::uint32_t)
+						(p.offset() >> Packet_descriptor::PACKET_ALIGNMENT);
+					return (key * 2654435761U) >> (32 - BUCKETS_LOG2);
+				}
+
+			public:
+
+				void insert(Request *r) { _buckets[_hash(r->srv())].insert(r); }
+				void remove(Request *r) { _buckets[_hash(r->srv())].remove(r); }
+
+				/**
+				 * Look up request of an acknowledged packet
+				 *
+				 * Only data-less requests may share an offset. As they are
+				 * acknowledged in order, the oldest match is returned, which
+				 * is the last one in the bucket.
+				 */
+				Request *lookup(Packet_descriptor const &reply)
+				{
+					Request *match = nullptr;
+					for (Request *r = _buckets[_hash(reply)].first(); r; r = r->next())
+						if (r->matches(reply)) match = r;
+					return match;
+				}
+
+				template <typename FN>
+				void for_each(FN const &fn)
+				{
+					for (unsigned i = 0; i < BUCKETS; i++)
+						for (Request *r = _buckets[i].first(); r; r = r->next())
+							fn(*r);
+				}
+		};
+
 		enum { BLK_SZ = Session::TX_QUEUE_SIZE*sizeof(Request) };
 
+		Genode::Heap                  &_heap;
 		Genode::Tslab<Request, BLK_SZ> _r_slab;
-		Genode::List<Request>          _r_list { };
+		Request_index                  _r_index { };
 		Genode::Allocator_avl          _block_alloc;
 		Block::Connection              _session;
 		Block::sector_t                _blk_cnt  = 0;
@@ -86,22 +192,39 @@ class Block::Driver
 		Genode::Signal_handler<Driver> _source_ack;
 		Genode::Signal_handler<Driver> _source_submit;
 		Block::Session::Operations     _ops { };
+		bool const                     _zero_copy;
 
 		void _ready_to_submit();
 
+		void _free_window(Window &w)
+		{
+			_block_alloc.free((void *)w._alloc_base);
+			Genode::destroy(&_heap, &w);
+		}
+
 		void _ack_avail()
 		{
 			/* check for acknowledgements */
 			while (_session.tx()->ack_avail()) {
 				Packet_descriptor p = _session.tx()->get_acked_packet();
-				for (Request *r = _r_list.first(); r; r = r->next()) {
-					if (r->handle(p)) {
-						_r_list.remove(r);
-						Genode::destroy(&_r_slab, r);
-						break;
-					}
+				Request *r = _r_index.lookup(p);
+				Window  *w = r ? r->window() : nullptr;
+
+				if (r) {
+					r->dispatch(p);
+					_r_index.remove(r);
+					Genode::destroy(&_r_slab, r);
 				}
-				_session.tx()->release_packet(p);
+
+				/* translated packets are part of a window */
+				if (!w) {
+					_session.tx()->release_packet(p);
+					continue;
+				}
+
+				w->_pending--;
+				if (w->_released && !w->_pending)
+					_free_window(*w);
 			}
 
 			_ready_to_submit();
@@ -109,12 +232,20 @@ class Block::Driver
 
 	public:
 
-		Driver(Genode::Env &env, Genode::Heap &heap)
-		: _r_slab(&heap),
+		static Genode::size_t buffer_size(Genode::Xml_node config)
+		{
+			Genode::Number_of_bytes size = 4 * 1024 * 1024;
+			return config.attribute_value("buffer_size", size);
+		}
+
+		Driver(Genode::Env &env, Genode::Heap &heap, Genode::Xml_node config)
+		: _heap(heap),
+		  _r_slab(&heap),
 		  _block_alloc(&heap),
-		  _session(env, &_block_alloc, 4 * 1024 * 1024),
+		  _session(env, &_block_alloc, buffer_size(config)),
 		  _source_ack(env.ep(), *this, &Driver::_ack_avail),
-		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit)
+		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit),
+		  _zero_copy(config.attribute_value("zero_copy", false))
 		{
 			_session.info(&_blk_cnt, &_blk_size, &_ops);
 		}
@@ -123,6 +254,52 @@ class Block::Driver
 		Genode::size_t blk_cnt()  { return _blk_cnt;  }
 		Session::Operations ops() { return _ops; }
 		Session_client& session() { return _session;  }
+		bool zero_copy() const    { return _zero_copy; }
+
+		/**
+		 * Return communication buffer of the backend session
+		 */
+		Genode::Dataspace_capability dataspace() {
+			return _session.tx()->dataspace(); }
+
+		/**
+		 * Allocate window of the backend's bulk buffer
+		 *
+		 * \param first  first client offset to be shared, page-aligned
+		 * \param end    end of the client's communication buffer
+		 *
+		 * \return window, or nullptr if the backend buffer is exhausted
+		 *
+		 * Packet offsets of both sessions are relative to the start of the
+		 * respective communication dataspace. The shared part of the
+		 * client's dataspace and the window are mapped page-wise. Hence,
+		 * the window starts at a page-aligned backend offset.
+		 */
+		Window *alloc_window(Genode::size_t first, Genode::size_t end)
+		{
+			using namespace Genode;
+
+			enum { PAGE_SIZE_LOG2 = 12 };
+
+			void *alloc_base = nullptr;
+
+			if (_block_alloc.alloc_aligned(end - first, &alloc_base,
+			                               PAGE_SIZE_LOG2).error())
+				return nullptr;
+
+			return new (&_heap) Window((addr_t)alloc_base,
+			                           (addr_t)alloc_base - first, first, end);
+		}
+
+		/**
+		 * Release window, freed as soon as no packet of it is in flight
+		 */
+		void release_window(Window &w)
+		{
+			w._released = true;
+			if (!w._pending)
+				_free_window(w);
+		}
 
 		void work_asynchronously()
 		{
@@ -132,20 +309,35 @@ class Block::Driver
 
 		static Driver& driver();
 
-		void io(bool write, sector_t nr, Genode::size_t cnt, void* addr,
-		        Block_dispatcher &dispatcher, Packet_descriptor& cli)
+		void io(Packet_descriptor::Opcode op, sector_t nr, Genode::size_t cnt,
+		        void* addr, Block_dispatcher &dispatcher, Packet_descriptor& cli,
+		        Window *window = nullptr)
 		{
 			if (!_session.tx()->ready_to_submit())
 				throw Block::Session::Tx::Source::Packet_alloc_failed();
 
-			Block::Packet_descriptor::Opcode op = write
-			    ? Block::Packet_descriptor::WRITE
-			    : Block::Packet_descriptor::READ;
-			Genode::size_t size = _blk_size * cnt;
+			bool const write = (op == Block::Packet_descriptor::WRITE);
+			bool const data  = write || op == Block::Packet_descriptor::READ;
+
+			/* forward the client's buffer by translating its offset */
+			if (data && window && window->contains(cli)) {
+				Packet_descriptor p(Packet_descriptor(
+				                    window->backend_offset(cli.offset()),
+				                    cli.size()), op, nr, cnt);
+				Request *r = new (&_r_slab) Request(dispatcher, cli, p, window);
+				_r_index.insert(r);
+				window->_pending++;
+
+				_session.tx()->submit_packet(p);
+				return;
+			}
+
+			/* 'SYNC' and 'TRIM' requests carry no data */
+			Genode::size_t size = data ? _blk_size * cnt : 0;
 			Packet_descriptor p(_session.dma_alloc_packet(size),
 			                    op,  nr, cnt);
-			Request *r = new (&_r_slab) Request(dispatcher, cli, p);
-			_r_list.insert(r);
+			Request *r = new (&_r_slab) Request(dispatcher, cli, p, nullptr);
+			_r_index.insert(r);
 
 			if (write)
 				Genode::memcpy(_session.tx()->packet_content(p),
@@ -156,18 +348,9 @@ class Block::Driver
 
 		void remove_dispatcher(Block_dispatcher &dispatcher)
 		{
-			for (Request *r = _r_list.first(); r;) {
-				if (!r->same_dispatcher(dispatcher)) {
-					r = r->next();
-					continue;
-				}
-
-				Request *remove = r;
-				r = r->next();
-
-				_r_list.remove(remove);
-				Genode::destroy(&_r_slab, remove);
-			}
+			_r_index.for_each([&] (Request &r) {
+				if (r.same_dispatcher(dispatcher))
+					r.orphan(); });
 		}
 };
 
@@ -37,7 +37,7 @@ class Main
 		Genode::Attached_rom_dataspace _config { _env, "config" };
 
 		Genode::Heap        _heap     { _env.ram(), _env.rm() };
-		Block::Driver       _driver   { _env, _heap      };
+		Block::Driver       _driver   { _env, _heap, _config.xml() };
 		Genode::Reporter    _reporter { _env, "partitions" };
 		Mbr_partition_table _mbr      { _heap, _driver, _reporter };
 		Gpt                 _gpt      { _heap, _driver, _reporter };
@@ -13,11 +13,14 @@
 
 #include <root/component.h>
 #include <base/component.h>
+#include <base/attached_ram_dataspace.h>
 #include <base/heap.h>
 #include <util/string.h>
+#include <util/reconstructible.h>
 
 #include <terminal_session/connection.h>
 #include <log_session/log_session.h>
+#include <log_session/log_ring.h>
 
 
 namespace Genode {
@@ -33,13 +36,124 @@ namespace Genode {
 			char                  _label[LABEL_LEN];
 			Terminal::Connection &_terminal;
 
+			Env &_env;
+
+			/*
+			 * The ring is allocated not before the client donated the
+			 * capabilities it consumes
+			 */
+			size_t _ring_caps = 0;
+
+			Constructible<Attached_ram_dataspace> _ring_ds { };
+
+			Constructible<Signal_handler<Termlog_component> > _ring_handler { };
+
+			/*
+			 * Output is collected in the buffer and written to the terminal
+			 * in large chunks
+			 */
+			enum { BUF_SIZE = 1024 };
+
+			char   _buf[BUF_SIZE];
+			size_t _buf_len = 0;
+
+			/* true if the next character of the ring starts a new line */
+			bool _line_start = true;
+
+			void _flush()
+			{
+				if (_buf_len)
+					_terminal.write(_buf, _buf_len);
+
+				_buf_len = 0;
+			}
+
+			void _append(char const *s, size_t len)
+			{
+				while (len) {
+					size_t const n = min(len, BUF_SIZE - _buf_len);
+
+					memcpy(_buf + _buf_len, s, n);
+					_buf_len += n;
+					s   += n;
+					len -= n;
+
+					if (_buf_len == BUF_SIZE)
+						_flush();
+				}
+			}
+
+			/**
+			 * Append output consumed from the ring
+			 *
+			 * Each line is prefixed by the label and followed by a
+			 * carriage-return as done by 'write'.
+			 */
+			void _output(char const *s, size_t len)
+			{
+				enum { ESC = 27 };
+
+				while (len) {
+
+					size_t n = 0;
+					while (n < len && s[n++] != '\n');
+
+					bool const line_end = (s[n - 1] == '\n');
+
+					if (_line_start && line_end && n == 5 && s[0] == ESC) {
+
+						/* escape-sequence heuristic of 'write' */
+						_append(s, n - 1);
+
+					} else {
+
+						if (_line_start)
+							_append(_label, strlen(_label));
+
+						_append(s, n);
+
+						if (line_end)
+							_append("\r", 1);
+					}
+
+					_line_start = line_end;
+
+					s   += n;
+					len -= n;
+				}
+			}
+
+			void _consume_ring()
+			{
+				if (!_ring_ds.constructed())
+					return;
+
+				_ring_ds->local_addr<Log_ring>()->consume(
+					[&] (char const *s, size_t len) { _output(s, len); });
+			}
+
+			void _handle_ring()
+			{
+				_consume_ring();
+				_flush();
+			}
+
 		public:
 
 			/**
 			 * Constructor
 			 */
-			Termlog_component(const char *label, Terminal::Connection &terminal)
-			: _terminal(terminal) { snprintf(_label, LABEL_LEN, "[%s] ", label); }
+			Termlog_component(Env &env, const char *label,
+			                  Terminal::Connection &terminal)
+			:
+				_terminal(terminal), _env(env)
+			{
+				snprintf(_label, LABEL_LEN, "[%s] ", label);
+			}
+
+			~Termlog_component() { _handle_ring(); }
+
+			void upgrade(Cap_quota caps) { _ring_caps += caps.value; }
 
 
 			/*****************
@@ -59,6 +173,9 @@ namespace Genode {
 					return 0;
 				}
 
+				/* preserve the order with respect to the output in the ring */
+				_consume_ring();
+
 				char const *string = string_buf.string();
 				int len = strlen(string);
 
@@ -72,22 +189,54 @@ namespace Genode {
 				 */
 				enum { ESC = 27 };
 				if ((string[0] == ESC) && (len == 5) && (string[4] == '\n')) {
-					_terminal.write(string, len - 1);
+					_append(string, len - 1);
+					_flush();
 					return len;
 				}
 
-				_terminal.write(_label, strlen(_label));
-				_terminal.write(string, len);
+				_append(_label, strlen(_label));
+				_append(string, len);
 
 				/* if last character of string was not a line break, add one */
 				if ((len > 0) && (string[len - 1] != '\n'))
-					_terminal.write("\n", 1);
+					_append("\n", 1);
 
 				/* carriage-return as expected by hardware terminals on newline */
-				_terminal.write("\r", 1);
+				_append("\r", 1);
 
+				_flush();
+				_line_start = true;
 				return len;
 			}
+
+			Dataspace_capability ring_dataspace() override
+			{
+				if (_ring_ds.constructed())
+					return _ring_ds->cap();
+
+				if (_ring_caps < Log_session::RING_CAP_QUOTA)
+					return Dataspace_capability();
+
+				try {
+					_ring_ds.construct(_env.ram(), _env.rm(), sizeof(Log_ring));
+					_ring_handler.construct(_env.ep(), *this,
+					                        &Termlog_component::_handle_ring);
+				}
+				catch (...) {
+					_ring_ds.destruct();
+					return Dataspace_capability();
+				}
+
+				return _ring_ds->cap();
+			}
+
+			Signal_context_capability ring_sigh() override
+			{
+				if (!_ring_handler.constructed())
+					return Signal_context_capability();
+
+				return *_ring_handler;
+			}
 	};
 
 
@@ -95,6 +244,7 @@ namespace Genode {
 	{
 		private:
 
+			Env                 &_env;
 			Terminal::Connection _terminal;
 
 		protected:
@@ -108,7 +258,8 @@ namespace Genode {
 					Arg_string::find_arg(args, "ram_quota"  ).ulong_value(0);
 
 				/* delete ram quota by the memory needed for the session */
-				size_t session_size = max((size_t)4096, sizeof(Termlog_component));
+				size_t session_size = max((size_t)4096, sizeof(Termlog_component)
+				                                        + sizeof(Log_ring));
 				if (ram_quota < session_size)
 					throw Insufficient_ram_quota();
 
@@ -117,7 +268,12 @@ namespace Genode {
 				Arg label_arg = Arg_string::find_arg(args, "label");
 				label_arg.string(label_buf, sizeof(label_buf), "");
 
-				return new (md_alloc()) Termlog_component(label_buf, _terminal);
+				return new (md_alloc()) Termlog_component(_env, label_buf, _terminal);
+			}
+
+			void _upgrade_session(Termlog_component *s, const char *args) override
+			{
+				s->upgrade(cap_quota_from_args(args));
 			}
 
 		public:
@@ -130,7 +286,7 @@ namespace Genode {
 			 */
 			Termlog_root(Genode::Env &env, Allocator &md_alloc)
 			: Root_component<Termlog_component>(env.ep(), md_alloc),
-			  _terminal(env, "log") { }
+			  _env(env), _terminal(env, "log") { }
 	};
 }
 
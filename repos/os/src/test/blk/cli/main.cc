@@ -376,6 +376,124 @@ struct Violation_test : Test
 };
 
 
+/**
+ * Check the ordering of SYNC and TRIM requests
+ *
+ * The content of the written blocks is read beforehand and written back
+ * unmodified. TRIM requests destroy the content of the test blocks and are
+ * only issued if enabled via the 'test_trim' config attribute.
+ */
+struct Barrier_test : Test
+{
+	typedef Block::Packet_descriptor Packet;
+
+	enum { WRITES = 4 };
+
+	struct Order_violated : Exception {
+		void print_error() {
+			Genode::error("request completed out of order!"); } };
+
+	bool     const _trim;
+	Packet         _content   { };
+	unsigned       _writes    = 0;
+	bool           _barrier   = false;
+	bool           _done      = false;
+
+	static bool _trim_enabled(Genode::Env &env)
+	{
+		try {
+			Genode::Attached_rom_dataspace config { env, "config" };
+			return config.xml().attribute_value("test_trim", false);
+		} catch (...) { return false; }
+	}
+
+	Barrier_test(Genode::Env &env, Genode::Heap &heap, unsigned timeo)
+	: Test(env, heap, 2*WRITES*blk_sz, timeo), _trim(_trim_enabled(env)) { }
+
+	void _submit(Packet::Opcode op, Block::sector_t nr, Genode::size_t cnt,
+	             Genode::size_t size)
+	{
+		Packet p(size ? _session.dma_alloc_packet(size)
+		              : _session.tx()->alloc_packet(0), op, nr, cnt);
+		_session.tx()->submit_packet(p);
+	}
+
+	void _run(Packet::Opcode op)
+	{
+		_writes = 0; _barrier = false; _done = false;
+
+		_submit(Packet::READ, 0, WRITES, WRITES*blk_sz);
+		while (!_content.size())
+			_handle_signal();
+
+		char const *src = _session.tx()->packet_content(_content);
+		for (unsigned i = 0; i < WRITES; i++) {
+			Packet w(_session.dma_alloc_packet(blk_sz), Packet::WRITE, i, 1);
+			Genode::memcpy(_session.tx()->packet_content(w),
+			               src + i*blk_sz, blk_sz);
+			_session.tx()->submit_packet(w);
+		}
+		_session.tx()->release_packet(_content);
+		_content = Packet();
+
+		/* a SYNC request with a block count of zero covers the whole device */
+		_submit(op, 0, op == Packet::SYNC ? 0 : WRITES, 0);
+		_submit(Packet::READ, 0, 1, blk_sz);
+
+		while (!_done)
+			_handle_signal();
+	}
+
+	void perform()
+	{
+		if (!blk_ops.supported(Packet::WRITE) ||
+		    !blk_ops.supported(Packet::SYNC))
+			return;
+
+		Genode::log("ordering of write, sync, and read requests");
+		_run(Packet::SYNC);
+
+		if (!_trim || !blk_ops.supported(Packet::TRIM))
+			return;
+
+		Genode::log("ordering of write, trim, and read requests");
+		_run(Packet::TRIM);
+	}
+
+	void ack_avail()
+	{
+		 _handle = false;
+
+		while (_session.tx()->ack_avail()) {
+			Packet p = _session.tx()->get_acked_packet();
+
+			if (!p.succeeded())
+				throw Block_exception(p.block_number(), p.block_count(),
+				                      p.operation() != Packet::READ);
+
+			switch (p.operation()) {
+			case Packet::READ:
+				if (p.block_count() == WRITES) {
+					_content = p;
+					continue;
+				}
+				if (!_barrier) throw Order_violated();
+				_done = true;
+				break;
+			case Packet::WRITE:
+				if (_barrier) throw Order_violated();
+				_writes++;
+				break;
+			default:
+				if (_writes != WRITES) throw Order_violated();
+				_barrier = true;
+			}
+			_session.tx()->release_packet(p);
+		}
+	}
+};
+
+
 template <typename TEST>
 void perform(Genode::Env &env, Genode::Heap &heap, unsigned timeo_ms = 0)
 {
@@ -426,6 +544,7 @@ void Component::construct(Genode::Env &env)
 		perform<Read_test<Block::Session::TX_QUEUE_SIZE, 1> >(env, heap);
 		perform<Write_test<Block::Session::TX_QUEUE_SIZE, 8, 16> >(env, heap);
 		perform<Violation_test>(env, heap, 1000);
+		perform<Barrier_test>(env, heap, 1000);
 
 		log("Tests finished successfully!");
 	}
@@ -12,8 +12,11 @@
  */
 
 #include <base/attached_rom_dataspace.h>
-#include <block/component.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <block/multi_component.h>
 #include <block/driver.h>
+#include <block/scheduler.h>
 #include <os/ring_buffer.h>
 #include <timer_session/connection.h>
 
@@ -71,6 +74,8 @@ class Driver : public Block::Driver
 			Block::Session::Operations ops;
 			ops.set_operation(Block::Packet_descriptor::READ);
 			ops.set_operation(Block::Packet_descriptor::WRITE);
+			ops.set_operation(Block::Packet_descriptor::SYNC);
+			ops.set_operation(Block::Packet_descriptor::TRIM);
 			return ops;
 		}
 
@@ -98,6 +103,25 @@ class Driver : public Block::Driver
 			               (void*)buffer, block_count * _size);
 			_packets.add(packet);
 		}
+
+		void sync(Block::sector_t, Genode::size_t,
+		          Block::Packet_descriptor &packet) override
+		{
+			if (!_packets.avail_capacity())
+				throw Block::Driver::Request_congestion();
+			_packets.add(packet);
+		}
+
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet) override
+		{
+			if (!_packets.avail_capacity())
+				throw Block::Driver::Request_congestion();
+			Genode::memset(&_blk_buf[block_number*_size], 0,
+			               block_count * _size);
+			_packets.add(packet);
+		}
 };
 
 
@@ -141,7 +165,36 @@ struct Main
 
 	} factory { env, heap };
 
-	Block::Root                    root { env.ep(), heap, env.rm(), factory, true };
+	Genode::Attached_rom_dataspace config { env, "config" };
+
+	/*
+	 * Policy for scheduling the requests of the clients, selected via the
+	 * 'scheduling' config attribute
+	 */
+	Block::Round_robin_policy                     round_robin    { };
+	Block::Weighted_policy                        weighted       { };
+	Genode::Constructible<Timer::Connection>      deadline_timer { };
+	Genode::Constructible<Block::Deadline_policy> deadline       { };
+
+	Block::Scheduling_policy &policy()
+	{
+		typedef Genode::String<16> Name;
+		Name const name = config.xml().attribute_value("scheduling",
+		                                               Name("round_robin"));
+		if (name == "weighted")
+			return weighted;
+
+		if (name == "deadline") {
+			deadline_timer.construct(env);
+			deadline.construct(*deadline_timer);
+			return *deadline;
+		}
+		return round_robin;
+	}
+
+	Block::Multi_root root { env.ep(), heap, env.rm(), factory, policy(),
+	                         config, true };
+
 	Timer::Connection              timer { env };
 	Genode::Signal_handler<Driver> dispatcher { env.ep(), *factory.driver,
 	                                            &Driver::handler };
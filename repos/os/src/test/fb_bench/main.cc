@@ -19,6 +19,13 @@
 #include <blit/blit.h>
 #include <framebuffer_session/connection.h>
 #include <timer_session/connection.h>
+#include <nitpicker_gfx/box_painter.h>
+#include <nitpicker_gfx/texture_painter.h>
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
+
+/* nitpicker includes */
+#include <compositor.h>
 
 using namespace Genode;
 
@@ -128,12 +135,175 @@ struct Unaligned_blit_test : Test
 	}
 };
 
+struct View_stack_test : Test
+{
+	static constexpr char const *brief = "composition of view stacks in the FB";
+
+	typedef Surface_base::Area  Area;
+	typedef Surface_base::Point Point;
+	typedef Surface_base::Rect  Rect;
+
+	/*
+	 * Stack of cascaded windows of half the screen size on top of a
+	 * background, the top-most window is moved with each frame
+	 */
+	struct Stack
+	{
+		char const *name;
+		unsigned    windows;
+		bool        alpha;
+	};
+
+	template <typename PT>
+	void _measure(Stack const &stack)
+	{
+		Area const screen(fb_mode.width(), fb_mode.height());
+		Area const window(screen.w() / 2, screen.h() / 2);
+
+		Surface<PT> surface(fb_ds.local_addr<PT>(), screen);
+		Texture<PT> texture((PT *)buf[0],
+		                    stack.alpha ? (unsigned char *)buf[1] : nullptr,
+		                    window);
+
+		unsigned       frames   = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+		for (; timer.elapsed_ms() - start_ms < DURATION_MS; frames++) {
+
+			Box_painter::paint(surface, Rect(Point(0, 0), screen),
+			                   Color(32, 64, 96));
+
+			for (unsigned i = 0; i < stack.windows; i++) {
+				int const step = (i + 1 == stack.windows) ? frames % 64 : 0;
+				Point const pos(i*window.w() / stack.windows + step,
+				                i*window.h() / stack.windows);
+
+				Texture_painter::paint(surface, texture, Color(), pos,
+				                       Texture_painter::SOLID, true);
+			}
+			fb.refresh(0, 0, screen.w(), screen.h());
+		}
+		log(stack.name, ": ",
+		    (frames*1000) / (timer.elapsed_ms() - start_ms), " frames/sec");
+	}
+
+	View_stack_test(Env &env, int id) : Test(env, id, brief)
+	{
+		/* window content, translucent windows use 'buf[1]' as alpha channel */
+		memset(buf[0], 0x55, fb_ds.size());
+		memset(buf[1], 0x80, fb_ds.size());
+
+		Stack const stacks[] = {
+			{ "background only",          0, false },
+			{ "one window",               1, false },
+			{ "four windows",             4, false },
+			{ "four translucent windows", 4, true } };
+
+		for (Stack const &stack : stacks) {
+			if (fb_mode.format() == Framebuffer::Mode::RGB888)
+				_measure<Pixel_rgb888>(stack);
+			else
+				_measure<Pixel_rgb565>(stack);
+		}
+	}
+};
+
+struct Compositor_test : Test
+{
+	static constexpr char const *brief = "composition via nitpicker's compositor threads";
+
+	typedef Nitpicker::Compositor Compositor;
+	typedef Surface_base::Area    Area;
+	typedef Surface_base::Point   Point;
+	typedef Surface_base::Rect    Rect;
+
+	enum { WINDOWS = 4 };
+
+	/*
+	 * Same scene as the "four translucent windows" stack of the view-stack
+	 * test, painted tile by tile on the canvas of each compositor thread
+	 */
+	struct Painter : Compositor::Painter
+	{
+		Texture_base         const &texture;
+		Surface_base::Pixel_format  format;
+		Area                        screen;
+		unsigned                    frame = 0;
+
+		Painter(Texture_base const &texture, Surface_base::Pixel_format format,
+		        Area screen)
+		: texture(texture), format(format), screen(screen) { }
+
+		void paint(Nitpicker::Canvas_base &canvas, Rect rect) const override
+		{
+			canvas.clip(rect);
+			canvas.draw_box(rect, Color(32, 64, 96));
+
+			Area const window = texture.size();
+			for (unsigned i = 0; i < WINDOWS; i++) {
+				int const step = (i + 1 == WINDOWS) ? frame % 64 : 0;
+				Point const pos(i*window.w() / WINDOWS + step,
+				                i*window.h() / WINDOWS);
+
+				canvas.draw_texture(pos, texture, format,
+				                    Texture_painter::SOLID, Color(), true);
+			}
+		}
+	};
+
+	template <typename PT>
+	void _measure(unsigned threads)
+	{
+		Area const screen(fb_mode.width(), fb_mode.height());
+		Area const window(screen.w() / 2, screen.h() / 2);
+
+		Texture<PT> texture((PT *)buf[0], (unsigned char *)buf[1], window);
+
+		Compositor compositor(env, threads);
+
+		Constructible<Nitpicker::Canvas<PT> > canvas[Compositor::MAX_THREADS];
+		Nitpicker::Canvas_base *canvases[Compositor::MAX_THREADS] { };
+		for (unsigned i = 0; i < compositor.threads(); i++) {
+			canvas[i].construct(fb_ds.local_addr<PT>(), screen);
+			canvases[i] = &*canvas[i];
+		}
+
+		Painter painter(texture, PT::format(), screen);
+		Rect const rect(Point(0, 0), screen);
+
+		unsigned const start_ms = timer.elapsed_ms();
+		for (; timer.elapsed_ms() - start_ms < DURATION_MS; painter.frame++) {
+			compositor.compose(painter, canvases, &rect, 1);
+			fb.refresh(0, 0, screen.w(), screen.h());
+		}
+		log(compositor.threads(), " thread(s): ",
+		    (painter.frame*1000) / (timer.elapsed_ms() - start_ms),
+		    " frames/sec");
+	}
+
+	Compositor_test(Env &env, int id) : Test(env, id, brief)
+	{
+		memset(buf[0], 0x55, fb_ds.size());
+		memset(buf[1], 0x80, fb_ds.size());
+
+		unsigned const threads[] = { 1, 2, 4 };
+
+		for (unsigned n : threads) {
+			if (fb_mode.format() == Framebuffer::Mode::RGB888)
+				_measure<Pixel_rgb888>(n);
+			else
+				_measure<Pixel_rgb565>(n);
+		}
+	}
+};
+
 struct Main
 {
 	Constructible<Bytewise_ram_test>   test_1 { };
 	Constructible<Bytewise_fb_test>    test_2 { };
 	Constructible<Blit_test>           test_3 { };
 	Constructible<Unaligned_blit_test> test_4 { };
+	Constructible<View_stack_test>     test_5 { };
+	Constructible<Compositor_test>     test_6 { };
 
 	Main(Env &env)
 	{
@@ -142,6 +312,8 @@ struct Main
 		test_2.construct(env, 2); test_2.destruct();
 		test_3.construct(env, 3); test_3.destruct();
 		test_4.construct(env, 4); test_4.destruct();
+		test_5.construct(env, 5); test_5.destruct();
+		test_6.construct(env, 6); test_6.destruct();
 		log("--- Framebuffer benchmark finished ---");
 	}
 };
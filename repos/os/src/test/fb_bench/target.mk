@@ -1,3 +1,4 @@
-TARGET = test-fb_bench
-SRC_CC = main.cc
-LIBS   = base blit
+TARGET   = test-fb_bench
+SRC_CC   = main.cc
+INC_DIR += $(REP_DIR)/src/server/nitpicker
+LIBS     = base blit
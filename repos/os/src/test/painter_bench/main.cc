@@ -0,0 +1,190 @@
+/*
+ * \brief  Micro-benchmark of the nitpicker_gfx painters
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The benchmark paints typical window sizes into a RAM buffer using the
+ * operations of 'Box_painter' and 'Texture_painter' for both pixel formats
+ * supported by nitpicker. Before measuring, it checks that the vectorized
+ * span operations yield the same pixels as the generic ones.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/component.h>
+#include <base/log.h>
+#include <nitpicker_gfx/box_painter.h>
+#include <nitpicker_gfx/texture_painter.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	typedef Surface_base::Area  Area;
+	typedef Surface_base::Point Point;
+	typedef Surface_base::Rect  Rect;
+
+	enum { MAX_W = 1920, MAX_H = 1080, MAX_PIXELS = MAX_W*MAX_H,
+	       DURATION_MS = 200, MIN_PIXELS_PER_ROUND = 4*1024*1024 };
+
+	Env &_env;
+
+	Timer::Connection _timer { _env };
+
+	Attached_ram_dataspace _dst   { _env.ram(), _env.rm(), MAX_PIXELS*4 };
+	Attached_ram_dataspace _src   { _env.ram(), _env.rm(), MAX_PIXELS*4 };
+	Attached_ram_dataspace _alpha { _env.ram(), _env.rm(), MAX_PIXELS };
+
+	unsigned _seed = 1;
+
+	unsigned _random() { return _seed = _seed*1103515245 + 12345; }
+
+	void _randomize(char *buf, size_t len)
+	{
+		for (size_t i = 0; i < len; i++)
+			buf[i] = (char)(_random() >> 16);
+	}
+
+	/**
+	 * Compare vectorized and generic span operations
+	 */
+	template <typename PT>
+	bool _check()
+	{
+		enum { LEN = 64 };
+
+		for (unsigned round = 0; round < 1000; round++) {
+
+			PT v[LEN], g[LEN], s[LEN];
+			unsigned char a[LEN];
+
+			_randomize((char *)v, sizeof(v));
+			_randomize((char *)s, sizeof(s));
+			_randomize((char *)a, sizeof(a));
+			for (unsigned i = 0; i < LEN; i++) {
+				g[i] = v[i];
+				if (_random() & 0x100000) a[i] = 0;
+				if (_random() & 0x100000) s[i].pixel = 0;
+			}
+
+			unsigned const n     = _random() % LEN;
+			int      const alpha = (_random() >> 16) & 0xff;
+			PT             pixel;
+			pixel.pixel = s[0].pixel;
+
+			switch (round % 5) {
+			case 0: Pixel_span::fill(v, n, pixel);
+			        Pixel_span::fill<PT>(g, n, pixel); break;
+			case 1: Pixel_span::mix(v, n, pixel, alpha);
+			        Pixel_span::mix<PT>(g, n, pixel, alpha); break;
+			case 2: Pixel_span::mix_alpha(v, s, a, n);
+			        Pixel_span::mix_alpha<PT>(g, s, a, n); break;
+			case 3: Pixel_span::avr(v, s, n, pixel);
+			        Pixel_span::avr<PT>(g, s, n, pixel); break;
+			case 4: Pixel_span::copy_masked(v, s, n);
+			        Pixel_span::copy_masked<PT>(g, s, n); break;
+			}
+
+			for (unsigned i = 0; i < LEN; i++)
+				if (v[i].pixel != g[i].pixel) {
+					error("span operation ", round % 5, " differs at pixel ", i);
+					return false;
+				}
+		}
+		return true;
+	}
+
+	/**
+	 * Repeat painting operation and log the painted pixels per microsecond
+	 */
+	template <typename FN>
+	void _measure(char const *brief, Area area, FN const &fn)
+	{
+		unsigned long const pixels = area.count();
+		unsigned      const repeat = max(1UL, MIN_PIXELS_PER_ROUND / pixels);
+
+		unsigned long total = 0;
+		unsigned long const start_ms = _timer.elapsed_ms();
+		unsigned long       end_ms   = start_ms;
+		for (; end_ms - start_ms < DURATION_MS; end_ms = _timer.elapsed_ms()) {
+			for (unsigned i = 0; i < repeat; i++)
+				fn();
+			total += repeat*pixels;
+		}
+
+		log("  ", brief, " ", area, ": ",
+		    total / ((end_ms - start_ms)*1000), " MPixel/s");
+	}
+
+	template <typename PT>
+	void _bench(char const *format)
+	{
+		log(format, ":");
+
+		if (!_check<PT>()) {
+			_env.parent().exit(-1);
+			return;
+		}
+
+		Area const sizes[] = { Area(32, 32), Area(320, 240), Area(800, 600),
+		                       Area(MAX_W, MAX_H) };
+
+		for (Area const area : sizes) {
+
+			Surface<PT> surface(_dst.local_addr<PT>(), area);
+
+			Texture<PT> texture(_src.local_addr<PT>(), _alpha.local_addr<unsigned char>(), area);
+			Texture<PT> opaque (_src.local_addr<PT>(), nullptr, area);
+
+			Rect  const rect(Point(0, 0), area);
+			Point const pos(0, 0);
+
+			_measure("fill", area, [&] () {
+				Box_painter::paint(surface, rect, Color(32, 64, 96)); });
+
+			_measure("mix", area, [&] () {
+				Box_painter::paint(surface, rect, Color(32, 64, 96, 128)); });
+
+			_measure("blit", area, [&] () {
+				Texture_painter::paint(surface, opaque, Color(), pos,
+				                       Texture_painter::SOLID, false); });
+
+			_measure("alpha", area, [&] () {
+				Texture_painter::paint(surface, texture, Color(), pos,
+				                       Texture_painter::SOLID, true); });
+
+			_measure("mixed", area, [&] () {
+				Texture_painter::paint(surface, texture, Color(255, 0, 0), pos,
+				                       Texture_painter::MIXED, false); });
+
+			_measure("masked", area, [&] () {
+				Texture_painter::paint(surface, texture, Color(), pos,
+				                       Texture_painter::MASKED, false); });
+		}
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("--- painter benchmark ---");
+
+		_randomize(_src.local_addr<char>(), _src.size());
+		_randomize(_alpha.local_addr<char>(), _alpha.size());
+
+		_bench<Pixel_rgb565>("RGB565");
+		_bench<Pixel_rgb888>("RGB888");
+
+		log("--- painter benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,128 @@
+/*
+ * \brief  Benchmark of 'Xml_node' vs. 'Xml_index'
+ * \author agent
+ * \date   2026-10-19
+ *
+ * The benchmark generates a large document resembling the state report of
+ * init and accesses the attributes of all sub nodes by index, which is the
+ * access pattern of many users of 'Xml_node'.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <util/xml_generator.h>
+#include <util/xml_index.h>
+#include <base/attached_ram_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum { NUM_CHILDREN = 2000, DOC_SIZE = 1024*1024 };
+
+	Env &_env;
+
+	Timer::Connection _timer { _env };
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Attached_ram_dataspace _doc { _env.ram(), _env.rm(), DOC_SIZE };
+
+	size_t _doc_len = 0;
+
+	void _generate()
+	{
+		Xml_generator xml(_doc.local_addr<char>(), DOC_SIZE, "state", [&] () {
+			for (unsigned i = 0; i < NUM_CHILDREN; i++) {
+				xml.node("child", [&] () {
+					xml.attribute("name",   String<32>("child-", i));
+					xml.attribute("binary", "init");
+					xml.attribute("id",     i);
+					xml.node("ram", [&] () {
+						xml.attribute("assigned", "4M");
+						xml.attribute("quota",    "4M");
+						xml.attribute("used",     "1M");
+					});
+					xml.node("caps", [&] () {
+						xml.attribute("assigned", 100);
+						xml.attribute("used",     20);
+					});
+				});
+			}
+		});
+		_doc_len = xml.used();
+	}
+
+	template <typename FN>
+	unsigned long _measure(char const *name, FN const &fn)
+	{
+		unsigned long const start_ms = _timer.elapsed_ms();
+		unsigned long const sum      = fn();
+		unsigned long const duration = _timer.elapsed_ms() - start_ms;
+
+		log(name, ": ", duration, " ms");
+		return sum;
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		_generate();
+
+		char const * const doc = _doc.local_addr<char>();
+
+		log("document size: ", _doc_len/1024, " KiB, ", (unsigned)NUM_CHILDREN, " nodes");
+
+		unsigned long const sum_xml_node = _measure("Xml_node by index", [&] () {
+			Xml_node const node(doc, _doc_len);
+			unsigned long sum = 0;
+			for (unsigned i = 0; i < node.num_sub_nodes(); i++)
+				sum += node.sub_node(i).attribute_value("id", 0UL);
+			return sum;
+		});
+
+		unsigned long const sum_for_each = _measure("Xml_node for_each_sub_node", [&] () {
+			unsigned long sum = 0;
+			Xml_node(doc, _doc_len).for_each_sub_node([&] (Xml_node const &node) {
+				sum += node.attribute_value("id", 0UL); });
+			return sum;
+		});
+
+		Constructible<Xml_index> index { };
+
+		_measure("Xml_index construction", [&] () {
+			index.construct(_heap, doc, _doc_len);
+			return 0UL;
+		});
+
+		log("index size: ", index->size()/1024, " KiB");
+
+		unsigned long const sum_index = _measure("Xml_index by index", [&] () {
+			Indexed_xml_node const node = index->node();
+			unsigned long sum = 0;
+			for (unsigned i = 0; i < node.num_sub_nodes(); i++)
+				sum += node.sub_node(i).attribute_value("id", 0UL);
+			return sum;
+		});
+
+		if (sum_xml_node != sum_for_each || sum_xml_node != sum_index) {
+			error("results differ");
+			return;
+		}
+
+		log("--- finished XML-node benchmark ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }